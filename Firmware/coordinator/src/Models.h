@@ -12,6 +12,7 @@ struct TowerInfo {
     float temperature;      // Current temperature in Celsius
     bool isDerated;         // Whether the tower is currently derated
     uint8_t derationLevel; // Current deration level (100 = no deration)
+    uint8_t memberIndex = 0xFF; // bit in group command bitmaps (0xFF = none)
 };
 
 struct ZoneMapping {
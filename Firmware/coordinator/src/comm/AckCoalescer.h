@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include "PeerTable.h"
+
+// Deferred, cumulative acknowledgements for tower status and telemetry.
+//
+// Towers only use the coordinator's ACK as a sign of life, so answering every
+// frame doubles the traffic for nothing. note() records the newest sequence
+// number received from a peer; flush() sends one ACK per peer once WINDOW_MS
+// has passed since the first frame it covers. Any other frame queued to the
+// peer (a command, a sync) is just as good a sign of life, so piggyback()
+// cancels the ACK it would have owed.
+class AckCoalescer {
+public:
+    static constexpr size_t SLOTS = macTableSlots(MAX_FLEET_TOWERS);
+    static constexpr uint32_t WINDOW_MS = 5000;  // towers give up on the coordinator after minutes
+
+    struct Counters {
+        uint32_t noted;        // frames that asked for an ack
+        uint32_t sent;         // acks actually sent
+        uint32_t piggybacked;  // owed acks another frame made unnecessary
+    };
+
+    AckCoalescer() { memset(&totals, 0, sizeof(totals)); }
+
+    // Owe 'peer' an ack for its frame 'seq'. False when the table is full and
+    // the caller should ack right away.
+    bool note(MacKey peer, uint16_t seq, uint32_t now) {
+        totals.noted++;
+        Pending* p = table.find(peer);
+        if (!p) {
+            p = table.insert(peer);
+            if (!p) return false;
+            p->firstMs = now;
+        }
+        p->seq = seq;
+        if (p->count < 0xFF) p->count++;
+        return true;
+    }
+
+    // A frame other than an ack is on its way to 'peer'
+    void piggyback(MacKey peer) {
+        if (table.erase(peer)) totals.piggybacked++;
+    }
+
+    // send(peer, seq, count) for every ack whose window has closed
+    template <typename Send>
+    void flush(uint32_t now, Send send) {
+        if (table.size() == 0) return;
+        // Collect first: sending queues a frame, and queuing calls piggyback()
+        Due due[decltype(table)::MAX_ENTRIES];
+        size_t n = 0;
+        table.forEach([&](MacKey peer, const Pending& p) {
+            if (now - p.firstMs >= WINDOW_MS) due[n++] = Due{peer, p.seq, p.count};
+        });
+        for (size_t i = 0; i < n; i++) {
+            table.erase(due[i].peer);
+            send(due[i].peer, due[i].seq, due[i].count);
+            totals.sent++;
+        }
+    }
+
+    size_t pending() const { return table.size(); }
+    const Counters& counters() const { return totals; }
+
+private:
+    struct Pending {
+        uint32_t firstMs;  // first frame the ack will cover
+        uint16_t seq;      // newest frame seen
+        uint8_t count;     // frames covered, saturating
+    };
+    struct Due {
+        MacKey peer;
+        uint16_t seq;
+        uint8_t count;
+    };
+    MacTable<Pending, SLOTS> table;
+    Counters totals;
+};
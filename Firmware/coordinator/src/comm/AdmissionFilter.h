@@ -0,0 +1,134 @@
+#pragma once
+
+#include <Arduino.h>
+#include "PeerTable.h"
+
+// First check on every received frame, before stats, parsing or logging.
+//
+// Known peers (the persisted peer list) are found in a MacTable in constant
+// time and always pass. An unknown sender only passes with a pairing-type
+// frame while permit-join is open, and then at most BUCKET_SIZE frames at
+// once, refilled one per REFILL_MS, per sender; GLOBAL_* caps all unknown
+// senders together so a storm of random MACs cannot get through either.
+// Everything else is dropped and counted by reason.
+class AdmissionFilter {
+public:
+    static constexpr size_t KNOWN_SLOTS = macTableSlots(MAX_FLEET_TOWERS);
+    static constexpr size_t MAX_JOINING = 12;     // unknown senders tracked at once
+    static constexpr size_t BUCKET_SLOTS = macTableSlots(MAX_JOINING);
+    static constexpr uint8_t BUCKET_SIZE = 3;
+    static constexpr uint32_t REFILL_MS = 2000;
+    static constexpr uint8_t GLOBAL_BUCKET_SIZE = 8;
+    static constexpr uint32_t GLOBAL_REFILL_MS = 250;
+
+    enum class Verdict : uint8_t {
+        KNOWN,         // pass: a known peer
+        JOINING,       // pass: unknown sender, pairing frame, join window open
+        NOT_OPEN,      // drop: unknown sender outside the join window
+        NOT_PAIRING,   // drop: unknown sender, frame other than a pairing frame
+        RATE_LIMITED   // drop: unknown sender out of tokens
+    };
+
+    struct Counters {
+        uint32_t known;
+        uint32_t joining;
+        uint32_t notOpen;
+        uint32_t notPairing;
+        uint32_t rateLimited;
+    };
+
+    AdmissionFilter() : globalTokens(GLOBAL_BUCKET_SIZE), globalRefillMs(0) { memset(&totals, 0, sizeof(totals)); }
+
+    // False when the table is full
+    bool allow(MacKey peer) { return knownPeers.insert(peer) != nullptr; }
+    void disallow(MacKey peer) { knownPeers.erase(peer); }
+    void clearKnown() { knownPeers.clear(); }
+    bool isKnown(MacKey peer) const { return knownPeers.find(peer) != nullptr; }
+
+    // isPairingFrame() looks at the frame itself, so it is only called once
+    // the sender turned out to be unknown and the join window is open
+    template <typename IsPairingFrame>
+    Verdict check(MacKey sender, bool joinOpen, uint32_t now, IsPairingFrame isPairingFrame) {
+        if (knownPeers.find(sender)) {
+            totals.known++;
+            return Verdict::KNOWN;
+        }
+        if (!joinOpen) {
+            totals.notOpen++;
+            return Verdict::NOT_OPEN;
+        }
+        if (!isPairingFrame()) {
+            totals.notPairing++;
+            return Verdict::NOT_PAIRING;
+        }
+        if (!takeOwn(sender, now) || !takeGlobal(now)) {
+            totals.rateLimited++;
+            return Verdict::RATE_LIMITED;
+        }
+        totals.joining++;
+        return Verdict::JOINING;
+    }
+
+    uint32_t dropped() const { return totals.notOpen + totals.notPairing + totals.rateLimited; }
+    size_t knownCount() const { return knownPeers.size(); }
+    const Counters& counters() const { return totals; }
+
+private:
+    struct Known {};
+    struct Bucket {
+        uint8_t tokens;
+        uint32_t refillMs;  // when the last token was added
+    };
+    MacTable<Known, KNOWN_SLOTS> knownPeers;
+    MacTable<Bucket, BUCKET_SLOTS> buckets;
+    uint8_t globalTokens;
+    uint32_t globalRefillMs;
+    Counters totals;
+
+    static void refill(uint8_t& tokens, uint32_t& last, uint8_t size, uint32_t period, uint32_t now) {
+        if (tokens >= size) {  // full: the refill clock starts at the next use
+            last = now;
+            return;
+        }
+        uint32_t added = (now - last) / period;
+        if (added == 0) return;
+        tokens = (uint8_t)((tokens + added >= size) ? size : tokens + added);
+        last = (tokens == size) ? now : last + added * period;
+    }
+
+    bool takeGlobal(uint32_t now) {
+        refill(globalTokens, globalRefillMs, GLOBAL_BUCKET_SIZE, GLOBAL_REFILL_MS, now);
+        if (globalTokens == 0) return false;
+        globalTokens--;
+        return true;
+    }
+
+    bool takeOwn(MacKey sender, uint32_t now) {
+        Bucket* b = buckets.find(sender);
+        if (!b) {
+            if (buckets.full()) recycleOldest();
+            b = buckets.insert(sender);
+            b->tokens = BUCKET_SIZE;
+            b->refillMs = now;
+        }
+        refill(b->tokens, b->refillMs, BUCKET_SIZE, REFILL_MS, now);
+        if (b->tokens == 0) return false;
+        b->tokens--;
+        return true;
+    }
+
+    // Forget the sender refilled longest ago; a full bucket is nothing to lose
+    void recycleOldest() {
+        MacKey oldest = 0;
+        uint32_t oldestMs = 0;
+        bool any = false;
+        buckets.forEach([&](MacKey k, const Bucket& b) {
+            if (!any || (int32_t)(b.refillMs - oldestMs) < 0) {
+                oldest = k;
+                oldestMs = b.refillMs;
+                any = true;
+            }
+        });
+        if (any) buckets.erase(oldest);
+    }
+};
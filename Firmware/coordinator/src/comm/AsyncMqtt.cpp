@@ -443,14 +443,14 @@ void AsyncMqtt::publishTowerTelemetry(const TowerTelemetryMessage& telemetry) {
     doc["ts"] = telemetry.ts / 1000;
     doc["farm_id"] = farmId;
     doc["coord_id"] = coordId.length() ? coordId : WiFi.macAddress();
-    doc["tower_id"] = telemetry.tower_id;
+    doc["tower_id"] = telemetry.tower_id.c_str();
     doc["air_temp_c"] = telemetry.air_temp_c;
     doc["humidity_pct"] = telemetry.humidity_pct;
     doc["light_lux"] = telemetry.light_lux;
     doc["pump_on"] = telemetry.pump_on;
     doc["light_on"] = telemetry.light_on;
     doc["light_brightness"] = telemetry.light_brightness;
-    doc["status_mode"] = telemetry.status_mode.length() > 0 ? telemetry.status_mode : "idle";
+    doc["status_mode"] = telemetry.status_mode != StatusMode::UNSET ? statusModeName(telemetry.status_mode) : "idle";
     doc["vbat_mv"] = telemetry.vbat_mv;
     
     String payload;
@@ -542,7 +542,7 @@ void AsyncMqtt::publishThermalEvent(const String& nodeId, const NodeThermalData&
 void AsyncMqtt::publishNodeStatus(const NodeStatusMessage& status) {
     if (!isConnected()) return;
     StaticJsonDocument<512> doc;
-    doc["node_id"] = status.node_id;
+    doc["node_id"] = status.node_id.c_str();
     doc["temp_c"] = status.temperature;
     String payload;
     serializeJson(doc, payload);
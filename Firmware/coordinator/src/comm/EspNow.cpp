@@ -7,88 +7,46 @@
 #include "../nodes/NodeRegistry.h"
 #include "../utils/Logger.h"
 #include <Preferences.h>
-#include <map>
 
 // Simple singleton to bridge static callbacks
 static EspNow* s_self = nullptr;
-// Recently handled JOIN requests to avoid duplicate processing
-static std::map<String, uint32_t> s_recentJoin;
 
 // ESP-NOW callback with version compatibility
 #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
 // ESP-NOW v2.0 API (Arduino ESP32 3.x+)
+// Runs in the WiFi task: copy the frame into rxRing and return; EspNow::loop() handles it
 void staticRecvCallback(const esp_now_recv_info_t* recv_info, const uint8_t* data, int len) {
     if (s_self && recv_info && recv_info->src_addr) {
-        s_self->handleEspNowReceive(recv_info->src_addr, data, len);
-        
-        // Update RSSI stats (rx_ctrl is a pointer in ESP-NOW v2.0)
-        char macStr[18];
-        snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-                 recv_info->src_addr[0], recv_info->src_addr[1], recv_info->src_addr[2],
-                 recv_info->src_addr[3], recv_info->src_addr[4], recv_info->src_addr[5]);
-        String smac(macStr);
-        
-        auto& stats = s_self->peerStats[smac];
-        if (recv_info->rx_ctrl) {
-            stats.lastRssi = recv_info->rx_ctrl->rssi;
-        }
-        stats.lastSeenMs = millis();
-        stats.messageCount++;
-    } else {
-        Logger::error("s_self is NULL or invalid recv_info in receive callback!");
+        // rx_ctrl is a pointer in ESP-NOW v2.0
+        int8_t rssi = recv_info->rx_ctrl ? (int8_t)recv_info->rx_ctrl->rssi : LinkModel::RSSI_UNKNOWN;
+        s_self->enqueueReceive(recv_info->src_addr, rssi, data, len);
     }
 }
 #else
 // ESP-NOW v1.0 API (Arduino ESP32 2.x)
 void staticRecvCallback(const uint8_t* mac_addr, const uint8_t* data, int len) {
     if (s_self && mac_addr) {
-        s_self->handleEspNowReceive(mac_addr, data, len);
-        
-        // Update stats (no RSSI available in v1.0 API)
-        char macStr[18];
-        snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-                 mac_addr[0], mac_addr[1], mac_addr[2],
-                 mac_addr[3], mac_addr[4], mac_addr[5]);
-        String smac(macStr);
-        
-        auto& stats = s_self->peerStats[smac];
-        stats.lastRssi = -70; // Default RSSI value when not available
-        stats.lastSeenMs = millis();
-        stats.messageCount++;
-    } else {
-        Logger::error("s_self is NULL or invalid mac_addr in receive callback!");
+        s_self->enqueueReceive(mac_addr, LinkModel::RSSI_UNKNOWN, data, len); // no RSSI in the v1.0 API
     }
 }
 #endif
 
+// Runs in the WiFi task: hand the result to loop(), which matches it to the
+// queued frame. No logging here; loop() reports the counters.
 void staticSendCallback(const uint8_t* mac, esp_now_send_status_t status) {
-    if (!mac) {
-        Logger::warn("ESP-NOW V2: send_cb (null mac) status=%d", (int)status);
+    if (!s_self) return;
+    bool ok = (status == ESP_NOW_SEND_SUCCESS);
+    if (!ok) s_self->txFailures.fetch_add(1, std::memory_order_relaxed);
+    if (!mac) return;
+    EspNow::TxCompletion* c = s_self->txDone.claim();
+    if (!c) {
+        // Recovered by TxQueue's callback timeout
+        s_self->txDoneLost.fetch_add(1, std::memory_order_relaxed);
         return;
     }
-    
-    char macStr[18];
-    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-    
-    // Update stats and trigger error callback
-    if (s_self) {
-        String smac(macStr);
-        auto& stats = s_self->peerStats[smac];
-        if (status != ESP_NOW_SEND_SUCCESS) {
-            stats.failedCount++;
-            // Trigger error callback for visual feedback
-            if (s_self->sendErrorCallback) {
-                s_self->sendErrorCallback(smac);
-            }
-        }
-    }
-    
-    if (status == ESP_NOW_SEND_SUCCESS) {
-        Logger::debug("ESP-NOW V2: send_cb OK -> %s", macStr);
-    } else {
-        Logger::warn("ESP-NOW V2: send_cb to %s FAILED (status=%d)", macStr, (int)status);
-    }
+    c->peer = macKey(mac);
+    c->ok = ok;
+    s_self->txDone.publish();
 }
 
 // small helper to hex encode bytes
@@ -123,6 +81,8 @@ EspNow::EspNow()
 EspNow::~EspNow() {}
 
 bool EspNow::begin() {
+    // Random start so nodes never take a fresh command for one from before a reboot
+    groupSeq = (uint8_t)esp_random();
     Logger::info("===========================================");
     Logger::info("ESP-NOW V2.0 INITIALIZATION CHECKLIST");
     Logger::info("===========================================");
@@ -248,28 +208,22 @@ bool EspNow::begin() {
     
     esp_now_peer_info_t peerInfo = {};
     memcpy(peerInfo.peer_addr, bcast, 6);
-    peerInfo.channel = 1;
+    peerInfo.channel = 0; // follows the interface channel, like every unicast peer
     peerInfo.encrypt = false; // ✓ Checklist: Encryption - Disabled for now
     peerInfo.ifidx = WIFI_IF_STA;
     
     esp_err_t bres = esp_now_add_peer(&peerInfo);
     if (bres == ESP_OK) {
-        Logger::info("  ✓ Broadcast peer (FF:FF:FF:FF:FF:FF) added on channel 1");
+        Logger::info("  ✓ Broadcast peer (FF:FF:FF:FF:FF:FF) added on channel 0 (auto)");
     } else if (bres == ESP_ERR_ESPNOW_EXIST) {
         Logger::info("  ✓ Broadcast peer already exists");
     } else {
         Logger::error("✗ Failed to add broadcast peer, error=%d", (int)bres);
     }
     
-    // Load persisted peers and re-register them
+    // Load persisted peers; each is registered with the radio on its first send
     loadPeersFromStorage();
-    for (const auto& macStr : peers) {
-        uint8_t peerMac[6];
-        if (macStringToBytes(macStr, peerMac)) {
-            addPeer(peerMac);
-            Logger::info("  ✓ Restored peer: %s", macStr.c_str());
-        }
-    }
+    peerSlots.clear();
     
     Logger::info("===========================================");
     Logger::info("✓ ESP-NOW V2.0 READY - All checks passed!");
@@ -304,17 +258,12 @@ void EspNow::loop() {
                 esp_now_peer_info_t peerInfo = {};
                 memset(&peerInfo, 0, sizeof(peerInfo));
                 memcpy(peerInfo.peer_addr, "\xFF\xFF\xFF\xFF\xFF\xFF", 6);
-                peerInfo.channel = 1;
+                peerInfo.channel = 0;
                 peerInfo.encrypt = false;
                 peerInfo.ifidx = WIFI_IF_STA;
                 esp_now_add_peer(&peerInfo);
-                // Re-add all known peers
-                for (const auto& macStr : peers) {
-                    uint8_t peerMac[6];
-                    if (macStringToBytes(macStr, peerMac)) {
-                        addPeer(peerMac);
-                    }
-                }
+                // The radio lost every unicast peer; they are registered again on demand
+                peerSlots.clear();
             } else {
                 Logger::error("ESP-NOW reinit failed: %d", initResult);
             }
@@ -326,10 +275,24 @@ void EspNow::loop() {
     static uint32_t lastDebugLog = 0;
     uint32_t now = millis();
     if (now - lastDebugLog > 10000) {
-        Logger::debug("ESP-NOW: Loop running, pairing=%d, peers=%d", isPairingEnabled(), peers.size());
+        Logger::debug("ESP-NOW: Loop running, pairing=%d, peers=%d, rejected=%u", isPairingEnabled(), peers.size(),
+                      (unsigned)admission.dropped());
         lastDebugLog = now;
     }
 
+    drainReceived();
+    drainTxCompletions();
+    acks.flush(now, [this](MacKey peer, uint16_t seq, uint8_t count) {
+        uint8_t mac[6];
+        macFromKey(peer, mac);
+        sendAck(mac, seq, count);
+    });
+    pings.poll(now, [this](MacKey peer) -> uint32_t {
+        const PeerStats* stats = peerStats.find(peer);
+        return stats ? stats->lastSeenMs : 0;
+    }, [this](MacKey peer) { sendPing(peer); });
+    pumpTx();
+
     // Optimized pairing beacon with adaptive frequency
     if (isPairingEnabled()) {
         static uint32_t lastBeacon = 0;
@@ -338,8 +301,9 @@ void EspNow::loop() {
         
         if (now - lastBeacon > beaconInterval) {
             uint8_t bcast[6] = {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF};
-            const char* ping = "{\"msg\":\"pairing_ping\"}";
-            esp_err_t res = esp_now_send(bcast, (const uint8_t*)ping, strlen(ping));
+            // Bare, so nodes of any firmware can find us and pair
+            static const char PING[] = "{\"msg\":\"pairing_ping\"}";
+            esp_err_t res = esp_now_send(bcast, (const uint8_t*)PING, sizeof(PING) - 1);
             if (res != ESP_OK) {
                 Logger::debug("Pairing beacon failed: %d", (int)res);
             }
@@ -354,6 +318,89 @@ void EspNow::loop() {
     }
 }
 
+void EspNow::enqueueReceive(const uint8_t* mac, int8_t rssi, const uint8_t* data, int len) {
+    if (!data || len <= 0 || len > (int)WireConstants::MAX_FRAME_LEN) return;
+    RxFrame* f = rxRing.claim();
+    if (!f) return; // full: counted by the ring, reported from loop()
+    memcpy(f->mac, mac, 6);
+    f->rssi = rssi;
+    f->len = (uint8_t)len;
+    f->rxMs = millis();
+    memcpy(f->data, data, len);
+    rxRing.publish();
+}
+
+void EspNow::drainReceived() {
+    uint32_t dropped = rxRing.getDroppedCount();
+    if (dropped != rxDroppedReported) {
+        Logger::warn("ESP-NOW: RX ring full, %u frames dropped (%u total)",
+                     (unsigned)(dropped - rxDroppedReported), (unsigned)dropped);
+        rxDroppedReported = dropped;
+    }
+
+    // Bounded by what is queued now so a steady stream cannot hold the loop
+    for (size_t n = rxRing.size(); n > 0; n--) {
+        const RxFrame* f = rxRing.peek();
+        if (!f) break;
+        if (!admit(*f)) {
+            rxRing.pop();
+            continue;
+        }
+        PeerStats& stats = statsFor(f->mac);
+        stats.lastRssi = f->rssi;
+        stats.lastSeenMs = f->rxMs;
+        stats.messageCount++;
+        stats.link.onReceive(f->rssi, f->rxMs);
+
+        handleEspNowReceive(f->mac, f->data, f->len);
+        rxRing.pop();
+    }
+}
+
+// Frames a node sends while it is not paired yet
+static bool isPairingFrame(const uint8_t* data, size_t len) {
+    MessageType type;
+    if (FrameHeader::isFramed(data, len)) {
+        type = static_cast<MessageType>(data[2]); // header type byte; the CRC is checked later
+    } else if (!MessageFactory::peekMessageType(data, len, type)) {
+        return false;
+    }
+    switch (type) {
+        case MessageType::JOIN_REQUEST:
+        case MessageType::TOWER_JOIN_REQUEST:
+        case MessageType::PAIRING_ADVERTISEMENT:
+        case MessageType::PAIRING_ACCEPT:
+        case MessageType::PAIRING_ABORT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool EspNow::admit(const RxFrame& frame) {
+    AdmissionFilter::Verdict v = admission.check(macKey(frame.mac), isPairingEnabled(), frame.rxMs,
+        [&frame]() { return isPairingFrame(frame.data, frame.len); });
+    return v == AdmissionFilter::Verdict::KNOWN || v == AdmissionFilter::Verdict::JOINING;
+}
+
+const StageLatency& EspNow::getDecodeLatency() const {
+    return decodeLatency;
+}
+
+const AdmissionFilter::Counters& EspNow::getAdmissionCounters() const {
+    return admission.counters();
+}
+
+EspNow::RxQueueStats EspNow::getRxQueueStats() const {
+    RxQueueStats s;
+    s.received = rxRing.getPushedCount();
+    s.dropped = rxRing.getDroppedCount();
+    s.queued = (uint16_t)rxRing.size();
+    s.highWater = (uint16_t)rxRing.getHighWater();
+    s.capacity = (uint16_t)rxRing.capacity();
+    return s;
+}
+
 bool EspNow::sendLightCommand(const String& nodeId, uint8_t brightness, uint16_t fadeMs, bool overrideStatus, uint16_t ttlMs) {
     uint8_t mac[6];
     if (!macStringToBytes(nodeId, mac)) {
@@ -373,8 +420,7 @@ bool EspNow::sendLightCommand(const String& nodeId, uint8_t brightness, uint16_t
     msg.override_status = overrideStatus;
     msg.ttl_ms = ttlMs;
 
-    String json = msg.toJson();
-    bool ok = sendToMac(mac, json);
+    bool ok = sendSetLight(mac, msg);
     if (!ok) {
         Logger::warn("sendLightCommand: failed to deliver to %s", nodeId.c_str());
     } else {
@@ -405,8 +451,7 @@ bool EspNow::sendColorCommand(const String& nodeId, uint8_t r, uint8_t g, uint8_
     msg.ttl_ms = ttlMs;
     msg.pixel = pixel;
 
-    String json = msg.toJson();
-    bool ok = sendToMac(mac, json);
+    bool ok = sendSetLight(mac, msg);
     if (!ok) {
         Logger::warn("sendColorCommand: failed to deliver to %s", nodeId.c_str());
     } else {
@@ -416,6 +461,18 @@ bool EspNow::sendColorCommand(const String& nodeId, uint8_t r, uint8_t g, uint8_
     return ok;
 }
 
+bool EspNow::sendSetLight(const uint8_t mac[6], const SetLightMessage& msg) {
+    const PeerStats* stats = peerStats.find(macKey(mac));
+    if (stats && stats->compactWire) {
+        uint8_t frame[SetLightMessage::BINARY_SIZE];
+        size_t n = msg.toBinary(frame, sizeof(frame));
+        if (n > 0) {
+            return sendToMac(mac, frame, n);
+        }
+    }
+    return sendToMac(mac, msg);
+}
+
 bool EspNow::broadcastPairingMessage() {
     // Placeholder broadcast
     return true;
@@ -435,11 +492,11 @@ bool EspNow::isPairingEnabled() const {
     return pairingEnabled && pairingDl.running();
 }
 
-void EspNow::setMessageCallback(std::function<void(const String& nodeId, const uint8_t* data, size_t len)> callback) {
+void EspNow::setMessageCallback(std::function<void(const String& nodeId, const EspNowMessage& msg, size_t len)> callback) {
     messageCallback = callback;
 }
 
-void EspNow::setPairingCallback(std::function<void(const uint8_t* mac, const uint8_t* data, size_t len)> callback) {
+void EspNow::setPairingCallback(std::function<void(const uint8_t* mac, const EspNowMessage& msg)> callback) {
     pairingCallback = callback;
 }
 
@@ -453,17 +510,41 @@ void EspNow::handleEspNowReceive(const uint8_t* mac, const uint8_t* data, int le
         return; // Silent drop for invalid packets
     }
     
-    // Quick filter: must be JSON
-    if (((const char*)data)[0] != '{') {
-        return; // Drop non-JSON frames silently
+    PeerStats& stats = statsFor(mac);
+    
+    // Header checks come first: corrupt frames and repeats never reach the decoder
+    if (FrameHeader::isFramed(data, (size_t)len)) {
+        FrameHeader hdr;
+        if (!FrameHeader::parse(data, (size_t)len, hdr)) {
+            stats.corruptCount++;
+            Logger::debug("Corrupt %dB frame from " MAC_FMT " dropped", len, MAC_ARGS(mac));
+            return;
+        }
+        uint32_t lostBefore = stats.rxSeq.lost;
+        if (stats.rxSeq.check(hdr.seq, hdr.flags) == SequenceWindow::DUPLICATE) {
+            Logger::debug("Duplicate seq %u from " MAC_FMT " dropped", (unsigned)hdr.seq, MAC_ARGS(mac));
+            return;
+        }
+        // A late frame lowers the loss count; it is a gap of 0 for the link model
+        uint32_t gap = stats.rxSeq.lost > lostBefore ? stats.rxSeq.lost - lostBefore : 0;
+        if (!(hdr.flags & FrameHeader::FLAG_BROADCAST)) stats.link.onSequence(gap);
+        stats.framedWire = true;
+        data = hdr.payload;
+        len = (int)hdr.payloadLen;
+        if (len <= 0) return;
     }
     
-    char macStr[18];
-    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    // Quick filter: JSON or a compact binary hot-path frame (unframed from older firmware)
+    bool compact = MessageFactory::isCompactBinary(data, (size_t)len);
+    if (((const char*)data)[0] != '{' && !compact) {
+        return; // Drop anything else silently
+    }
+    if (compact) {
+        stats.compactWire = true;
+    }
     
     // Only log at DEBUG level to reduce overhead
-    Logger::debug("RX %dB from %s", len, macStr);
+    Logger::debug("RX %dB from " MAC_FMT, len, MAC_ARGS(mac));
     
     processReceivedData(mac, data, len);
 }
@@ -477,222 +558,423 @@ void EspNow::processReceivedData(const uint8_t* mac, const uint8_t* data, int le
     snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
     
-    // Avoid String allocation for nodeId until needed
-    // Basic forwarding: if pairing is active and the message is a join_request, forward raw data
-    String payload((const char*)data, len);
-    MessageType mt = MessageFactory::getMessageType(payload);
+    // Decode exactly once here, into rxSlot; handlers receive the typed message
+    uint32_t decodeStartUs = micros();
+    EspNowMessage* msg = MessageFactory::decode(data, (size_t)len, rxSlot);
+    decodeLatency.record(micros() - decodeStartUs);
+    if (!msg) {
+        Logger::debug("Undecodable %dB frame from %s dropped", len, macStr);
+        return;
+    }
     
-    // Only log at debug when needed
-    if (mt == MessageType::JOIN_REQUEST) {
+    if (msg->type == MessageType::JOIN_REQUEST) {
         Logger::info("JOIN_REQUEST from %s", macStr);
-        // Deduplicate JOIN within 4s per MAC
+        // Retransmitted copies are already gone; this throttles a node retrying its join
         uint32_t nowMs = millis();
-        auto it = s_recentJoin.find(String(macStr));
-        if (it != s_recentJoin.end() && (nowMs - it->second) < 4000U) {
-            Logger::debug("Duplicate JOIN_REQUEST ignored for %s", macStr);
+        PeerStats& stats = statsFor(mac);
+        if (stats.lastJoinMs != 0 && (nowMs - stats.lastJoinMs) < 4000U) {
+            Logger::debug("Repeated JOIN_REQUEST ignored for %s", macStr);
             return;
         }
-        s_recentJoin[String(macStr)] = nowMs;
+        stats.lastJoinMs = nowMs ? nowMs : 1;
 
         // Always ensure peer exists so we can unicast responses
         addPeer(mac);
 
         if (isPairingEnabled()) {
             if (pairingCallback) {
-                pairingCallback(mac, data, (size_t)len);
+                pairingCallback(mac, *msg);
             } else {
                 Logger::error("Pairing active but no pairingCallback registered");
             }
-        } else {
-        // Forward to general handler so Coordinator can re-accept known nodes
-            if (messageCallback) {
-                String nodeId(macStr);
-                messageCallback(nodeId, (const uint8_t*)payload.c_str(), payload.length());
-            }
+            return;
         }
-        return;
+        // Otherwise fall through so Coordinator can re-accept known nodes
     }
 
     // Forward other messages via general callback
     if (messageCallback) {
         String nodeId(macStr);
-        messageCallback(nodeId, (const uint8_t*)payload.c_str(), payload.length());
+        messageCallback(nodeId, *msg, (size_t)len);
     }
 }
 
 bool EspNow::sendToMac(const uint8_t mac[6], const String& json) {
+    return sendToMac(mac, (const uint8_t*)json.c_str(), json.length());
+}
+
+bool EspNow::sendToMac(const uint8_t mac[6], const EspNowMessage& msg) {
+    return queueToMac(mac, msg) != TxQueue::NO_HANDLE;
+}
+
+bool EspNow::sendToMac(const uint8_t mac[6], const uint8_t* data, size_t len) {
+    return queueToMac(mac, data, len) != TxQueue::NO_HANDLE;
+}
+
+TxQueue::Handle EspNow::queueToMac(const uint8_t mac[6], const EspNowMessage& msg, uint32_t deadlineMs) {
+    // Encode behind the header's bytes so framing needs no copy
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    size_t n = msg.encode(frame + FrameHeader::SIZE, WireConstants::MAX_PAYLOAD_LEN);
+    if (n == 0) {
+        Logger::error("%s does not fit in one frame (max %d bytes)", msg.msg, (int)WireConstants::MAX_PAYLOAD_LEN);
+        return TxQueue::NO_HANDLE;
+    }
+    return sendFramed(mac, frame, n, msg.type, deadlineMs);
+}
+
+TxQueue::Handle EspNow::queueToMac(const uint8_t mac[6], const uint8_t* data, size_t len, uint32_t deadlineMs) {
     // ✓ Checklist: Message Size - Verify before sending
-    if (json.length() > 250) {
-        Logger::error("Message too large: %d bytes (max 250)", json.length());
+    if (len > WireConstants::MAX_PAYLOAD_LEN) {
+        Logger::error("Message too large: %d bytes (max %d)", (int)len, (int)WireConstants::MAX_PAYLOAD_LEN);
+        return TxQueue::NO_HANDLE;
+    }
+    MessageType type;
+    if (!MessageFactory::peekMessageType(data, len, type)) type = FrameHeader::UNTYPED;
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    memcpy(frame + FrameHeader::SIZE, data, len);
+    return sendFramed(mac, frame, len, type, deadlineMs);
+}
+
+TxQueue::Handle EspNow::sendFramed(const uint8_t mac[6], uint8_t* frame, size_t payloadLen, MessageType type,
+                                   uint32_t deadlineMs) {
+    PeerStats& stats = statsFor(mac);
+    size_t n = payloadLen;
+    const uint8_t* out = FrameHeader::wrapFor(stats.framedWire, frame, n, type, stats.txSeq);
+    if (!out) return TxQueue::NO_HANDLE;
+    TxQueue::Handle h = txQueue.enqueue(mac, out, n, millis(), deadlineMs);
+    if (h == TxQueue::NO_HANDLE) {
+        stats.txDropped++;
+        Logger::warn("TX queue full, frame to " MAC_FMT " dropped", MAC_ARGS(mac));
+        return h;
+    }
+    acks.piggyback(macKey(mac)); // this frame tells the peer we are alive
+    pumpTx(); // usually goes out right away; loop() picks up the rest
+    return h;
+}
+
+bool EspNow::sendGroupCommand(GroupCommandMessage& msg) {
+    static const uint8_t BCAST[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    msg.cmd_seq = groupSeq++;
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    size_t n = msg.encode(frame + FrameHeader::SIZE, WireConstants::MAX_PAYLOAD_LEN);
+    if (n == 0) {
+        Logger::error("group_command does not fit in one frame");
         return false;
     }
-    
-    char macStr[18];
-    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-    
-    // ✓ Checklist: Error Handling - Check send result
-    esp_err_t res = esp_now_send(mac, (uint8_t*)json.c_str(), json.length());
-    if (res != ESP_OK) {
-        // ESP_ERR_ESPNOW_NOT_INIT (12389) means ESP-NOW was deinitialized!
-        if (res == ESP_ERR_ESPNOW_NOT_INIT || res == 12389) {
-            Logger::error("ESP-NOW not initialized (error %d)! Marking for reinit.", res);
-            initialized = false;
-            return false;
-        }
-        // ESP_ERR_ESPNOW_NOT_FOUND (12393) means peer not registered - try adding
-        if (res == ESP_ERR_ESPNOW_NOT_FOUND) {
-            Logger::info("Peer %s not found in ESP-NOW, adding...", macStr);
-            if (addPeer(mac)) {
-                // Small delay to ensure peer is registered
-                delay(10);
-                // Retry send after adding peer
-                res = esp_now_send(mac, (uint8_t*)json.c_str(), json.length());
-                if (res == ESP_OK) {
-                    Logger::info("Send successful after adding peer %s", macStr);
-                    return true;
-                } else {
-                    Logger::warn("Send to %s failed after adding peer: %d", macStr, res);
-                }
-            } else {
-                Logger::warn("Failed to add peer %s", macStr);
-            }
-        }
-        Logger::warn("ESP-NOW V2 send failed to %s: %d", macStr, res);
+    n = FrameHeader::wrapNext(frame, n, msg.type, beaconSeq, FrameHeader::FLAG_BROADCAST);
+    // Identical copies: the queue keeps one broadcast in flight, so they leave back to back
+    uint8_t queued = 0;
+    for (uint8_t i = 0; i < GROUP_SENDS; i++) {
+        if (txQueue.enqueue(BCAST, frame, n, millis()) != TxQueue::NO_HANDLE) queued++;
+    }
+    if (queued == 0) {
+        Logger::warn("TX queue full, group %u command dropped", (unsigned)msg.group_id);
         return false;
     }
+    Logger::debug("Group %u command %u queued (%u member bytes)", (unsigned)msg.group_id,
+                  (unsigned)msg.cmd_seq, (unsigned)msg.member_bytes);
+    pumpTx();
     return true;
 }
 
+void EspNow::ackLater(const uint8_t mac[6]) {
+    const PeerStats& stats = statsFor(mac);
+    uint16_t seq = stats.rxSeq.valid ? stats.rxSeq.lastSeq : 0;
+    if (!acks.note(macKey(mac), seq, millis())) {
+        sendAck(mac, seq, 1);
+    }
+}
+
+const AckCoalescer::Counters& EspNow::getAckCounters() const {
+    return acks.counters();
+}
+
+void EspNow::sendAck(const uint8_t mac[6], uint16_t seq, uint8_t count) {
+    AckMessage ack;
+    ack.cmd_id = "telemetry_ack";
+    ack.ack_seq = seq;
+    ack.ack_count = count;
+    const PeerStats* stats = peerStats.find(macKey(mac));
+    bool sent;
+    if (stats && stats->compactWire) {
+        uint8_t frame[AckMessage::BINARY_SIZE];
+        size_t n = ack.toBinary(frame, sizeof(frame));
+        sent = n > 0 && sendToMac(mac, frame, n);
+    } else {
+        sent = sendToMac(mac, ack);
+    }
+    if (!sent) {
+        Logger::debug("Failed to queue ack to " MAC_FMT, MAC_ARGS(mac));
+    }
+}
+
+void EspNow::setPingPolicy(uint32_t intervalMs, uint32_t staleMs) {
+    pings.configure(intervalMs, staleMs);
+}
+
+bool EspNow::watchPeer(const uint8_t mac[6]) {
+    if (pings.watch(macKey(mac), millis())) return true;
+    Logger::warn("Ping table full, " MAC_FMT " not watched", MAC_ARGS(mac));
+    return false;
+}
+
+void EspNow::unwatchPeer(const uint8_t mac[6]) {
+    pings.unwatch(macKey(mac));
+}
+
+const PingScheduler::Counters& EspNow::getPingCounters() const {
+    return pings.counters();
+}
+
+void EspNow::sendPing(MacKey peer) {
+    static const uint8_t PING[WireConstants::PING_LEN] = { WireConstants::PING_MARKER, WireConstants::FORMAT_VERSION };
+    uint8_t mac[6];
+    macFromKey(peer, mac);
+    uint8_t frame[FrameHeader::SIZE + sizeof(PING)];
+    memcpy(frame + FrameHeader::SIZE, PING, sizeof(PING));
+    sendFramed(mac, frame, sizeof(PING), FrameHeader::UNTYPED, TxQueue::DEFAULT_DEADLINE_MS); // full queue is logged there
+}
+
+TxQueue::State EspNow::txState(TxQueue::Handle handle) const {
+    return txQueue.state(handle);
+}
+
+const TxQueue::Counters& EspNow::getTxCounters() const {
+    return txQueue.counters();
+}
+
+void EspNow::pumpTx() {
+    if (!initialized || channelChanging) return;
+    txQueue.pump(millis(),
+        [this](const uint8_t* mac, const uint8_t* data, size_t len) { return transmit(mac, data, len); },
+        [this](MacKey peer, TxQueue::State state, uint8_t attempts) { onTxFinished(peer, state, attempts); });
+}
+
+void EspNow::drainTxCompletions() {
+    uint32_t failures = txFailures.load(std::memory_order_relaxed);
+    if (failures != txFailuresReported) {
+        Logger::warn("ESP-NOW: %u sends failed (%u total)",
+                     (unsigned)(failures - txFailuresReported), (unsigned)failures);
+        txFailuresReported = failures;
+    }
+    uint32_t lost = txDoneLost.load(std::memory_order_relaxed);
+    if (lost != txDoneLostReported) {
+        Logger::warn("ESP-NOW: TX completion ring full, %u results lost (%u total)",
+                     (unsigned)(lost - txDoneLostReported), (unsigned)lost);
+        txDoneLostReported = lost;
+    }
+
+    uint32_t now = millis();
+    for (const TxCompletion* c = txDone.peek(); c; c = txDone.peek()) {
+        TxCompletion done = *c;
+        txDone.pop();
+        PeerStats* stats = peerStats.find(done.peer);
+        if (stats) stats->link.onTxAttempt(done.ok);
+        if (!done.ok) {
+            if (stats) stats->failedCount++;
+            // Trigger error callback for visual feedback
+            if (sendErrorCallback) {
+                uint8_t mac[6];
+                macFromKey(done.peer, mac);
+                char macStr[18];
+                snprintf(macStr, sizeof(macStr), MAC_FMT, MAC_ARGS(mac));
+                sendErrorCallback(String(macStr));
+            }
+        }
+        txQueue.complete(done.peer, done.ok, now,
+            [this](MacKey peer, TxQueue::State state, uint8_t attempts) { onTxFinished(peer, state, attempts); });
+    }
+}
+
+TxQueue::Attempt EspNow::transmit(const uint8_t mac[6], const uint8_t* data, size_t len) {
+    // Unicast peers are registered on demand; broadcast was registered in begin()
+    bool unicast = (mac[0] & 0x01) == 0;
+    if (unicast && !acquirePeer(mac)) {
+        return initialized ? TxQueue::Attempt::RETRY : TxQueue::Attempt::HOLD;
+    }
+    // ✓ Checklist: Error Handling - Check send result
+    esp_err_t res = esp_now_send(mac, data, len);
+    if (res == ESP_OK) return TxQueue::Attempt::SENT;
+    // ESP_ERR_ESPNOW_NOT_INIT (12389) means ESP-NOW was deinitialized!
+    if (res == ESP_ERR_ESPNOW_NOT_INIT || res == 12389) {
+        Logger::error("ESP-NOW not initialized (error %d)! Marking for reinit.", res);
+        initialized = false;
+        return TxQueue::Attempt::HOLD;
+    }
+    // ESP_ERR_ESPNOW_NOT_FOUND (12393): the radio dropped a peer PeerSlots thought
+    // registered; forget it so the retry after backoff registers it again
+    if (res == ESP_ERR_ESPNOW_NOT_FOUND) {
+        Logger::info("Peer " MAC_FMT " not found in ESP-NOW, re-registering", MAC_ARGS(mac));
+        peerSlots.forget(macKey(mac));
+        return TxQueue::Attempt::RETRY;
+    }
+    Logger::warn("ESP-NOW V2 send failed to " MAC_FMT ": %d", MAC_ARGS(mac), res);
+    return TxQueue::Attempt::RETRY;
+}
+
+void EspNow::onTxFinished(MacKey peer, TxQueue::State state, uint8_t attempts) {
+    PeerStats* stats = peerStats.find(peer);
+    if (stats) {
+        if (attempts > 1) stats->txRetries += attempts - 1;
+        if (state == TxQueue::State::DELIVERED) stats->txDelivered++;
+        else stats->txDropped++;
+    }
+    if (state != TxQueue::State::DELIVERED) {
+        uint8_t mac[6];
+        macFromKey(peer, mac);
+        Logger::warn("TX to " MAC_FMT " %s after %u attempts", MAC_ARGS(mac),
+                     state == TxQueue::State::EXPIRED ? "expired" : "failed", (unsigned)attempts);
+    }
+}
+
 bool EspNow::addPeer(const uint8_t mac[6]) {
     // ✓ Checklist: Peer Registration - Register node's MAC on coordinator
     char macStr[18];
     snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
     String smac(macStr);
-    
+
+    if (!admission.allow(macKey(mac))) {
+        Logger::warn("Admission table full: frames from %s will be dropped", macStr);
+    }
+
+    // Only the software list here: the radio holds ~20 peers, so transmit()
+    // registers it just before the first frame and may evict it again later
+    if (std::find(peers.begin(), peers.end(), smac) == peers.end()) {
+        peers.push_back(smac);
+        savePeersToStorage();
+        Logger::info("✓ Peer added: %s (%d known)", macStr, (int)peers.size());
+    } else {
+        Logger::debug("Peer already known: %s", macStr);
+    }
+    return true;
+}
+
+bool EspNow::acquirePeer(const uint8_t mac[6]) {
+    return peerSlots.acquire(macKey(mac),
+        [this](const uint8_t* m) { return registerPeer(m); },
+        [this](const uint8_t* m) { return unregisterPeer(m); },
+        [this](MacKey p) { return txQueue.busy(p); });
+}
+
+bool EspNow::registerPeer(const uint8_t mac[6]) {
     // Use channel 0 to communicate on current interface channel
     // This ensures communication works regardless of WiFi channel changes
-    Logger::info("Adding peer %s with channel 0 (auto-current)", macStr);
-    
-    // Always try to add peer to ESP-NOW (it will return EXIST if already there)
     esp_now_peer_info_t peerInfo = {};
     memcpy(peerInfo.peer_addr, mac, 6);
     peerInfo.channel = 0; // Use 0 = current interface channel (adapts to WiFi changes)
     peerInfo.encrypt = false; // ✓ Checklist: Encryption disabled
     peerInfo.ifidx = WIFI_IF_STA;
-    
+
     esp_err_t res = esp_now_add_peer(&peerInfo);
-    if (res == ESP_OK) {
-        // Successfully added - update our cache
-        bool found = false;
-        for (const auto& s : peers) {
-            if (s == smac) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            peers.push_back(smac);
-            savePeersToStorage();
-        }
-        Logger::info("✓ Peer registered: %s (channel 0 = auto)", macStr);
+    if (res == ESP_OK || res == ESP_ERR_ESPNOW_EXIST) {
+        Logger::debug("Peer " MAC_FMT " registered (%d/%d slots)", MAC_ARGS(mac),
+                      (int)peerSlots.size() + 1, (int)PeerSlots::SLOTS);
         return true;
-    } else if (res == ESP_ERR_ESPNOW_EXIST) {
-        // Already exists in ESP-NOW - ensure it's in our cache
-        bool found = false;
-        for (const auto& s : peers) {
-            if (s == smac) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            peers.push_back(smac);
-            savePeersToStorage();
-        }
-        Logger::debug("Peer already registered: %s", macStr);
-        return true;
-    } else if (res == ESP_ERR_ESPNOW_NOT_INIT || res == 12389) {
-        Logger::error("ESP-NOW not initialized when adding peer %s! Marking for reinit.", macStr);
+    }
+    if (res == ESP_ERR_ESPNOW_NOT_INIT || res == 12389) {
+        Logger::error("ESP-NOW not initialized when adding peer " MAC_FMT "! Marking for reinit.", MAC_ARGS(mac));
         initialized = false;
         return false;
-    } else {
-        Logger::warn("✗ Failed to add peer %s: error %d", macStr, res);
-        return false;
     }
+    Logger::warn("✗ Failed to register peer " MAC_FMT ": error %d", MAC_ARGS(mac), res);
+    return false;
 }
 
-bool EspNow::removePeer(const uint8_t mac[6]) {
+bool EspNow::unregisterPeer(const uint8_t mac[6]) {
     esp_err_t res = esp_now_del_peer(mac);
-    if (res == ESP_OK) {
-        char macStr[18];
-        snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-                 mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-        String smac(macStr);
-        peers.erase(std::remove(peers.begin(), peers.end(), smac), peers.end());
-        savePeersToStorage();
-        return true;
+    return res == ESP_OK || res == ESP_ERR_ESPNOW_NOT_FOUND;
+}
+
+const PeerSlots::Counters& EspNow::getPeerSlotCounters() const {
+    return peerSlots.counters();
+}
+
+size_t EspNow::registeredPeerCount() const {
+    return peerSlots.size();
+}
+
+bool EspNow::removePeer(const uint8_t mac[6]) {
+    char macStr[18];
+    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    String smac(macStr);
+    auto it = std::find(peers.begin(), peers.end(), smac);
+    if (it == peers.end()) {
+        Logger::warn("Failed to remove peer %s: not known", macStr);
+        return false;
     }
-    Logger::warn("Failed to remove peer: %d", res);
-    return false;
+    peerSlots.release(macKey(mac), [this](const uint8_t* m) { return unregisterPeer(m); });
+    admission.disallow(macKey(mac));
+    peers.erase(it);
+    peerStats.erase(macKey(mac));
+    savePeersToStorage();
+    return true;
 }
 
 void EspNow::updatePeerChannels() {
-    uint8_t currentChannel = 1;
-    wifi_second_chan_t second = WIFI_SECOND_CHAN_NONE;
-    esp_wifi_get_channel(&currentChannel, &second);
-    
-    Logger::info("Updating all ESP-NOW peers to channel %d", currentChannel);
-    
-    // Update broadcast peer
-    uint8_t bcast[6];
-    memset(bcast, 0xFF, 6);
-    esp_now_peer_info_t peerInfo = {};
-    if (esp_now_get_peer(bcast, &peerInfo) == ESP_OK) {
-        if (peerInfo.channel != currentChannel) {
-            esp_now_del_peer(bcast);
-            memcpy(peerInfo.peer_addr, bcast, 6);
-            peerInfo.channel = currentChannel;
-            peerInfo.encrypt = false;
-            peerInfo.ifidx = WIFI_IF_STA;
-            esp_now_add_peer(&peerInfo);
-            Logger::info("  ✓ Broadcast peer updated to channel %d", currentChannel);
+    // One esp_now_mod_peer per peer still on a fixed channel (registered by
+    // older firmware); normally there are none and this costs one lookup each
+    int moved = 0;
+    auto toChannelZero = [&moved](const uint8_t* mac) {
+        esp_now_peer_info_t peerInfo = {};
+        if (esp_now_get_peer(mac, &peerInfo) == ESP_OK && peerInfo.channel != 0) {
+            peerInfo.channel = 0;
+            if (esp_now_mod_peer(&peerInfo) == ESP_OK) moved++;
         }
-    }
-    
-    // Update all registered peers
-    for (const auto& macStr : peers) {
+    };
+    static const uint8_t BCAST[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    toChannelZero(BCAST);
+    peerSlots.forEach([&](MacKey peer) {
         uint8_t mac[6];
-        if (macStringToBytes(macStr, mac)) {
-            if (esp_now_get_peer(mac, &peerInfo) == ESP_OK) {
-                if (peerInfo.channel != currentChannel) {
-                    esp_now_del_peer(mac);
-                    memcpy(peerInfo.peer_addr, mac, 6);
-                    peerInfo.channel = currentChannel;
-                    peerInfo.encrypt = false;
-                    peerInfo.ifidx = WIFI_IF_STA;
-                    esp_now_add_peer(&peerInfo);
-                    Logger::debug("  ✓ Peer %s updated to channel %d", macStr.c_str(), currentChannel);
-                }
-            }
-        }
-    }
+        macFromKey(peer, mac);
+        toChannelZero(mac);
+    });
+    if (moved > 0) Logger::info("Moved %d ESP-NOW peer(s) to channel 0 (auto)", moved);
+}
+
+void EspNow::beginChannelChange() {
+    if (channelChanging) return;
+    channelChanging = true;
+    channelChangeStartMs = millis();
+}
+
+void EspNow::endChannelChange() {
+    if (!channelChanging) return;
+    uint32_t now = millis();
+    uint32_t blackout = now - channelChangeStartMs;
+    channelChanging = false;
+    updatePeerChannels();
+    channelStats.changes++;
+    channelStats.lastBlackoutMs = blackout;
+    if (blackout > channelStats.maxBlackoutMs) channelStats.maxBlackoutMs = blackout;
+    channelStats.lastHeldFrames = txQueue.resumeAfter(now, blackout);
+    uint8_t channel = 0;
+    wifi_second_chan_t second = WIFI_SECOND_CHAN_NONE;
+    esp_wifi_get_channel(&channel, &second);
+    Logger::info("ESP-NOW on channel %d after %lu ms blackout, flushing %lu queued frame(s)", (int)channel,
+                 (unsigned long)blackout, (unsigned long)channelStats.lastHeldFrames);
+    pumpTx();
+}
+
+const EspNow::ChannelChangeStats& EspNow::getChannelChangeStats() const {
+    return channelStats;
 }
 
 void EspNow::clearAllPeers() {
     Logger::info("Clearing all ESP-NOW peers...");
     size_t count = peers.size();
     
-    // Remove all peers from ESP-NOW
-    for (const auto& macStr : peers) {
+    // Remove the registered peers from ESP-NOW
+    peerSlots.forEach([](MacKey peer) {
         uint8_t mac[6];
-        if (macStringToBytes(macStr, mac)) {
-            esp_now_del_peer(mac);
-        }
-    }
+        macFromKey(peer, mac);
+        esp_now_del_peer(mac);
+    });
     
     // Clear internal lists
+    peerSlots.clear();
+    admission.clearKnown();
     peers.clear();
     peerStats.clear();
     
@@ -717,10 +999,15 @@ void EspNow::loadPeersFromStorage() {
     uint32_t count = p.getUInt("count", 0);
     peers.clear(); 
     peers.reserve(count);
+    admission.clearKnown();
     for (uint32_t i=0; i<count; i++) {
         String key = String("mac") + String(i);
         String mac = p.getString(key.c_str(), "");
-        if (mac.length() == 17) peers.push_back(mac);
+        MacKey peer;
+        if (mac.length() == 17 && macKeyFromString(mac.c_str(), peer)) {
+            peers.push_back(mac);
+            admission.allow(peer);
+        }
     }
     p.end();
     Logger::info("Loaded %d peers from storage", peers.size());
@@ -743,14 +1030,54 @@ void EspNow::savePeersToStorage() {
 }
 
 int8_t EspNow::getPeerRssi(const String& macStr) const {
-    auto it = peerStats.find(macStr);
-    return (it != peerStats.end()) ? it->second.lastRssi : -127;
+    MacKey key;
+    const PeerStats* stats = macKeyFromString(macStr.c_str(), key) ? peerStats.find(key) : nullptr;
+    return stats ? stats->lastRssi : -127;
 }
 
 PeerStats EspNow::getPeerStats(const String& macStr) const {
-    auto it = peerStats.find(macStr);
-    if (it != peerStats.end()) {
-        return it->second;
+    MacKey key;
+    const PeerStats* stats = macKeyFromString(macStr.c_str(), key) ? peerStats.find(key) : nullptr;
+    if (stats) {
+        return *stats;
     }
-    return PeerStats{-127, 0, 0, 0};
+    PeerStats none = PeerStats();
+    none.lastRssi = -127;
+    return none;
+}
+
+std::vector<LinkSnapshot> EspNow::getLinkSnapshots() const {
+    std::vector<LinkSnapshot> links;
+    links.reserve(peerStats.size());
+    uint32_t now = millis();
+    peerStats.forEach([&](MacKey peer, const PeerStats& s) {
+        if (s.messageCount > 0 || s.txDelivered + s.txDropped > 0) links.push_back(LinkSnapshot::of(peer, s.link, now));
+    });
+    std::sort(links.begin(), links.end(), LinkSnapshot::worse);
+    return links;
+}
+
+PeerStats& EspNow::statsFor(const uint8_t mac[6]) {
+    MacKey key = macKey(mac);
+    PeerStats* stats = peerStats.insert(key);
+    if (stats) return *stats;
+
+    // Full: give the slot of the peer heard from longest ago to the new one.
+    // Known towers keep theirs (sequence, wire format and link history); the
+    // table has room for all of them, so only joiners and departed peers go.
+    MacKey stalest = key;
+    bool stalestKnown = true;
+    uint32_t now = millis();
+    uint32_t oldestAge = 0;
+    peerStats.forEach([&](MacKey k, const PeerStats& s) {
+        bool known = admission.isKnown(k);
+        uint32_t age = now - s.lastSeenMs;
+        if (stalest == key || (stalestKnown && !known) || (known == stalestKnown && age > oldestAge)) {
+            stalest = k;
+            stalestKnown = known;
+            oldestAge = age;
+        }
+    });
+    peerStats.erase(stalest);
+    return *peerStats.insert(key);
 }
@@ -6,8 +6,20 @@
 #include <functional>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include "../Models.h"
 #include "../../shared/src/utils/SafeTimer.h"
+#include "../../shared/src/EspNowMessage.h"
+#include "../../shared/src/FrameHeader.h"
+#include "RxRing.h"
+#include "PeerTable.h"
+#include "TxQueue.h"
+#include "AckCoalescer.h"
+#include "PingScheduler.h"
+#include "PeerSlots.h"
+#include "LinkModel.h"
+#include "AdmissionFilter.h"
+#include "../utils/StageLatency.h"
 
 // Forward declarations for ESP-NOW callback functions
 class EspNow;
@@ -27,7 +39,17 @@ struct PeerStats {
     int8_t lastRssi;
     uint32_t lastSeenMs;
     uint32_t messageCount;
-    uint32_t failedCount;
+    uint32_t failedCount;   // send attempts the radio reported as failed
+    bool compactWire;       // peer has sent compact binary frames, so it can decode them
+    bool framedWire;        // peer has sent FrameHeader frames; older firmware is sent bare payloads
+    uint16_t txSeq;         // next FrameHeader sequence number we send to this peer
+    SequenceWindow rxSeq;   // its sequence as we receive it: duplicates and loss
+    uint32_t corruptCount;  // framed frames dropped on a bad CRC
+    uint32_t lastJoinMs;    // last JOIN_REQUEST handled, to throttle repeats
+    uint32_t txDelivered;   // frames the send callback confirmed
+    uint32_t txRetries;     // extra attempts spent on frames to this peer
+    uint32_t txDropped;     // frames given up: attempts exhausted or deadline passed
+    LinkModel link;         // smoothed RSSI, loss, TX failures and jitter
 };
 
 class EspNow {
@@ -55,45 +77,165 @@ public:
     static bool macStringToBytes(const String& macStr, uint8_t out[6]);
     // send JSON blob directly to a MAC (raw bytes)
     bool sendToMac(const uint8_t mac[6], const String& json);
+    // send an already-encoded frame (JSON or compact binary)
+    bool sendToMac(const uint8_t mac[6], const uint8_t* data, size_t len);
+    // encode a message into a stack frame and send it; no heap use
+    bool sendToMac(const uint8_t mac[6], const EspNowMessage& msg);
+    // sendToMac() returns once the frame is queued; these also return a handle
+    // to follow it through txState() until delivered, failed or expired
+    TxQueue::Handle queueToMac(const uint8_t mac[6], const EspNowMessage& msg,
+                               uint32_t deadlineMs = TxQueue::DEFAULT_DEADLINE_MS);
+    TxQueue::Handle queueToMac(const uint8_t mac[6], const uint8_t* data, size_t len,
+                               uint32_t deadlineMs = TxQueue::DEFAULT_DEADLINE_MS);
+    TxQueue::State txState(TxQueue::Handle handle) const;
+    const TxQueue::Counters& getTxCounters() const;
+    // One broadcast frame for every member of msg's bitmap instead of a unicast
+    // per tower. Fills in msg.cmd_seq; false if nothing could be queued.
+    bool sendGroupCommand(GroupCommandMessage& msg);
+    // Acknowledge the peer's frames within AckCoalescer::WINDOW_MS: one
+    // cumulative ack per window, or none if another frame goes to it first
+    void ackLater(const uint8_t mac[6]);
+    const AckCoalescer::Counters& getAckCounters() const;
+    // Liveness pings from loop(), spread over intervalMs. A watched peer heard
+    // from within half of staleMs is not pinged; closer to staleMs it is
+    // pinged more often. Watching is idempotent; false when the table is full.
+    void setPingPolicy(uint32_t intervalMs, uint32_t staleMs);
+    bool watchPeer(const uint8_t mac[6]);
+    void unwatchPeer(const uint8_t mac[6]);
+    const PingScheduler::Counters& getPingCounters() const;
     
     // Pairing
     void enablePairingMode(uint32_t durationMs = 30000);
     void disablePairingMode();
     bool isPairingEnabled() const;
-    // Persistence
+    // Persistence. The peer list is kept in software; a peer is registered
+    // with the radio just before a frame goes to it (see PeerSlots).
     bool addPeer(const uint8_t mac[6]);
     bool removePeer(const uint8_t mac[6]);
     void clearAllPeers();
     void loadPeersFromStorage();
     void savePeersToStorage();
+    const PeerSlots::Counters& getPeerSlotCounters() const;
+    size_t registeredPeerCount() const;
     
     // Callbacks
-    void setMessageCallback(std::function<void(const String& nodeId, const uint8_t* data, size_t len)> callback);
-    void setPairingCallback(std::function<void(const uint8_t* mac, const uint8_t* data, size_t len)> callback);
+    // Frames are decoded once in EspNow; the message is only valid for the duration of the call
+    void setMessageCallback(std::function<void(const String& nodeId, const EspNowMessage& msg, size_t len)> callback);
+    void setPairingCallback(std::function<void(const uint8_t* mac, const EspNowMessage& msg)> callback);
     void setSendErrorCallback(std::function<void(const String& nodeId)> callback);
     
     // Connection quality
     int8_t getPeerRssi(const String& macStr) const;
     PeerStats getPeerStats(const String& macStr) const;
+    // Every peer heard from or sent to, worst link first
+    std::vector<LinkSnapshot> getLinkSnapshots() const;
+
+    // Receive queue between the WiFi task and loop()
+    struct RxQueueStats {
+        uint32_t received;   // frames queued by the receive callback
+        uint32_t dropped;    // frames lost because the ring was full
+        uint16_t queued;     // waiting for loop() right now
+        uint16_t highWater;  // most frames ever waiting at once
+        uint16_t capacity;
+    };
+    RxQueueStats getRxQueueStats() const;
+    // Frames let in or dropped before any processing, by reason
+    const AdmissionFilter::Counters& getAdmissionCounters() const;
+    // Time MessageFactory::decode takes per frame, the first ingest stage
+    const StageLatency& getDecodeLatency() const;
 
 private:
     bool initialized;
     bool pairingEnabled;
     Deadline pairingDl;
-    std::function<void(const String& nodeId, const uint8_t* data, size_t len)> messageCallback;
-    std::function<void(const uint8_t* mac, const uint8_t* data, size_t len)> pairingCallback;
+    std::function<void(const String& nodeId, const EspNowMessage& msg, size_t len)> messageCallback;
+    std::function<void(const uint8_t* mac, const EspNowMessage& msg)> pairingCallback;
     std::function<void(const String& nodeId)> sendErrorCallback;
 
+    // Receive callbacks only copy frames into rxRing; loop() drains it
+    static constexpr size_t RX_RING_SLOTS = 16;
+    SpscRing<RxFrame, RX_RING_SLOTS> rxRing;
+    uint32_t rxDroppedReported = 0;
+    void enqueueReceive(const uint8_t* mac, int8_t rssi, const uint8_t* data, int len);
+    void drainReceived();
+    // Known peers in constant time; unknown senders only with pairing frames
+    // while the join window is open, rate limited
+    AdmissionFilter admission;
+    StageLatency decodeLatency;
+    bool admit(const RxFrame& frame);
+
     void handleEspNowReceive(const uint8_t* mac, const uint8_t* data, int len);
     void processReceivedData(const uint8_t* mac, const uint8_t* data, int len);
+    // Storage for the frame being handled; reused for every receive
+    MessageSlot rxSlot;
+    // Compact binary to peers that speak it, JSON to everyone else
+    bool sendSetLight(const uint8_t mac[6], const SetLightMessage& msg);
+    // Queue frame[FrameHeader::SIZE..], behind a header with the peer's next
+    // sequence number if the peer frames its own traffic
+    TxQueue::Handle sendFramed(const uint8_t mac[6], uint8_t* frame, size_t payloadLen, MessageType type,
+                               uint32_t deadlineMs);
+
+    // Transmit scheduling: the send callback hands results to loop() through txDone
+    struct TxCompletion {
+        MacKey peer;
+        bool ok;
+    };
+    TxQueue txQueue;
+    SpscRing<TxCompletion, 16> txDone;
+    // Counted by the send callback, reported from loop()
+    std::atomic<uint32_t> txFailures{0};
+    std::atomic<uint32_t> txDoneLost{0};
+    uint32_t txFailuresReported = 0;
+    uint32_t txDoneLostReported = 0;
+    void pumpTx();
+    void drainTxCompletions();
+    TxQueue::Attempt transmit(const uint8_t mac[6], const uint8_t* data, size_t len);
+    void onTxFinished(MacKey peer, TxQueue::State state, uint8_t attempts);
+    AckCoalescer acks;
+    void sendAck(const uint8_t mac[6], uint16_t seq, uint8_t count);
+    PingScheduler pings;
+    void sendPing(MacKey peer);
+    uint16_t beaconSeq = 0;
+    // Broadcasts get no MAC-layer ack: each group command goes out this many
+    // times and nodes drop the copies by cmd_seq
+    static constexpr uint8_t GROUP_SENDS = 2;
+    uint8_t groupSeq = 0;
 
     // Peer persistence cache
     static constexpr const char* PREFS_NS = "peers";
     std::vector<String> peers; // stored as MAC strings
+    // The subset registered with the radio, least recently used evicted first
+    PeerSlots peerSlots;
+    bool acquirePeer(const uint8_t mac[6]);
+    bool registerPeer(const uint8_t mac[6]);
+    bool unregisterPeer(const uint8_t mac[6]);
     
-    // Connection quality tracking
-    std::map<String, PeerStats> peerStats;
+    // Connection quality tracking, keyed by packed MAC. Room for the whole
+    // fleet plus every sender the admission filter lets in to join (about
+    // 22 KB); when full, the stalest peer that is not a known tower is recycled.
+    MacTable<PeerStats, macTableSlots(MAX_FLEET_TOWERS + AdmissionFilter::MAX_JOINING)> peerStats;
+    PeerStats& statsFor(const uint8_t mac[6]);
 
 public:
+    // Moves any peer still registered on a fixed channel to channel 0. Peers
+    // on channel 0 follow the interface channel, so after this a channel
+    // change needs no per-peer work.
     void updatePeerChannels();
+
+    // WiFi channel change. Between begin and end nothing is sent: frames stay
+    // queued, then go out with their deadlines extended by the blackout.
+    void beginChannelChange();
+    void endChannelChange();
+    struct ChannelChangeStats {
+        uint32_t changes;
+        uint32_t lastBlackoutMs;
+        uint32_t maxBlackoutMs;
+        uint32_t lastHeldFrames;  // queued frames flushed after the last change
+    };
+    const ChannelChangeStats& getChannelChangeStats() const;
+
+private:
+    bool channelChanging = false;
+    uint32_t channelChangeStartMs = 0;
+    ChannelChangeStats channelStats = {};
 };
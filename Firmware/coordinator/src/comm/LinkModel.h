@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Arduino.h>
+#include "PeerTable.h"
+
+// Link quality of one peer, kept as integer EWMAs in a few fixed bytes.
+//
+//   RSSI          weight 1/8, from every received frame that reports one
+//   loss          weight 1/16 per frame the sender sent: each sequence gap
+//                 counts its missing frames as 1, the frame that arrived as 0
+//   TX failures   weight 1/16 per send attempt, from the send callback
+//   inter-arrival weight 1/8, with the mean deviation from it (weight 1/16,
+//                 as RFC 3550 smooths jitter) as the jitter estimate
+//
+// A high TX failure share is airtime spent on retries: the tower is too far
+// or too crowded and slows every other peer on the channel.
+struct LinkModel {
+    static constexpr int8_t RSSI_UNKNOWN = -127;  // the v1.0 receive callback has no RSSI
+    static constexpr uint32_t MAX_GAP_SAMPLES = 64;  // longer gaps are a restart, not loss
+
+    int16_t rssiQ4 = 0;        // dBm * 16
+    uint16_t lossQ16 = 0;      // share of the sender's frames that never arrived, * 65536
+    uint16_t txFailQ16 = 0;    // share of our send attempts that failed, * 65536
+    uint32_t intervalQ4 = 0;   // ms between frames * 16
+    uint32_t jitterQ4 = 0;     // ms * 16
+    uint32_t lastRxMs = 0;
+    bool hasRssi = false;
+    bool hasInterval = false;
+
+    void onReceive(int8_t rssi, uint32_t rxMs) {
+        if (rssi != RSSI_UNKNOWN) {
+            int16_t sample = (int16_t)(rssi * 16);
+            rssiQ4 = hasRssi ? (int16_t)(rssiQ4 + (sample - rssiQ4) / 8) : sample;
+            hasRssi = true;
+        }
+        if (lastRxMs != 0) {
+            uint32_t sample = (rxMs - lastRxMs) * 16;
+            if (!hasInterval) {
+                intervalQ4 = sample;
+                hasInterval = true;
+            } else {
+                uint32_t dev = sample > intervalQ4 ? sample - intervalQ4 : intervalQ4 - sample;
+                jitterQ4 = (uint32_t)((int64_t)jitterQ4 + ((int64_t)dev - jitterQ4) / 16);
+                intervalQ4 = (uint32_t)((int64_t)intervalQ4 + ((int64_t)sample - intervalQ4) / 8);
+            }
+        }
+        lastRxMs = rxMs ? rxMs : 1;
+    }
+
+    // A framed frame was accepted after 'gap' sequence numbers went missing
+    void onSequence(uint32_t gap) {
+        if (gap > MAX_GAP_SAMPLES) gap = MAX_GAP_SAMPLES;
+        for (uint32_t i = 0; i < gap; i++) lossQ16 = ewma16(lossQ16, 0xFFFF);
+        lossQ16 = ewma16(lossQ16, 0);
+    }
+
+    void onTxAttempt(bool ok) { txFailQ16 = ewma16(txFailQ16, ok ? 0 : 0xFFFF); }
+
+    float rssi() const { return hasRssi ? rssiQ4 / 16.0f : (float)RSSI_UNKNOWN; }
+    float loss() const { return lossQ16 / 65535.0f; }
+    float txFailure() const { return txFailQ16 / 65535.0f; }
+    uint32_t intervalMs() const { return intervalQ4 / 16; }
+    uint32_t jitterMs() const { return jitterQ4 / 16; }
+
+private:
+    static uint16_t ewma16(uint16_t avg, uint16_t sample) {
+        return (uint16_t)((int32_t)avg + ((int32_t)sample - avg) / 16);
+    }
+};
+
+// One row of the link report, in the units it is published in
+struct LinkSnapshot {
+    MacKey peer;
+    int16_t rssiDeci;        // dBm * 10, LinkModel::RSSI_UNKNOWN * 10 if never reported
+    uint16_t lossPermille;
+    uint16_t txFailPermille;
+    uint32_t intervalMs;
+    uint32_t jitterMs;
+    uint32_t ageMs;          // since the last frame from the peer
+
+    static LinkSnapshot of(MacKey peer, const LinkModel& m, uint32_t now) {
+        LinkSnapshot s;
+        s.peer = peer;
+        s.rssiDeci = m.hasRssi ? (int16_t)(m.rssiQ4 * 10 / 16) : (int16_t)(LinkModel::RSSI_UNKNOWN * 10);
+        s.lossPermille = (uint16_t)(((uint32_t)m.lossQ16 * 1000 + 32767) / 65535);
+        s.txFailPermille = (uint16_t)(((uint32_t)m.txFailQ16 * 1000 + 32767) / 65535);
+        s.intervalMs = m.intervalMs();
+        s.jitterMs = m.jitterMs();
+        s.ageMs = m.lastRxMs ? now - m.lastRxMs : UINT32_MAX;
+        return s;
+    }
+
+    // Worst first: airtime wasted on retries, then loss
+    static bool worse(const LinkSnapshot& a, const LinkSnapshot& b) {
+        if (a.txFailPermille != b.txFailPermille) return a.txFailPermille > b.txFailPermille;
+        return a.lossPermille > b.lossPermille;
+    }
+};
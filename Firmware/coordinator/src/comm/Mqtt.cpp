@@ -82,7 +82,9 @@ namespace {
 Mqtt::Mqtt() 
     : mqttClient(wifiClient)
     , brokerPort(DEFAULT_MQTT_PORT)
-    , wifiManager(nullptr) {
+    , wifiManager(nullptr)
+    , telemetryBatch(MQTT_MAX_PACKET_SIZE + 512, DEFAULT_BATCH_WINDOW_MS, MQTT_MAX_PACKET_SIZE)
+    , spool(spoolStore, "/spool") {
     mqttInstance = this;
 }
 
@@ -94,6 +96,13 @@ Mqtt::~Mqtt() {
 bool Mqtt::begin() {
     Logger::info("Initializing MQTT client...");
 
+    spoolReady = spoolStore.begin() && spool.begin();
+    if (spoolReady) {
+        Logger::info("Telemetry spool ready, %u segment(s) to replay", (unsigned)spool.segments());
+    } else {
+        Logger::warn("Telemetry spool unavailable: telemetry during outages will be lost");
+    }
+
     // Always derive coordId from WiFi MAC address (unique, deterministic)
     coordId = WiFi.macAddress();
     Logger::info("Coordinator ID set from MAC: %s", coordId.c_str());
@@ -137,6 +146,12 @@ bool Mqtt::begin() {
 }
 
 void Mqtt::loop() {
+    // Both run offline too: records written during an outage go to the spool
+    if (telemetryBatch.due(millis())) {
+        flushTowerTelemetry();
+    }
+    if (spoolReady) spool.poll(millis());
+
     bool wifiReady = wifiManager ? wifiManager->isConnected() : (WiFi.status() == WL_CONNECTED);
 
     if (!wifiReady) {
@@ -168,6 +183,15 @@ void Mqtt::loop() {
     }
 
     mqttClient.loop();
+
+    if (spoolReady && mqttClient.connected() && !spool.empty()) {
+        size_t n = spool.replay(millis(), [this](const char* topic, const char* payload) {
+            return mqttClient.publish(topic, payload);
+        });
+        if (n > 0 && spool.empty()) {
+            Logger::info("Telemetry spool replayed (%u records in total)", (unsigned)spool.counters().replayed);
+        }
+    }
     
     // Periodic heartbeat logging (every 60 seconds)
     MqttLogger::logHeartbeat(mqttClient.connected(), 60000);
@@ -228,11 +252,11 @@ void Mqtt::publishNodeStatus(const NodeStatusMessage& status) {
     doc["avg_g"] = status.avg_g;
     doc["avg_b"] = status.avg_b;
     doc["avg_w"] = status.avg_w;
-    doc["status_mode"] = status.status_mode.length() > 0 ? status.status_mode.c_str() : "idle";
+    doc["status_mode"] = status.status_mode != StatusMode::UNSET ? statusModeName(status.status_mode) : "idle";
     doc["temp_c"] = status.temperature;
     doc["button_pressed"] = status.button_pressed;
     doc["vbat_mv"] = status.vbat_mv;
-    doc["fw"] = status.fw.length() > 0 ? status.fw.c_str() : "";
+    doc["fw"] = status.fw.c_str();
     
     String payload;
     serializeJson(doc, payload);
@@ -808,7 +832,16 @@ void Mqtt::publishSerialLog(const String& message, const String& level, const St
 // ============================================================================
 
 void Mqtt::publishTowerTelemetry(const TowerTelemetryMessage& telemetry) {
-    if (!mqttClient.connected()) {
+    if (telemetryMode != TelemetryMode::BATCH) {
+        publishTowerTelemetryRecord(telemetry);
+    }
+    if (telemetryMode != TelemetryMode::PER_TOWER) {
+        batchTowerTelemetry(telemetry);
+    }
+}
+
+void Mqtt::publishTowerTelemetryRecord(const TowerTelemetryMessage& telemetry) {
+    if (!mqttClient.connected() && !spoolReady) {
         MqttLogger::logPublish("tower_telemetry", "", false, 0);
         return;
     }
@@ -819,7 +852,7 @@ void Mqtt::publishTowerTelemetry(const TowerTelemetryMessage& telemetry) {
     doc["ts"] = telemetry.ts / 1000;
     doc["farm_id"] = farmId;
     doc["coord_id"] = coordId.length() ? coordId : WiFi.macAddress();
-    doc["tower_id"] = telemetry.tower_id;
+    doc["tower_id"] = telemetry.tower_id.c_str();
     
     // Environmental sensors
     doc["air_temp_c"] = telemetry.air_temp_c;
@@ -832,16 +865,16 @@ void Mqtt::publishTowerTelemetry(const TowerTelemetryMessage& telemetry) {
     doc["light_brightness"] = telemetry.light_brightness;
     
     // System status
-    doc["status_mode"] = telemetry.status_mode.length() > 0 ? telemetry.status_mode : "idle";
+    doc["status_mode"] = telemetry.status_mode != StatusMode::UNSET ? statusModeName(telemetry.status_mode) : "idle";
     doc["vbat_mv"] = telemetry.vbat_mv;
-    doc["fw"] = telemetry.fw.length() > 0 ? telemetry.fw : "";
+    doc["fw"] = telemetry.fw.c_str();
     doc["uptime_s"] = telemetry.uptime_s;
     
     String payload;
     serializeJson(doc, payload);
     
     String topic = towerTelemetryTopic(telemetry.tower_id);
-    bool success = mqttClient.publish(topic.c_str(), payload.c_str());
+    bool success = publishOrSpool(topic, payload) == Delivery::SENT;
     
     MqttLogger::logPublish(topic, payload, success, payload.length());
     MqttLogger::logLatency("TowerTelemetry", startMs);
@@ -851,8 +884,107 @@ void Mqtt::publishTowerTelemetry(const TowerTelemetryMessage& telemetry) {
     }
 }
 
+void Mqtt::setTowerTelemetryMode(TelemetryMode mode, uint32_t windowMs) {
+    flushTowerTelemetry();
+    telemetryMode = mode;
+    batchWindowMs = windowMs ? windowMs : DEFAULT_BATCH_WINDOW_MS;
+    static const char* const names[] = { "per-tower", "batch", "per-tower + batch" };
+    Logger::info("Tower telemetry: %s (batch window %u ms, up to %u bytes)",
+                 names[(int)mode], (unsigned)batchWindowMs, (unsigned)telemetryBatchBudget());
+}
+
+// What a batch may serialize to: the packet less its fixed header, the topic
+// length and the topic
+size_t Mqtt::telemetryBatchBudget() const {
+    return MQTT_MAX_PACKET_SIZE - 5 - 2 - towerTelemetryBatchTopic().length();
+}
+
+void Mqtt::batchTowerTelemetry(const TowerTelemetryMessage& telemetry) {
+    // Rows instead of objects, like the link report: the keys are sent once, in "cols"
+    auto header = [this](JsonDocument& doc) {
+        doc["farm_id"] = farmId;
+        doc["coord_id"] = coordId.length() ? coordId : WiFi.macAddress();
+        JsonArray cols = doc.createNestedArray("cols");
+        cols.add("tower_id");
+        cols.add("ts");
+        cols.add("air_temp_c");
+        cols.add("humidity_pct");
+        cols.add("light_lux");
+        cols.add("pump_on");
+        cols.add("light_on");
+        cols.add("light_brightness");
+        cols.add("status_mode");
+        cols.add("vbat_mv");
+        cols.add("fw");
+        cols.add("uptime_s");
+    };
+    auto row = [&telemetry](JsonArray r) {
+        r.add(telemetry.tower_id);  // String: copied into the document
+        r.add(telemetry.ts / 1000);
+        r.add(telemetry.air_temp_c);
+        r.add(telemetry.humidity_pct);
+        r.add(telemetry.light_lux);
+        r.add(telemetry.pump_on);
+        r.add(telemetry.light_on);
+        r.add(telemetry.light_brightness);
+        r.add(telemetry.status_mode != StatusMode::UNSET ? statusModeName(telemetry.status_mode) : "idle");
+        r.add(telemetry.vbat_mv);
+        r.add(telemetry.fw);
+        r.add(telemetry.uptime_s);
+    };
+
+    uint32_t now = millis();
+    if (telemetryBatch.size() == 0) telemetryBatch.configure(batchWindowMs, telemetryBatchBudget());
+    TelemetryBatch::Add added = telemetryBatch.add(now, header, row);
+    if (added == TelemetryBatch::Add::FULL) {
+        // Send what we have and start over with this row
+        flushTowerTelemetry();
+        added = telemetryBatch.add(now, header, row);
+    }
+    if (added == TelemetryBatch::Add::TOO_LARGE) {
+        batchStats.dropped++;
+        Logger::warn("Tower telemetry for %s does not fit one MQTT packet", telemetry.tower_id.c_str());
+    }
+}
+
+void Mqtt::flushTowerTelemetry() {
+    if (telemetryBatch.size() == 0) return;
+    uint32_t startMs = millis();
+    String payload;
+    size_t rows = telemetryBatch.serialize(payload);
+    String topic = towerTelemetryBatchTopic();
+    Delivery d = publishOrSpool(topic, payload);
+    bool success = d == Delivery::SENT;
+    if (success) {
+        batchStats.records += rows;
+        batchStats.batches++;
+        batchStats.bytes += payload.length();
+    } else if (d == Delivery::SPOOLED) {
+        batchStats.spooled += rows;
+    } else {
+        batchStats.dropped += rows;
+    }
+
+    MqttLogger::logPublish(topic, payload, success, payload.length());
+    MqttLogger::logLatency("TowerTelemetryBatch", startMs);
+}
+
+// Publish now, or keep it on flash for replay when the broker is back. While
+// a backlog is still replaying, new records queue behind it so the broker
+// sees them in the order they were made.
+Mqtt::Delivery Mqtt::publishOrSpool(const String& topic, const String& payload) {
+    bool behind = spoolReady && !spool.empty();
+    if (!behind && mqttClient.connected() && mqttClient.publish(topic.c_str(), payload.c_str())) {
+        return Delivery::SENT;
+    }
+    if (spoolReady && spool.push(topic.c_str(), payload.c_str(), millis())) {
+        return Delivery::SPOOLED;
+    }
+    return Delivery::LOST;
+}
+
 void Mqtt::publishReservoirTelemetry(const ReservoirTelemetryMessage& telemetry) {
-    if (!mqttClient.connected()) {
+    if (!mqttClient.connected() && !spoolReady) {
         MqttLogger::logPublish("reservoir_telemetry", "", false, 0);
         return;
     }
@@ -881,14 +1013,14 @@ void Mqtt::publishReservoirTelemetry(const ReservoirTelemetryMessage& telemetry)
     doc["dosing_pump_nutrient_on"] = telemetry.dosing_pump_nutrient_on;
     
     // System status
-    doc["status_mode"] = telemetry.status_mode.length() > 0 ? telemetry.status_mode : "operational";
+    doc["status_mode"] = telemetry.status_mode != StatusMode::UNSET ? statusModeName(telemetry.status_mode) : "operational";
     doc["uptime_s"] = telemetry.uptime_s;
     
     String payload;
     serializeJson(doc, payload);
     
     String topic = reservoirTelemetryTopic();
-    bool success = mqttClient.publish(topic.c_str(), payload.c_str());
+    bool success = publishOrSpool(topic, payload) == Delivery::SENT;
     
     MqttLogger::logPublish(topic, payload, success, payload.length());
     MqttLogger::logLatency("ReservoirTelemetry", startMs);
@@ -898,6 +1030,116 @@ void Mqtt::publishReservoirTelemetry(const ReservoirTelemetryMessage& telemetry)
     }
 }
 
+void Mqtt::publishLinkReport(const std::vector<LinkSnapshot>& links) {
+    if (!mqttClient.connected()) {
+        MqttLogger::logPublish("link_report", "", false, 0);
+        return;
+    }
+
+    uint32_t startMs = millis();
+    String topic = linkReportTopic();
+    // Stay inside one PubSubClient packet: fixed header, topic length, topic and room for "omitted"
+    const size_t budget = MQTT_MAX_PACKET_SIZE - 5 - 2 - topic.length() - 16;
+
+    // Rows instead of objects: the keys are sent once, in "cols"
+    DynamicJsonDocument doc(256 + links.size() * 160);
+    doc["ts"] = millis() / 1000;
+    doc["coord_id"] = coordId.length() ? coordId : WiFi.macAddress();
+    JsonArray cols = doc.createNestedArray("cols");
+    cols.add("mac");
+    cols.add("rssi_dbm10");
+    cols.add("loss_pm");
+    cols.add("tx_fail_pm");
+    cols.add("ivl_ms");
+    cols.add("jitter_ms");
+    cols.add("age_s");
+    doc["peers"] = links.size();
+    JsonArray rows = doc.createNestedArray("rows");
+    size_t shown = 0;
+    for (const LinkSnapshot& l : links) {
+        char mac[13];
+        snprintf(mac, sizeof(mac), "%012llX", (unsigned long long)l.peer);
+        JsonArray row = rows.createNestedArray();
+        row.add(mac);  // copied: 'mac' goes out of scope
+        row.add(l.rssiDeci);
+        row.add(l.lossPermille);
+        row.add(l.txFailPermille);
+        row.add(l.intervalMs);
+        row.add(l.jitterMs);
+        row.add(l.ageMs == UINT32_MAX ? -1 : (long)(l.ageMs / 1000));
+        if (measureJson(doc) > budget) {
+            rows.remove(rows.size() - 1);
+            break;
+        }
+        shown++;
+    }
+    if (shown < links.size()) doc["omitted"] = links.size() - shown;
+
+    String payload;
+    serializeJson(doc, payload);
+    bool success = mqttClient.publish(topic.c_str(), payload.c_str());
+
+    MqttLogger::logPublish(topic, payload, success, payload.length());
+    MqttLogger::logLatency("LinkReport", startMs);
+}
+
+void Mqtt::publishTowerHistory(const String& towerId, const std::vector<TowerHistory::Sample>& samples, uint32_t nowS) {
+    if (!mqttClient.connected()) {
+        MqttLogger::logPublish("tower_history", "", false, 0);
+        return;
+    }
+
+    uint32_t startMs = millis();
+    String topic = towerHistoryTopic(towerId);
+    // One PubSubClient packet per part: fixed header, topic length, topic and room for "last"
+    const size_t budget = MQTT_MAX_PACKET_SIZE - 5 - 2 - topic.length() - 16;
+    DynamicJsonDocument doc(MQTT_MAX_PACKET_SIZE + 512);
+    size_t next = 0;
+    uint16_t part = 0;
+    do {
+        doc.clear();
+        doc["tower_id"] = towerId;
+        doc["coord_id"] = coordId.length() ? coordId : WiFi.macAddress();
+        doc["part"] = part;
+        doc["samples"] = samples.size();
+        JsonArray cols = doc.createNestedArray("cols");
+        cols.add("age_s");
+        cols.add("air_temp_c");
+        cols.add("humidity_pct");
+        cols.add("light_lux");
+        cols.add("pump_on");
+        cols.add("light_on");
+        JsonArray rows = doc.createNestedArray("rows");
+        size_t shown = 0;
+        for (; next < samples.size(); next++) {
+            const TowerHistory::Sample& s = samples[next];
+            JsonArray row = rows.createNestedArray();
+            row.add(nowS - s.timeS);
+            if (isnan(s.airTempC)) row.add(nullptr); else row.add(s.airTempC);
+            if (isnan(s.humidityPct)) row.add(nullptr); else row.add(s.humidityPct);
+            if (isnan(s.lightLux)) row.add(nullptr); else row.add(s.lightLux);
+            row.add((s.actuators & TowerHistory::PUMP_ON) != 0);
+            row.add((s.actuators & TowerHistory::LIGHT_ON) != 0);
+            if (shown > 0 && (doc.overflowed() || measureJson(doc) > budget)) {
+                rows.remove(rows.size() - 1);
+                break;
+            }
+            shown++;
+        }
+        if (next >= samples.size()) doc["last"] = true;
+
+        String payload;
+        serializeJson(doc, payload);
+        bool success = mqttClient.publish(topic.c_str(), payload.c_str());
+        MqttLogger::logPublish(topic, payload, success, payload.length());
+        if (!success) break;
+        part++;
+        mqttClient.loop();  // let the socket drain between parts
+    } while (next < samples.size());
+
+    MqttLogger::logLatency("TowerHistory", startMs);
+}
+
 // ============================================================================
 // Topic Builders - Hydroponic structure: farm/{farmId}/coord/{coordId}/...
 // ============================================================================
@@ -933,6 +1175,21 @@ String Mqtt::reservoirTelemetryTopic() const {
     return "farm/" + farmId + "/coord/" + id + "/reservoir/telemetry";
 }
 
+String Mqtt::towerTelemetryBatchTopic() const {
+    String id = coordId.length() ? coordId : WiFi.macAddress();
+    return "farm/" + farmId + "/coord/" + id + "/towers/telemetry";
+}
+
+String Mqtt::towerHistoryTopic(const String& towerId) const {
+    String id = coordId.length() ? coordId : WiFi.macAddress();
+    return "farm/" + farmId + "/coord/" + id + "/tower/" + towerId + "/history";
+}
+
+String Mqtt::linkReportTopic() const {
+    String id = coordId.length() ? coordId : WiFi.macAddress();
+    return "farm/" + farmId + "/coord/" + id + "/links";
+}
+
 String Mqtt::towerCmdTopic(const String& towerId) const {
     String id = coordId.length() ? coordId : WiFi.macAddress();
     return "farm/" + farmId + "/coord/" + id + "/tower/" + towerId + "/cmd";
@@ -2,14 +2,20 @@
 
 #include <Arduino.h>
 #include <PubSubClient.h>
+#include <ArduinoJson.h>
 #include <WiFi.h>
 #include <map>
 #include <functional>
 #include "../Models.h"
 #include "../sensors/ThermalControl.h" // for NodeThermalData
 #include "WifiManager.h"
+#include "LinkModel.h"
+#include "TelemetrySpool.h"
+#include "TelemetryBatch.h"
+#include "../towers/TowerHistory.h"
 #include "../../shared/src/EspNowMessage.h"
 #include "../../shared/src/ConfigStore.h"
+#include "../../shared/src/utils/SafeTimer.h"
 
 class Mqtt {
 public:
@@ -29,8 +35,39 @@ public:
     
     // Publishing methods - Hydroponic System
     void publishTowerTelemetry(const TowerTelemetryMessage& telemetry);
+
+    // Where tower telemetry goes: one message per record on the tower's own
+    // topic (what the backend subscribes to today), and/or rows collected for
+    // up to windowMs and published as one document on .../towers/telemetry.
+    // A batch also goes out early when the next row would not fit one
+    // PubSubClient packet (see TelemetryBatch.h).
+    enum class TelemetryMode : uint8_t { PER_TOWER, BATCH, BOTH };
+    struct TelemetryBatchStats {
+        uint32_t records;   // rows published in batches
+        uint32_t batches;
+        uint32_t bytes;
+        uint32_t spooled;   // rows in batches kept for replay: not connected
+        uint32_t dropped;   // rows lost: a row larger than a packet, or no spool
+    };
+    static constexpr uint32_t DEFAULT_BATCH_WINDOW_MS = 1000;
+    void setTowerTelemetryMode(TelemetryMode mode, uint32_t windowMs = DEFAULT_BATCH_WINDOW_MS);
+    TelemetryMode getTowerTelemetryMode() const { return telemetryMode; }
+    void flushTowerTelemetry();
+    const TelemetryBatchStats& getTelemetryBatchStats() const { return batchStats; }
+
+    // Telemetry published while the broker is unreachable is spooled to flash
+    // (see TelemetrySpool.h) and replayed after reconnecting at this rate
+    typedef TelemetrySpool<LittleFsStore> Spool;
+    void setSpoolReplayRate(uint16_t recordsPerSecond) { spool.setReplayRate(recordsPerSecond); }
+    bool isSpoolReady() const { return spoolReady; }
+    const Spool::Counters& getSpoolCounters() const { return spool.counters(); }
     void publishReservoirTelemetry(const ReservoirTelemetryMessage& telemetry);
     void publishOtaStatus(const String& status, int progress, const String& message, const String& error = "");
+    // One document, one row per peer, worst first; rows past the packet size are counted, not sent
+    void publishLinkReport(const std::vector<LinkSnapshot>& links);
+    // Backfill from the coordinator's history, oldest first, split over as many
+    // packets as it takes; the last one carries "last": true
+    void publishTowerHistory(const String& towerId, const std::vector<TowerHistory::Sample>& samples, uint32_t nowS);
     
     // Publishing methods - Pairing events (coordinator -> backend)
     void publishPairingRequest(const String& towerId, const String& macAddress, int rssi, const String& fwVersion);
@@ -83,6 +120,18 @@ private:
     uint32_t lastDiagPrintMs = 0;
     bool loopbackHintPrinted = false;
     bool announcePublished = false;
+
+    // Tower telemetry batch being collected (see setTowerTelemetryMode)
+    TelemetryMode telemetryMode = TelemetryMode::PER_TOWER;
+    uint32_t batchWindowMs = DEFAULT_BATCH_WINDOW_MS;
+    TelemetryBatch telemetryBatch;
+    TelemetryBatchStats batchStats = {};
+
+    LittleFsStore spoolStore;
+    Spool spool;
+    bool spoolReady = false;
+    enum class Delivery : uint8_t { SENT, SPOOLED, LOST };
+    Delivery publishOrSpool(const String& topic, const String& payload);
     
     bool connectMqtt();
     bool ensureConfigLoaded();
@@ -97,10 +146,16 @@ private:
     const char* describeMqttState(int8_t state) const;
     void warnIfLoopbackHost();
     void runReachabilityProbe();
+    void publishTowerTelemetryRecord(const TowerTelemetryMessage& telemetry);
+    void batchTowerTelemetry(const TowerTelemetryMessage& telemetry);
+    size_t telemetryBatchBudget() const;
 
     // Topic builders - Hydroponic structure: farm/{farmId}/coord/{coordId}/...
     String towerTelemetryTopic(const String& towerId) const;
+    String towerTelemetryBatchTopic() const;
     String reservoirTelemetryTopic() const;
+    String linkReportTopic() const;
+    String towerHistoryTopic(const String& towerId) const;
     String coordinatorTelemetryTopic() const;
     String coordinatorCmdTopic() const;
     String coordinatorSerialTopic() const;
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Arduino.h>
+#include "PeerTable.h"
+
+// Which towers are registered with the radio right now.
+//
+// ESP-NOW only holds about 20 unicast peers, fewer than a large rack has
+// towers. EspNow keeps the full tower list in software and registers a peer
+// just before sending to it; when every slot is taken the least recently
+// used peer is unregistered to make room. Peers with a frame in flight are
+// never evicted, since the send callback for it is still to come.
+class PeerSlots {
+public:
+    static constexpr size_t SLOTS = 16;  // leaves room for broadcast and the radio's own limit of 20
+
+    struct Counters {
+        uint32_t hits;       // already registered when needed
+        uint32_t misses;     // registered on demand
+        uint32_t evictions;  // unregistered to make room
+        uint32_t failures;   // could not be registered
+    };
+
+    PeerSlots() : count(0), clock(0) { memset(&totals, 0, sizeof(totals)); }
+
+    // Make sure 'peer' is registered before a send. add(mac) and del(mac)
+    // register and unregister one peer with the radio and return true on
+    // success; busy(peer) says whether a peer still has a frame in flight.
+    // False if it could not be registered.
+    template <typename Add, typename Del, typename Busy>
+    bool acquire(MacKey peer, Add add, Del del, Busy busy) {
+        Slot* s = find(peer);
+        if (s) {
+            s->lastUse = ++clock;
+            totals.hits++;
+            return true;
+        }
+        totals.misses++;
+        if (count == SLOTS && !evictOne(del, busy)) {
+            totals.failures++;
+            return false;
+        }
+        uint8_t mac[6];
+        macFromKey(peer, mac);
+        if (!add(mac)) {
+            totals.failures++;
+            return false;
+        }
+        slots[count].peer = peer;
+        slots[count].lastUse = ++clock;
+        count++;
+        return true;
+    }
+
+    // Unregister 'peer' if it is registered; true if it was
+    template <typename Del>
+    bool release(MacKey peer, Del del) {
+        Slot* s = find(peer);
+        if (!s) return false;
+        uint8_t mac[6];
+        macFromKey(peer, mac);
+        del(mac);
+        *s = slots[--count];
+        return true;
+    }
+
+    // The radio no longer has 'peer' (or anything, after clear()): forget
+    // without calling del
+    void forget(MacKey peer) {
+        Slot* s = find(peer);
+        if (s) *s = slots[--count];
+    }
+    void clear() { count = 0; }
+
+    bool registered(MacKey peer) const {
+        for (size_t i = 0; i < count; i++) {
+            if (slots[i].peer == peer) return true;
+        }
+        return false;
+    }
+
+    // Calls f(peer) for every registered peer
+    template <typename F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < count; i++) f(slots[i].peer);
+    }
+
+    size_t size() const { return count; }
+    const Counters& counters() const { return totals; }
+
+private:
+    struct Slot {
+        MacKey peer;
+        uint32_t lastUse;
+    };
+    Slot slots[SLOTS];
+    size_t count;
+    uint32_t clock;  // bumped on every use; a larger lastUse is more recent
+    Counters totals;
+
+    Slot* find(MacKey peer) {
+        for (size_t i = 0; i < count; i++) {
+            if (slots[i].peer == peer) return &slots[i];
+        }
+        return nullptr;
+    }
+
+    template <typename Del, typename Busy>
+    bool evictOne(Del del, Busy busy) {
+        Slot* lru = nullptr;
+        for (size_t i = 0; i < count; i++) {
+            if (busy(slots[i].peer)) continue;
+            if (!lru || (int32_t)(slots[i].lastUse - lru->lastUse) < 0) lru = &slots[i];
+        }
+        if (!lru) return false;
+        uint8_t mac[6];
+        macFromKey(lru->peer, mac);
+        if (!del(mac)) return false;
+        *lru = slots[--count];
+        totals.evictions++;
+        return true;
+    }
+};
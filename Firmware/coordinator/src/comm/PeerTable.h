@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Arduino.h>
+
+// A MAC address packed into the low 48 bits, first byte most significant
+typedef uint64_t MacKey;
+
+inline MacKey macKey(const uint8_t mac[6]) {
+    return ((MacKey)mac[0] << 40) | ((MacKey)mac[1] << 32) | ((MacKey)mac[2] << 24) |
+           ((MacKey)mac[3] << 16) | ((MacKey)mac[4] << 8) | (MacKey)mac[5];
+}
+
+inline void macFromKey(MacKey key, uint8_t mac[6]) {
+    for (int i = 5; i >= 0; i--) { mac[i] = (uint8_t)key; key >>= 8; }
+}
+
+// Parses "AA:BB:CC:DD:EE:FF" (either case) without sscanf or a temporary String
+inline bool macKeyFromString(const char* s, MacKey& out) {
+    MacKey key = 0;
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 2; j++) {
+            char c = *s++;
+            uint8_t v;
+            if (c >= '0' && c <= '9') v = c - '0';
+            else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+            else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+            else return false;
+            key = (key << 4) | v;
+        }
+        if (i < 5 && *s++ != ':') return false;
+    }
+    if (*s != '\0') return false;
+    out = key;
+    return true;
+}
+
+// Log a MAC straight from its bytes: Logger::debug("RX from " MAC_FMT, MAC_ARGS(mac))
+#define MAC_FMT "%02X:%02X:%02X:%02X:%02X:%02X"
+#define MAC_ARGS(m) (m)[0], (m)[1], (m)[2], (m)[3], (m)[4], (m)[5]
+
+// Most towers one coordinator serves. Every per-peer table (known peers,
+// stats, pings, pending acks) is sized from this, so a tower that is let in
+// also has a slot everywhere else.
+static constexpr size_t MAX_FLEET_TOWERS = 96;
+
+// Slots a MacTable needs for n entries: the smallest power of two whose 3/4
+// fill limit reaches n
+constexpr size_t macTableSlots(size_t n, size_t slots = 4) {
+    return slots - slots / 4 >= n ? slots : macTableSlots(n, slots * 2);
+}
+
+// Fixed-capacity open-addressing hash table keyed by MacKey.
+// Linear probing over N slots (a power of two), filled to at most 3/4 so
+// probes stay short; erase() shifts the probe run back instead of leaving
+// tombstones. Lives entirely inside the owning object: no heap, no rehash.
+template <typename V, size_t N>
+class MacTable {
+    static_assert(N >= 4 && (N & (N - 1)) == 0, "MacTable size must be a power of two");
+public:
+    static constexpr size_t MAX_ENTRIES = N - N / 4;
+
+    MacTable() { clear(); }
+
+    V* find(MacKey key) {
+        size_t i = indexOf(key);
+        return i == NOT_FOUND ? nullptr : &slots[i].value;
+    }
+    const V* find(MacKey key) const {
+        size_t i = indexOf(key);
+        return i == NOT_FOUND ? nullptr : &slots[i].value;
+    }
+
+    // Existing entry, or a value-initialised new one; nullptr when full
+    V* insert(MacKey key) {
+        for (size_t i = home(key);; i = (i + 1) & (N - 1)) {
+            if (slots[i].key == key) return &slots[i].value;
+            if (slots[i].key == EMPTY) {
+                if (count >= MAX_ENTRIES) return nullptr;
+                slots[i].key = key;
+                slots[i].value = V();
+                count++;
+                return &slots[i].value;
+            }
+        }
+    }
+
+    bool erase(MacKey key) {
+        size_t hole = indexOf(key);
+        if (hole == NOT_FOUND) return false;
+        // Pull later members of the probe run back so find() never stops early
+        for (size_t i = (hole + 1) & (N - 1); slots[i].key != EMPTY; i = (i + 1) & (N - 1)) {
+            size_t h = home(slots[i].key);
+            bool reachable = (hole <= i) ? (h <= hole || h > i) : (h <= hole && h > i);
+            if (reachable) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole].key = EMPTY;
+        count--;
+        return true;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < N; i++) slots[i].key = EMPTY;
+        count = 0;
+    }
+
+    // Calls f(key, value) for every entry, in slot order
+    template <typename F>
+    void forEach(F f) {
+        for (size_t i = 0; i < N; i++) {
+            if (slots[i].key != EMPTY) f(slots[i].key, slots[i].value);
+        }
+    }
+    template <typename F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < N; i++) {
+            if (slots[i].key != EMPTY) f(slots[i].key, slots[i].value);
+        }
+    }
+
+    size_t size() const { return count; }
+    bool full() const { return count >= MAX_ENTRIES; }
+    static constexpr size_t capacity() { return MAX_ENTRIES; }
+
+private:
+    static constexpr MacKey EMPTY = ~(MacKey)0; // outside the 48-bit range
+    static constexpr size_t NOT_FOUND = ~(size_t)0;
+
+    struct Slot {
+        MacKey key;
+        V value;
+    };
+    Slot slots[N];
+    size_t count;
+
+    // Fibonacci hashing: the top bits of key * 2^64/phi spread sequential MACs
+    static size_t home(MacKey key) {
+        return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 40) & (N - 1);
+    }
+
+    size_t indexOf(MacKey key) const {
+        for (size_t i = home(key);; i = (i + 1) & (N - 1)) {
+            if (slots[i].key == key) return i;
+            if (slots[i].key == EMPTY) return NOT_FOUND;
+        }
+    }
+};
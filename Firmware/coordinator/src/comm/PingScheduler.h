@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Arduino.h>
+#include "PeerTable.h"
+
+// Adaptive, spread-out liveness pings.
+//
+// A peer heard from within half the stale threshold needs no ping: its own
+// traffic proves the link. Past that it is pinged URGENT_PINGS times before it
+// would be declared stale; once stale (or never heard) it gets a slow probe
+// every interval. Pings leave one at a time, at least the shorter of the two
+// periods / watched apart, so a whole fleet is spread out instead of sent in
+// a burst.
+class PingScheduler {
+public:
+    static constexpr size_t SLOTS = macTableSlots(MAX_FLEET_TOWERS);
+    static constexpr uint8_t URGENT_PINGS = 3;  // in the second half of the stale threshold
+    static constexpr uint32_t DEFAULT_INTERVAL_MS = 2000;
+    static constexpr uint32_t DEFAULT_STALE_MS = 6000;
+
+    struct Counters {
+        uint32_t sent;     // pings handed to send()
+        uint32_t skipped;  // due, but the peer had been heard from recently
+    };
+
+    PingScheduler() : intervalMs(DEFAULT_INTERVAL_MS), staleMs(DEFAULT_STALE_MS), lastPingMs(0) {
+        memset(&totals, 0, sizeof(totals));
+    }
+
+    void configure(uint32_t interval, uint32_t stale) {
+        intervalMs = interval > 0 ? interval : 1;
+        staleMs = stale;
+    }
+
+    // Start pinging 'peer'; checked on the next poll. False when the table is full.
+    bool watch(MacKey peer, uint32_t now) {
+        if (table.find(peer)) return true;
+        Entry* e = table.insert(peer);
+        if (!e) return false;
+        e->dueMs = now;
+        return true;
+    }
+    void unwatch(MacKey peer) { table.erase(peer); }
+    bool watching(MacKey peer) const { return table.find(peer) != nullptr; }
+
+    // Sends at most one ping per call. lastSeen(peer) is the peer's last
+    // receive time in ms (0 = never); send(peer) queues the ping.
+    template <typename LastSeen, typename Send>
+    void poll(uint32_t now, LastSeen lastSeen, Send send) {
+        if (table.size() == 0) return;
+        uint32_t period = urgentMs() < intervalMs ? urgentMs() : intervalMs;
+        bool gapOpen = lastPingMs == 0 || now - lastPingMs >= period / table.size();
+        MacKey next = 0;
+        Entry* nextEntry = nullptr;
+        uint32_t nextAge = 0;
+        table.forEach([&](MacKey peer, Entry& e) {
+            if ((int32_t)(now - e.dueMs) < 0) return;
+            uint32_t seen = lastSeen(peer);
+            if (seen != 0 && now - seen < staleMs / 2) {
+                e.dueMs = seen + staleMs / 2;  // look again when it could start going stale
+                totals.skipped++;
+                return;
+            }
+            // Most overdue first
+            if (gapOpen && (!nextEntry || (int32_t)(e.dueMs - nextEntry->dueMs) < 0)) {
+                next = peer;
+                nextEntry = &e;
+                nextAge = seen != 0 ? now - seen : UINT32_MAX;
+            }
+        });
+        if (!nextEntry) return;
+        send(next);
+        totals.sent++;
+        lastPingMs = now != 0 ? now : 1;
+        nextEntry->dueMs = now + (nextAge < staleMs ? urgentMs() : intervalMs);
+    }
+
+    size_t watched() const { return table.size(); }
+    const Counters& counters() const { return totals; }
+
+private:
+    struct Entry {
+        uint32_t dueMs;  // next time to look at this peer
+    };
+    MacTable<Entry, SLOTS> table;
+    uint32_t intervalMs;
+    uint32_t staleMs;
+    uint32_t lastPingMs;  // 0 = none yet
+    Counters totals;
+
+    uint32_t urgentMs() const { return staleMs / 2 / URGENT_PINGS; }
+};
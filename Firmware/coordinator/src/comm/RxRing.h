@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "../../shared/src/EspNowMessage.h"
+
+// One received ESP-NOW frame, copied out of the driver's buffer as-is
+struct RxFrame {
+    uint8_t mac[6];
+    int8_t rssi;
+    uint8_t len;
+    uint32_t rxMs;
+    uint8_t data[WireConstants::MAX_FRAME_LEN];
+};
+
+// Fixed-size single-producer/single-consumer ring.
+// The producer (the ESP-NOW receive callback, in the WiFi task) claims a slot,
+// fills it and publishes it; the consumer (EspNow::loop) peeks and pops in
+// order. Neither side locks or allocates. When the ring is full the producer
+// drops the new item and counts it, so a slow consumer never stalls the radio.
+// N must be a power of two; one slot is never used, so N - 1 items fit.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+public:
+    SpscRing() : head(0), tail(0), pushedCount(0), droppedCount(0), highWater(0) {}
+
+    // Producer: slot to fill, or nullptr (and a drop counted) when full
+    T* claim() {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t used = h - tail.load(std::memory_order_acquire);
+        if (used >= N - 1) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        if (used + 1 > highWater.load(std::memory_order_relaxed)) {
+            highWater.store(used + 1, std::memory_order_relaxed);
+        }
+        return &slots[h & (N - 1)];
+    }
+
+    // Producer: make the claimed slot visible to the consumer
+    void publish() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        pushedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool push(const T& item) {
+        T* slot = claim();
+        if (!slot) return false;
+        *slot = item;
+        publish();
+        return true;
+    }
+
+    // Consumer: oldest published item, valid until pop()
+    const T* peek() const {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return nullptr;
+        return &slots[t & (N - 1)];
+    }
+
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    static constexpr size_t capacity() { return N - 1; }
+    uint32_t getPushedCount() const { return pushedCount.load(std::memory_order_relaxed); }
+    uint32_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+    uint32_t getHighWater() const { return highWater.load(std::memory_order_relaxed); }
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head;   // written by the producer only
+    std::atomic<uint32_t> tail;   // written by the consumer only
+    std::atomic<uint32_t> pushedCount;
+    std::atomic<uint32_t> droppedCount;
+    std::atomic<uint32_t> highWater;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Tower telemetry rows collected into one MQTT document for .../towers/telemetry:
+//
+//   {<header>, "rows": [[...], [...]], "n": <rows>}
+//
+// The serialized size is kept up to date as rows go in: the header is measured
+// once when a batch starts and every row on its own, so adding a row costs the
+// same however full the batch already is. A row that would take the document
+// past the packet budget is refused, and the caller publishes and starts over.
+// A batch is due windowMs after its first row.
+class TelemetryBatch {
+public:
+    enum class Add : uint8_t {
+        ADDED,
+        FULL,       // not added: publish the batch, then add the row again
+        TOO_LARGE   // not added: the row alone does not fit the budget
+    };
+
+    TelemetryBatch(size_t docCapacity, uint32_t windowMs, size_t budgetBytes)
+        : doc(docCapacity), windowMs(windowMs), budget(budgetBytes) {}
+
+    void configure(uint32_t window, size_t budgetBytes) {
+        windowMs = window;
+        budget = budgetBytes;
+    }
+
+    // header(JsonDocument&) writes the fields before "rows" when a batch
+    // starts; row(JsonArray) writes the row's values
+    template <typename Header, typename Row>
+    Add add(uint32_t now, Header header, Row row) {
+        if (rows == 0) begin(now, header);
+        JsonArray all = doc["rows"];
+        JsonArray r = all.createNestedArray();
+        row(r);
+        size_t rowBytes = measureJson(r) + (rows ? 1 : 0);  // comma before all but the first
+        if (doc.overflowed() || bodyBytes + rowBytes + countBytes(rows + 1) > budget) {
+            all.remove(all.size() - 1);
+            if (rows == 0) {
+                doc.clear();
+                return Add::TOO_LARGE;
+            }
+            return Add::FULL;
+        }
+        bodyBytes += rowBytes;
+        rows++;
+        return Add::ADDED;
+    }
+
+    bool due(uint32_t now) const { return rows > 0 && now - firstMs >= windowMs; }
+    size_t size() const { return rows; }
+    // Length of the document serialize() will produce
+    size_t bytes() const { return rows ? bodyBytes + countBytes(rows) : 0; }
+
+    // The finished document; the batch is empty afterwards. Returns its row count.
+    size_t serialize(String& out) {
+        size_t n = rows;
+        if (n == 0) return 0;
+        doc["n"] = n;
+        serializeJson(doc, out);
+        doc.clear();
+        rows = 0;
+        bodyBytes = 0;
+        return n;
+    }
+
+private:
+    DynamicJsonDocument doc;
+    uint32_t windowMs;
+    size_t budget;
+    size_t rows = 0;
+    size_t bodyBytes = 0;  // document without "n"
+    uint32_t firstMs = 0;
+
+    template <typename Header>
+    void begin(uint32_t now, Header header) {
+        doc.clear();
+        header(doc);
+        doc.createNestedArray("rows");
+        bodyBytes = measureJson(doc);
+        firstMs = now;
+    }
+
+    // ,"n":<rows>
+    static size_t countBytes(size_t n) {
+        size_t digits = 1;
+        while (n >= 10) {
+            n /= 10;
+            digits++;
+        }
+        return 5 + digits;
+    }
+};
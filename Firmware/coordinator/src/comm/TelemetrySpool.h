@@ -0,0 +1,345 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../../shared/src/FrameHeader.h"  // crc16
+
+// Store-and-forward for MQTT publishes made while the broker is unreachable.
+//
+// An append-only log of segment files, "<dir>/<id as 8 hex digits>.seg", ids
+// counting up. Each record is
+//
+//   0  MAGIC (0x5A)
+//   1  topic length   uint8
+//   2  payload length uint16 LE
+//   4  topic, payload
+//   .  crc16          uint16 LE over everything before it
+//
+// Flash wear is bounded three ways: records reach flash in WRITE_BUFFER
+// chunks (or after FLUSH_MS), files are only ever appended to and deleted,
+// and at most MAX_SEGMENTS exist; a full spool deletes its oldest segment.
+//
+// Crash safety: begin() rebuilds the state from the file names alone. A
+// segment that ends in a torn record (power lost mid-append) is never
+// appended to again; replay stops reading it at the first bad record. The
+// replay position lives in RAM, so after a reboot the first segment is
+// replayed from its start: delivery is at-least-once.
+//
+// Replay is rate limited (records per second, token bucket) so a backlog
+// drains without one long burst. Mqtt spools new records too while a backlog
+// is left, to keep them in order, so the rate has to stay above the live
+// publish rate for the spool to empty.
+//
+// Fs supplies append/read/size/remove/mkdir and list(dir, fn(name)):
+// LittleFsStore below on the device, a RAM file system in the host test.
+template <typename Fs>
+class TelemetrySpool {
+public:
+    static constexpr size_t SEGMENT_BYTES = 16 * 1024;
+    static constexpr uint32_t MAX_SEGMENTS = 6;         // 96 KB, see LittleFsStore
+    static constexpr size_t WRITE_BUFFER = 1024;
+    static constexpr uint32_t FLUSH_MS = 5000;
+    static constexpr size_t MAX_TOPIC = 255;
+    static constexpr size_t MAX_PAYLOAD = 1024;         // PubSubClient's packet size
+    static constexpr uint16_t DEFAULT_REPLAY_PER_S = 5;
+    static constexpr uint8_t MAGIC = 0x5A;
+    static constexpr size_t OVERHEAD = 6;               // header and crc
+
+    struct Counters {
+        uint32_t spooled;
+        uint32_t replayed;
+        uint32_t rejected;          // too large for one record, or the write failed
+        uint32_t segmentsDropped;   // oldest segment deleted unreplayed: spool full
+        uint32_t tornRecords;       // bad records skipped during replay
+        uint32_t flushes;
+        uint32_t bytesWritten;
+    };
+
+    TelemetrySpool(Fs& fs, const char* dir) : fs(fs) {
+        strncpy(this->dir, dir, sizeof(this->dir) - 1);
+        this->dir[sizeof(this->dir) - 1] = '\0';
+        memset(&totals, 0, sizeof(totals));
+    }
+
+    // Rebuild from what is on flash. False when the directory is unusable.
+    bool begin() {
+        buffered = 0;
+        readOff = 0;
+        tokens = replayPerS;
+        refillMs = 0;
+        if (!fs.mkdir(dir)) return false;
+        bool any = false;
+        uint32_t first = 0, last = 0;
+        fs.list(dir, [&](const char* name) {
+            uint32_t id;
+            if (!parseName(name, id)) return;
+            if (!any || (int32_t)(id - first) < 0) first = id;
+            if (!any || (int32_t)(id - last) > 0) last = id;
+            any = true;
+        });
+        if (!any) {
+            readSeg = writeSeg = 0;
+            writeSize = 0;
+            return true;
+        }
+        readSeg = first;
+        writeSeg = last;
+        writeSize = fs.size(path(writeSeg));
+        // Appending after a torn record would hide everything behind it
+        if (validLength(writeSeg, writeSize) != writeSize) {
+            writeSeg++;
+            writeSize = 0;
+        }
+        return true;
+    }
+
+    // Queue one publish. False if it can never fit a record.
+    bool push(const char* topic, const char* payload, uint32_t now) {
+        size_t topicLen = strlen(topic);
+        size_t payloadLen = strlen(payload);
+        size_t len = OVERHEAD + topicLen + payloadLen;
+        if (topicLen > MAX_TOPIC || payloadLen > MAX_PAYLOAD || len > WRITE_BUFFER) {
+            totals.rejected++;
+            return false;
+        }
+        if (buffered + len > WRITE_BUFFER) flush();
+        if (writeSize + buffered + len > SEGMENT_BYTES) {
+            flush();
+            startSegment();
+        }
+        if (buffered == 0) firstBufferedMs = now;
+        uint8_t* r = writeBuf + buffered;
+        r[0] = MAGIC;
+        r[1] = (uint8_t)topicLen;
+        r[2] = (uint8_t)(payloadLen & 0xFF);
+        r[3] = (uint8_t)(payloadLen >> 8);
+        memcpy(r + 4, topic, topicLen);
+        memcpy(r + 4 + topicLen, payload, payloadLen);
+        uint16_t crc = crc16(r, len - 2);
+        r[len - 2] = (uint8_t)(crc & 0xFF);
+        r[len - 1] = (uint8_t)(crc >> 8);
+        buffered += len;
+        totals.spooled++;
+        return true;
+    }
+
+    // Write buffered records out; called from push() and poll()
+    void flush() {
+        if (buffered == 0) return;
+        if (fs.append(path(writeSeg), writeBuf, buffered)) {
+            writeSize += buffered;
+            totals.flushes++;
+            totals.bytesWritten += buffered;
+        } else {
+            // Whatever part did land is torn; write the next records elsewhere
+            totals.rejected++;
+            startSegment();
+        }
+        buffered = 0;
+    }
+
+    // Flush records that have waited FLUSH_MS
+    void poll(uint32_t now) {
+        if (buffered > 0 && now - firstBufferedMs >= FLUSH_MS) flush();
+    }
+
+    void setReplayRate(uint16_t recordsPerSecond) {
+        replayPerS = recordsPerSecond ? recordsPerSecond : 1;
+        if (tokens > replayPerS) tokens = replayPerS;
+    }
+    uint16_t replayRate() const { return replayPerS; }
+
+    // Hand spooled records, oldest first, to publish(topic, payload) as the
+    // rate allows. A record publish() refuses stays for the next call.
+    // Returns how many were published.
+    template <typename Publish>
+    size_t replay(uint32_t now, Publish publish) {
+        refill(now);
+        size_t n = 0;
+        while (tokens > 0) {
+            if (readSeg == writeSeg && readOff >= writeSize) {
+                if (buffered == 0) break;
+                flush();  // the newest records are still in RAM
+                continue;
+            }
+            size_t segSize = readSeg == writeSeg ? writeSize : fs.size(path(readSeg));
+            size_t len = readOff < segSize ? readRecord(readSeg, readOff, segSize) : 0;
+            if (len == 0) {
+                if (readOff < segSize) totals.tornRecords++;
+                finishSegment();
+                continue;
+            }
+            splitRecord();
+            if (!publish((const char*)readBuf + 4, (const char*)readBuf + 5 + readTopicLen)) break;
+            readOff += len;
+            // All caught up: nothing left on flash
+            if (readSeg == writeSeg && readOff >= writeSize && buffered == 0) finishSegment();
+            tokens--;
+            totals.replayed++;
+            n++;
+        }
+        return n;
+    }
+
+    bool empty() const { return buffered == 0 && readSeg == writeSeg && readOff >= writeSize; }
+    uint32_t segments() const { return writeSeg - readSeg + (writeSize > 0 || buffered > 0 ? 1 : 0); }
+    const Counters& counters() const { return totals; }
+
+private:
+    Fs& fs;
+    char dir[24];
+    char pathBuf[40];
+    uint32_t readSeg = 0;       // oldest segment, being replayed
+    size_t readOff = 0;
+    uint32_t writeSeg = 0;      // newest segment, being appended to
+    size_t writeSize = 0;
+    uint8_t writeBuf[WRITE_BUFFER];
+    size_t buffered = 0;
+    uint32_t firstBufferedMs = 0;
+    // A record, its topic and payload NUL-terminated in place for publish()
+    uint8_t readBuf[OVERHEAD + MAX_TOPIC + MAX_PAYLOAD + 2];
+    size_t readTopicLen = 0;
+    uint16_t replayPerS = DEFAULT_REPLAY_PER_S;
+    uint16_t tokens = DEFAULT_REPLAY_PER_S;
+    uint32_t refillMs = 0;
+    Counters totals;
+
+    const char* path(uint32_t id) {
+        snprintf(pathBuf, sizeof(pathBuf), "%s/%08lx.seg", dir, (unsigned long)id);
+        return pathBuf;
+    }
+
+    static bool parseName(const char* name, uint32_t& id) {
+        const char* base = strrchr(name, '/');
+        base = base ? base + 1 : name;
+        if (strlen(base) != 12 || strcmp(base + 8, ".seg") != 0) return false;
+        char* end = nullptr;
+        unsigned long v = strtoul(base, &end, 16);
+        if (end != base + 8) return false;
+        id = (uint32_t)v;
+        return true;
+    }
+
+    void startSegment() {
+        if (writeSize > 0 || fs.size(path(writeSeg)) > 0) {
+            writeSeg++;
+        }
+        writeSize = 0;
+        // Bounded: drop the oldest segment, replayed or not
+        while (writeSeg - readSeg >= MAX_SEGMENTS) {
+            fs.remove(path(readSeg));
+            readSeg++;
+            readOff = 0;
+            totals.segmentsDropped++;
+        }
+    }
+
+    // Replayed (or unreadable past readOff): delete it and move to the next
+    void finishSegment() {
+        fs.remove(path(readSeg));
+        readOff = 0;
+        if (readSeg == writeSeg) {
+            writeSize = 0;  // empty again; the id is reused
+            return;
+        }
+        readSeg++;
+    }
+
+    // Length of the valid record at 'off', read into readBuf; 0 if torn or corrupt
+    size_t readRecord(uint32_t seg, size_t off, size_t segSize) {
+        size_t want = segSize - off;
+        if (want > sizeof(readBuf) - 2) want = sizeof(readBuf) - 2;
+        size_t got = fs.read(path(seg), off, readBuf, want);
+        if (got < OVERHEAD || readBuf[0] != MAGIC) return 0;
+        size_t topicLen = readBuf[1];
+        size_t payloadLen = (size_t)readBuf[2] | ((size_t)readBuf[3] << 8);
+        size_t len = OVERHEAD + topicLen + payloadLen;
+        if (payloadLen > MAX_PAYLOAD || len > got) return 0;
+        uint16_t crc = (uint16_t)readBuf[len - 2] | (uint16_t)(readBuf[len - 1] << 8);
+        if (crc16(readBuf, len - 2) != crc) return 0;
+        readTopicLen = topicLen;
+        return len;
+    }
+
+    // Bytes of 'seg' that hold whole, valid records
+    size_t validLength(uint32_t seg, size_t segSize) {
+        size_t off = 0;
+        while (off < segSize) {
+            size_t len = readRecord(seg, off, segSize);
+            if (len == 0) break;
+            off += len;
+        }
+        return off;
+    }
+
+    // Turn the record in readBuf into two C strings, topic at readBuf + 4: the
+    // payload moves up one byte to make room for the topic's terminator
+    void splitRecord() {
+        size_t payloadLen = (size_t)readBuf[2] | ((size_t)readBuf[3] << 8);
+        uint8_t* payload = readBuf + 4 + readTopicLen;
+        memmove(payload + 1, payload, payloadLen);
+        payload[0] = '\0';
+        payload[1 + payloadLen] = '\0';
+    }
+
+    void refill(uint32_t now) {
+        if (refillMs == 0) {  // first replay: start with a full bucket
+            tokens = replayPerS;
+            refillMs = now ? now : 1;
+            return;
+        }
+        uint32_t added = (uint32_t)(((uint64_t)(now - refillMs) * replayPerS) / 1000);
+        if (added == 0) return;
+        tokens = (uint16_t)((tokens + added > replayPerS) ? replayPerS : tokens + added);
+        refillMs = now;
+    }
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <LittleFS.h>
+
+// TelemetrySpool's storage on the "spiffs" data partition, formatted as LittleFS.
+// platformio.ini sets no board_build.partitions, so that is the default
+// table's partition (about 1.4 MB on 4 MB flash), far more than the spool uses.
+struct LittleFsStore {
+    bool begin() { return LittleFS.begin(true); }  // format on first use
+
+    bool mkdir(const char* path) { return LittleFS.exists(path) || LittleFS.mkdir(path); }
+
+    bool append(const char* path, const uint8_t* data, size_t len) {
+        File f = LittleFS.open(path, FILE_APPEND);
+        if (!f) return false;
+        size_t written = f.write(data, len);
+        f.close();
+        return written == len;
+    }
+
+    size_t read(const char* path, size_t offset, uint8_t* out, size_t len) {
+        File f = LittleFS.open(path, FILE_READ);
+        if (!f) return 0;
+        size_t got = f.seek(offset) ? f.read(out, len) : 0;
+        f.close();
+        return got;
+    }
+
+    size_t size(const char* path) {
+        if (!LittleFS.exists(path)) return 0;
+        File f = LittleFS.open(path, FILE_READ);
+        size_t n = f ? f.size() : 0;
+        f.close();
+        return n;
+    }
+
+    bool remove(const char* path) { return LittleFS.remove(path); }
+
+    template <typename Fn>
+    void list(const char* dir, Fn fn) {
+        File d = LittleFS.open(dir);
+        if (!d || !d.isDirectory()) return;
+        for (File f = d.openNextFile(); f; f = d.openNextFile()) {
+            fn(f.name());
+            f.close();
+        }
+        d.close();
+    }
+};
+#endif
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <Arduino.h>
+#include "PeerTable.h"
+#include "../../shared/src/EspNowMessage.h"
+
+// Bounded ESP-NOW transmit scheduler.
+//
+// Frames are queued with a deadline and sent from EspNow::loop(). A frame stays
+// in flight until the send callback reports it. Each peer has at most one
+// frame in flight, so a callback (which only carries the MAC) matches its
+// frame exactly. A failed attempt is retried with exponential backoff using
+// the same bytes, so the receiver's SequenceWindow drops a copy that did
+// arrive. Frames still queued at their deadline are dropped.
+//
+// Radio-agnostic: pump() is handed the send function, so the host tests drive
+// it without esp_now. Not thread-safe; the WiFi task hands completions over
+// through a ring and loop() calls complete().
+class TxQueue {
+public:
+    static constexpr size_t SLOTS = 16;
+    static constexpr uint8_t MAX_IN_FLIGHT = 4;            // across all peers
+    static constexpr uint8_t MAX_IN_FLIGHT_PER_PEER = 1;
+    static constexpr uint8_t MAX_ATTEMPTS = 4;
+    static constexpr uint32_t BACKOFF_BASE_MS = 20;        // 20, 40, 80 ms between attempts
+    static constexpr uint32_t CALLBACK_TIMEOUT_MS = 100;   // in flight with no callback: count as failed
+    static constexpr uint32_t DEFAULT_DEADLINE_MS = 1000;
+
+    enum class State : uint8_t {
+        UNKNOWN,    // unknown handle, or its slot has been reused since
+        QUEUED,
+        IN_FLIGHT,
+        DELIVERED,  // the send callback reported success
+        FAILED,     // every attempt failed
+        EXPIRED     // deadline passed before it could be delivered
+    };
+
+    // What the send function did with a frame
+    enum class Attempt : uint8_t {
+        SENT,   // handed to the radio; a completion will follow
+        RETRY,  // refused this time (peer missing, radio busy): back off and retry
+        HOLD    // radio unusable: leave everything queued until the next pump
+    };
+
+    typedef uint32_t Handle;
+    static constexpr Handle NO_HANDLE = 0;
+
+    struct Counters {
+        uint32_t queued;
+        uint32_t delivered;
+        uint32_t failed;
+        uint32_t expired;
+        uint32_t retries;
+        uint32_t rejected;  // queue full or frame too long
+    };
+
+    TxQueue() : nextOrder(0), nextGen(1) {
+        memset(&totals, 0, sizeof(totals));
+        for (size_t i = 0; i < SLOTS; i++) { entries[i].state = State::UNKNOWN; entries[i].gen = 0; }
+    }
+
+    Handle enqueue(const uint8_t mac[6], const uint8_t* frame, size_t len, uint32_t now,
+                   uint32_t deadlineMs = DEFAULT_DEADLINE_MS) {
+        Entry* e = (len > 0 && len <= WireConstants::MAX_FRAME_LEN) ? freeEntry() : nullptr;
+        if (!e) {
+            totals.rejected++;
+            return NO_HANDLE;
+        }
+        memcpy(e->mac, mac, 6);
+        e->peer = macKey(mac);
+        memcpy(e->data, frame, len);
+        e->len = (uint8_t)len;
+        e->state = State::QUEUED;
+        e->attempts = 0;
+        e->order = nextOrder++;
+        e->dueMs = now;
+        e->deadlineMs = now + deadlineMs;
+        e->gen = nextGen++;
+        if (nextGen == 0) nextGen = 1;
+        totals.queued++;
+        return ((Handle)e->gen << 8) | (Handle)(e - entries);
+    }
+
+    State state(Handle h) const {
+        size_t slot = h & 0xFF;
+        if (h == NO_HANDLE || slot >= SLOTS || entries[slot].gen != (uint16_t)(h >> 8)) return State::UNKNOWN;
+        return entries[slot].state;
+    }
+
+    // Expire, time out and dispatch. send(mac, data, len) returns an Attempt;
+    // done(peer, state, attempts) hears every frame that finishes here.
+    template <typename Send, typename Done>
+    void pump(uint32_t now, Send send, Done done) {
+        for (size_t i = 0; i < SLOTS; i++) {
+            Entry& e = entries[i];
+            if (e.state == State::IN_FLIGHT && now - e.sentMs >= CALLBACK_TIMEOUT_MS) {
+                retryOrFail(e, now, done);
+            }
+            if (e.state == State::QUEUED && reached(now, e.deadlineMs)) {
+                finish(e, State::EXPIRED, done);
+            }
+        }
+        while (inFlight() < MAX_IN_FLIGHT) {
+            Entry* e = nextDue(now);
+            if (!e) return;
+            Attempt a = send(e->mac, e->data, e->len);
+            e->attempts++;
+            if (a == Attempt::SENT) {
+                e->state = State::IN_FLIGHT;
+                e->sentMs = now;
+            } else if (a == Attempt::RETRY) {
+                retryOrFail(*e, now, done);
+            } else {
+                e->attempts--;
+                return;
+            }
+        }
+    }
+
+    // The send callback's verdict for the frame in flight to this peer
+    template <typename Done>
+    bool complete(MacKey peer, bool ok, uint32_t now, Done done) {
+        Entry* e = nullptr;
+        for (size_t i = 0; i < SLOTS; i++) {
+            Entry& c = entries[i];
+            if (c.state == State::IN_FLIGHT && c.peer == peer && (!e || c.order < e->order)) e = &c;
+        }
+        if (!e) return false; // broadcast, timed out already, or not ours
+        if (ok) finish(*e, State::DELIVERED, done);
+        else retryOrFail(*e, now, done);
+        return true;
+    }
+
+    size_t pending() const {
+        size_t n = 0;
+        for (size_t i = 0; i < SLOTS; i++) n += active(entries[i]) ? 1 : 0;
+        return n;
+    }
+    size_t inFlight() const {
+        size_t n = 0;
+        for (size_t i = 0; i < SLOTS; i++) n += entries[i].state == State::IN_FLIGHT ? 1 : 0;
+        return n;
+    }
+    // The radio could not send for heldMs (channel change): give every queued
+    // frame that much more time and make it due now, so the next pump flushes
+    // the backlog instead of expiring it. Returns how many frames were held.
+    size_t resumeAfter(uint32_t now, uint32_t heldMs) {
+        size_t n = 0;
+        for (size_t i = 0; i < SLOTS; i++) {
+            Entry& e = entries[i];
+            if (e.state != State::QUEUED) continue;
+            e.dueMs = now;
+            e.deadlineMs += heldMs;
+            n++;
+        }
+        return n;
+    }
+
+    // A frame to 'peer' is with the radio and its callback is still to come
+    bool busy(MacKey peer) const { return inFlightTo(peer) > 0; }
+    const Counters& counters() const { return totals; }
+
+private:
+    struct Entry {
+        MacKey peer;
+        uint8_t mac[6];
+        uint8_t len;
+        State state;
+        uint8_t attempts;
+        uint16_t gen;
+        uint32_t order;       // enqueue order: frames leave FIFO
+        uint32_t dueMs;       // earliest next attempt
+        uint32_t deadlineMs;
+        uint32_t sentMs;
+        uint8_t data[WireConstants::MAX_FRAME_LEN];
+    };
+    Entry entries[SLOTS];
+    uint32_t nextOrder;
+    uint16_t nextGen;
+    Counters totals;
+
+    static bool active(const Entry& e) { return e.state == State::QUEUED || e.state == State::IN_FLIGHT; }
+    static bool reached(uint32_t now, uint32_t t) { return (int32_t)(now - t) >= 0; }
+
+    // Prefer slots never used, then the longest-finished one, so handles stay answerable
+    Entry* freeEntry() {
+        Entry* best = nullptr;
+        for (size_t i = 0; i < SLOTS; i++) {
+            Entry& e = entries[i];
+            if (active(e)) continue;
+            if (e.state == State::UNKNOWN) return &e;
+            if (!best || e.order < best->order) best = &e;
+        }
+        return best;
+    }
+
+    size_t inFlightTo(MacKey peer) const {
+        size_t n = 0;
+        for (size_t i = 0; i < SLOTS; i++) {
+            n += (entries[i].state == State::IN_FLIGHT && entries[i].peer == peer) ? 1 : 0;
+        }
+        return n;
+    }
+
+    // Oldest queued frame that is due and whose peer has room in flight
+    Entry* nextDue(uint32_t now) {
+        Entry* best = nullptr;
+        for (size_t i = 0; i < SLOTS; i++) {
+            Entry& e = entries[i];
+            if (e.state != State::QUEUED || !reached(now, e.dueMs)) continue;
+            if (best && e.order > best->order) continue;
+            if (inFlightTo(e.peer) >= MAX_IN_FLIGHT_PER_PEER) continue;
+            best = &e;
+        }
+        return best;
+    }
+
+    template <typename Done>
+    void retryOrFail(Entry& e, uint32_t now, Done done) {
+        if (e.attempts >= MAX_ATTEMPTS) {
+            finish(e, State::FAILED, done);
+            return;
+        }
+        e.state = State::QUEUED;
+        e.dueMs = now + (BACKOFF_BASE_MS << (e.attempts - 1));
+        totals.retries++;
+    }
+
+    template <typename Done>
+    void finish(Entry& e, State final, Done done) {
+        e.state = final;
+        if (final == State::DELIVERED) totals.delivered++;
+        else if (final == State::FAILED) totals.failed++;
+        else totals.expired++;
+        done(e.peer, final, e.attempts);
+    }
+};
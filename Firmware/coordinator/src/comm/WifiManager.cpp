@@ -116,6 +116,11 @@ bool WifiManager::attemptConnect(const String& ssid, const String& password, boo
     Logger::info("Connecting to Wi-Fi: %s", ssid.c_str());
     Logger::info("Password length: %d", password.length());
 
+    // The radio may move to the AP's channel: ESP-NOW holds its traffic until we are done
+    if (espNow) {
+        espNow->beginChannelChange();
+    }
+
     // CRITICAL: Use WiFi.disconnect(false, false) to avoid deinitializing ESP-NOW
     // The second parameter (true) would erase WiFi config AND deinit radio, breaking ESP-NOW!
     WiFi.disconnect(false, false);
@@ -161,11 +166,15 @@ bool WifiManager::attemptConnect(const String& ssid, const String& password, boo
         Logger::info("Wi-Fi connected: %s", status.ssid.c_str());
         
         if (espNow) {
-            espNow->updatePeerChannels();
+            espNow->endChannelChange();
         }
         return true;
     }
 
+    if (espNow) {
+        espNow->endChannelChange();
+    }
+
     Logger::warn("Wi-Fi connection to %s failed", ssid.c_str());
     Serial.println("✗ Failed to connect. Check credentials and retry.");
     return false;
@@ -85,6 +85,7 @@ bool Coordinator::begin() {
         return false;
     }
     Logger::info("✓ ESP-NOW initialized on channel %d", WiFi.channel());
+    espNow->setPingPolicy(PING_INTERVAL_MS, NODE_ONLINE_MS);
     
     // Link WiFi manager with ESP-NOW
     if (wifi) {
@@ -142,12 +143,12 @@ bool Coordinator::begin() {
     }
     
     // Set up ESP-NOW callbacks
-    espNow->setMessageCallback([this](const String& nodeId, const uint8_t* data, size_t len) {
-        this->handleNodeMessage(nodeId, data, len);
+    espNow->setMessageCallback([this](const String& nodeId, const EspNowMessage& msg, size_t len) {
+        this->handleNodeMessage(nodeId, msg, len);
     });
     
-    espNow->setPairingCallback([this](const uint8_t* mac, const uint8_t* data, size_t len) {
-        this->handlePairingRequest(mac, data, len);
+    espNow->setPairingCallback([this](const uint8_t* mac, const EspNowMessage& msg) {
+        this->handlePairingRequest(mac, msg);
     });
     
     espNow->setSendErrorCallback([this](const String& nodeId) {
@@ -196,10 +197,10 @@ void Coordinator::loop() {
         stopPairing();
     }
     
-    // Send health pings every 5 seconds
-    if (now - lastHealthPingMs >= 5000) {
+    // Pick up newly registered nodes; EspNow spreads the pings themselves
+    if (now - lastHealthPingMs >= PING_INTERVAL_MS) {
         lastHealthPingMs = now;
-        sendHealthPings();
+        updatePingTargets();
     }
     
     // Log status every 10 seconds
@@ -215,7 +216,7 @@ void Coordinator::loop() {
     }
 }
 
-void Coordinator::handleNodeMessage(const String& nodeId, const uint8_t* data, size_t len) {
+void Coordinator::handleNodeMessage(const String& nodeId, const EspNowMessage& msg, size_t len) {
     Logger::info("Message from node %s (%d bytes)", nodeId.c_str(), (int)len);
     
     // Update node registry
@@ -223,28 +224,21 @@ void Coordinator::handleNodeMessage(const String& nodeId, const uint8_t* data, s
         nodes->updateNodeStatus(nodeId, 100);
     }
     
-    // Parse message
-    String payload((const char*)data, len);
-    EspNowMessage* msg = MessageFactory::createMessage(payload);
-    
-    if (msg) {
-        if (msg->type == MessageType::NODE_STATUS) {
-            NodeStatusMessage* status = static_cast<NodeStatusMessage*>(msg);
-            Logger::info("  Status: R=%d G=%d B=%d W=%d Temp=%.1fC Button=%s",
-                status->avg_r, status->avg_g, status->avg_b, status->avg_w,
-                status->temperature,
-                status->button_pressed ? "PRESSED" : "Released");
-                
-            // Publish to MQTT
-            if (mqtt && mqtt->isConnected()) {
-                mqtt->publishNodeStatus(*status);
-            }
+    if (msg.type == MessageType::NODE_STATUS) {
+        const NodeStatusMessage& status = static_cast<const NodeStatusMessage&>(msg);
+        Logger::info("  Status: R=%d G=%d B=%d W=%d Temp=%.1fC Button=%s",
+            status.avg_r, status.avg_g, status.avg_b, status.avg_w,
+            status.temperature,
+            status.button_pressed ? "PRESSED" : "Released");
+            
+        // Publish to MQTT
+        if (mqtt && mqtt->isConnected()) {
+            mqtt->publishNodeStatus(status);
         }
-        delete msg;
     }
 }
 
-void Coordinator::handlePairingRequest(const uint8_t* mac, const uint8_t* data, size_t len) {
+void Coordinator::handlePairingRequest(const uint8_t* mac, const EspNowMessage& msg) {
     char macStr[18];
     snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
@@ -256,87 +250,83 @@ void Coordinator::handlePairingRequest(const uint8_t* mac, const uint8_t* data,
         return;
     }
     
-    // Parse join request
-    String payload((const char*)data, len);
-    EspNowMessage* msg = MessageFactory::createMessage(payload);
+    if (msg.type != MessageType::JOIN_REQUEST) {
+        Logger::warn("  Unexpected message type during pairing");
+        return;
+    }
+    const JoinRequestMessage& joinReq = static_cast<const JoinRequestMessage&>(msg);
     
-    if (msg) {
-        if (msg->type == MessageType::JOIN_REQUEST) {
-            JoinRequestMessage* joinReq = static_cast<JoinRequestMessage*>(msg);
-            
-            Logger::info("  Join Request:");
-            Logger::info("    MAC: %s", joinReq->mac.c_str());
-            Logger::info("    FW: %s", joinReq->fw.c_str());
-            Logger::info("    RGBW: %s", joinReq->caps.rgbw ? "Yes" : "No");
-            Logger::info("    LEDs: %d", joinReq->caps.led_count);
-            
-            // Generate node ID and light ID
-            String nodeId = joinReq->mac;
-            nodeId.replace(":", "");
-            nodeId = "N" + nodeId.substring(nodeId.length() - 6);
-            
-            String lightId = "L" + nodeId.substring(1);
-            
-            // Notify via MQTT that a node wants to pair
-            if (mqtt && mqtt->isConnected()) {
-                StaticJsonDocument<512> doc;
-                doc["event"] = "pairing_request";
-                doc["mac"] = joinReq->mac;
-                doc["node_id"] = nodeId;
-                doc["light_id"] = lightId;
-                doc["firmware"] = joinReq->fw;
-                doc["rssi"] = espNow->getPeerRssi(joinReq->mac);
-                doc["capabilities"]["rgbw"] = joinReq->caps.rgbw;
-                doc["capabilities"]["led_count"] = joinReq->caps.led_count;
-                doc["capabilities"]["temp_sensor"] = joinReq->caps.temp_i2c;
-                doc["capabilities"]["button"] = joinReq->caps.button;
-                
-                String topicBase = mqtt->getFarmId() + "/" + mqtt->getCoordinatorId();
-                String topic = topicBase + "/pairing/events";
-                
-                String jsonStr;
-                serializeJson(doc, jsonStr);
-                // Note: We can't publish directly here without PubSubClient access
-                // The MQTT class would need a publishJson() method
-                Logger::info("  Pairing request detected - waiting for frontend approval via MQTT");
-            }
-            
-            // For now, auto-accept (frontend can control via MQTT commands)
-            Logger::info("  Auto-accepting pairing request...");
-            
-            // Add to registry
-            if (nodes) {
-                nodes->registerNode(nodeId, lightId);
-                nodes->saveToStorage();
-            }
-            
-            // Add peer
-            uint8_t macBytes[6];
-            if (EspNow::macStringToBytes(joinReq->mac, macBytes)) {
-                espNow->addPeer(macBytes);
-                espNow->savePeersToStorage();
-            }
-            
-            // Send acceptance
-            JoinAcceptMessage accept;
-            accept.node_id = nodeId;
-            accept.light_id = lightId;
-            accept.wifi_channel = WiFi.channel();
-            accept.cfg.pwm_freq = 5000;
-            accept.cfg.rx_window_ms = 100;
-            accept.cfg.rx_period_ms = 1000;
-            
-            String acceptJson = accept.toJson();
-            espNow->sendToMac(macBytes, acceptJson);
-            
-            Logger::info("  Paired: %s -> %s", nodeId.c_str(), lightId.c_str());
-            
-            // Publish updated node list
-            if (mqtt && mqtt->isConnected()) {
-                publishNodeList();
-            }
-        }
-        delete msg;
+    Logger::info("  Join Request:");
+    Logger::info("    MAC: %s", joinReq.mac.c_str());
+    Logger::info("    FW: %s", joinReq.fw.c_str());
+    Logger::info("    RGBW: %s", joinReq.caps.rgbw ? "Yes" : "No");
+    Logger::info("    LEDs: %d", joinReq.caps.led_count);
+    
+    // Generate node ID and light ID
+    String nodeId = joinReq.mac;
+    nodeId.replace(":", "");
+    nodeId = "N" + nodeId.substring(nodeId.length() - 6);
+    
+    String lightId = "L" + nodeId.substring(1);
+    
+    // Notify via MQTT that a node wants to pair
+    if (mqtt && mqtt->isConnected()) {
+        StaticJsonDocument<512> doc;
+        doc["event"] = "pairing_request";
+        doc["mac"] = joinReq.mac.c_str();
+        doc["node_id"] = nodeId;
+        doc["light_id"] = lightId;
+        doc["firmware"] = joinReq.fw.c_str();
+        doc["rssi"] = espNow->getPeerRssi(joinReq.mac);
+        doc["capabilities"]["rgbw"] = joinReq.caps.rgbw;
+        doc["capabilities"]["led_count"] = joinReq.caps.led_count;
+        doc["capabilities"]["temp_sensor"] = joinReq.caps.temp_i2c;
+        doc["capabilities"]["button"] = joinReq.caps.button;
+        
+        String topicBase = mqtt->getFarmId() + "/" + mqtt->getCoordinatorId();
+        String topic = topicBase + "/pairing/events";
+        
+        String jsonStr;
+        serializeJson(doc, jsonStr);
+        // Note: We can't publish directly here without PubSubClient access
+        // The MQTT class would need a publishJson() method
+        Logger::info("  Pairing request detected - waiting for frontend approval via MQTT");
+    }
+    
+    // For now, auto-accept (frontend can control via MQTT commands)
+    Logger::info("  Auto-accepting pairing request...");
+    
+    // Add to registry
+    if (nodes) {
+        nodes->registerNode(nodeId, lightId);
+        nodes->saveToStorage();
+    }
+    
+    // Add peer
+    uint8_t macBytes[6];
+    if (EspNow::macStringToBytes(joinReq.mac, macBytes)) {
+        espNow->addPeer(macBytes);
+        espNow->savePeersToStorage();
+    }
+    
+    // Send acceptance
+    JoinAcceptMessage accept;
+    accept.node_id = nodeId;
+    accept.light_id = lightId;
+    accept.wifi_channel = WiFi.channel();
+    accept.wire_format = WireConstants::FORMAT_VERSION;
+    accept.cfg.pwm_freq = 5000;
+    accept.cfg.rx_window_ms = 100;
+    accept.cfg.rx_period_ms = 1000;
+    
+    String acceptJson = accept.toJson();
+    espNow->sendToMac(macBytes, acceptJson);
+    
+    Logger::info("  Paired: %s -> %s", nodeId.c_str(), lightId.c_str());
+    
+    // Publish updated node list
+    if (mqtt && mqtt->isConnected()) {
+        publishNodeList();
     }
 }
 
@@ -371,6 +361,9 @@ void Coordinator::handleMqttCommand(const String& topic, const String& payload)
     else if (cmd == "list_nodes") {
         publishNodeList();
     }
+    else if (cmd == "link_report") {
+        if (espNow) mqtt->publishLinkReport(espNow->getLinkSnapshots());
+    }
     else if (cmd == "unpair_node") {
         String nodeId = doc["node_id"] | "";
         if (!nodeId.isEmpty() && nodes) {
@@ -404,7 +397,7 @@ void Coordinator::logConnectedNodes() {
     int onlineCount = 0;
     
     for (const auto& node : allNodes) {
-        bool online = (node.lastSeenMs > 0 && (now - node.lastSeenMs) <= 10000);
+        bool online = (node.lastSeenMs > 0 && (now - node.lastSeenMs) <= NODE_ONLINE_MS);
         if (online) onlineCount++;
     }
     
@@ -426,7 +419,7 @@ void Coordinator::logConnectedNodes() {
     
     if (allNodes.size() > 0) {
         for (const auto& node : allNodes) {
-            bool online = (node.lastSeenMs > 0 && (now - node.lastSeenMs) <= 10000);
+            bool online = (node.lastSeenMs > 0 && (now - node.lastSeenMs) <= NODE_ONLINE_MS);
             uint32_t ago = (node.lastSeenMs > 0) ? (now - node.lastSeenMs) / 1000 : 999;
             Logger::info("  🌱 Tower %s -> Light %s [%s] (last seen %ds ago)",
                 node.towerId.c_str(),
@@ -437,16 +430,14 @@ void Coordinator::logConnectedNodes() {
     }
 }
 
-void Coordinator::sendHealthPings() {
+void Coordinator::updatePingTargets() {
     if (!nodes || !espNow) return;
     
     auto allNodes = nodes->getAllNodes();
     for (const auto& node : allNodes) {
-        // Send a simple ping
-        String ping = "{\"msg\":\"ping\",\"ts\":" + String(millis()) + "}";
         uint8_t mac[6];
         if (EspNow::macStringToBytes(node.towerId, mac)) {
-            espNow->sendToMac(mac, ping);
+            espNow->watchPeer(mac);
         }
     }
 }
@@ -510,7 +501,7 @@ void Coordinator::publishNodeList() {
         nodeObj["light_id"] = node.lightId;
         nodeObj["last_duty"] = node.lastDuty;
         
-        bool online = (node.lastSeenMs > 0 && (now - node.lastSeenMs) <= 10000);
+        bool online = (node.lastSeenMs > 0 && (now - node.lastSeenMs) <= NODE_ONLINE_MS);
         nodeObj["online"] = online;
         nodeObj["last_seen_ms"] = node.lastSeenMs;
         
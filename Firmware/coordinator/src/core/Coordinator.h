@@ -24,6 +24,8 @@ private:
     NodeRegistry* nodes;
     
     // Timing
+    static constexpr uint32_t NODE_ONLINE_MS = 10000;   // seen within this long counts as online
+    static constexpr uint32_t PING_INTERVAL_MS = 5000;
     uint32_t lastHealthPingMs;
     uint32_t lastStatusLogMs;
     uint32_t lastMqttPublishMs;
@@ -33,15 +35,15 @@ private:
     Deadline pairingDl;
     
     // Callbacks
-    void handleNodeMessage(const String& nodeId, const uint8_t* data, size_t len);
-    void handlePairingRequest(const uint8_t* mac, const uint8_t* data, size_t len);
+    void handleNodeMessage(const String& nodeId, const EspNowMessage& msg, size_t len);
+    void handlePairingRequest(const uint8_t* mac, const EspNowMessage& msg);
     void handleSendError(const String& nodeId);
     void handleMqttCommand(const String& topic, const String& payload);
     void handleConnectionStatusChange(const String& event, const String& detail);
     
     // Helpers
     void logConnectedNodes();
-    void sendHealthPings();
+    void updatePingTargets();
     void startPairing(uint32_t durationMs);
     void stopPairing();
     void publishPairingStatus();
@@ -24,7 +24,9 @@ Reservoir::Reservoir()
     , manualR(0)
     , manualG(0)
     , manualB(0)
-    {}
+{
+    registerTowerHandlers();
+}
 
 
 Reservoir::~Reservoir() {
@@ -68,6 +70,7 @@ bool Reservoir::begin() {
         return false;
     }
     Logger::info("ESP-NOW initialized successfully");
+    espNow->setPingPolicy(PING_INTERVAL_MS, TOWER_STALE_MS);
     publishLog("ESP-NOW initialized successfully", "INFO", "setup");
 
     // Link EspNow to WiFi so channels sync on connection
@@ -92,10 +95,8 @@ bool Reservoir::begin() {
     }
 
     // Register message callback for regular tower messages
-    espNow->setMessageCallback([this](const String& towerId, const uint8_t* data, size_t len) {
-        if (data && len > 0) {
-            this->handleTowerMessage(towerId, data, len);
-        }
+    espNow->setMessageCallback([this](const String& towerId, const EspNowMessage& msg, size_t len) {
+        this->handleTowerMessage(towerId, msg, len);
     });
 
     // Register send error callback for visual feedback
@@ -106,14 +107,12 @@ bool Reservoir::begin() {
     });
     
     // Register pairing callback to handle join requests coming from towers
-    espNow->setPairingCallback([this](const uint8_t* mac, const uint8_t* data, size_t len) {
-        if (!mac || !data || len == 0) {
+    espNow->setPairingCallback([this](const uint8_t* mac, const EspNowMessage& msg) {
+        if (!mac) {
             Logger::warn("Invalid pairing callback parameters");
             return;
         }
-        String payload((const char*)data, len);
-        MessageType mt = MessageFactory::getMessageType(payload);
-        if (mt != MessageType::JOIN_REQUEST) {
+        if (msg.type != MessageType::JOIN_REQUEST) {
             Logger::warn("Pairing callback: unexpected message type");
             return;
         }
@@ -148,6 +147,8 @@ bool Reservoir::begin() {
         accept.light_id = towers->getLightForTower(towerId);
         accept.lmk = ""; // Unencrypted for now
         accept.wifi_channel = currentChannel; // Tell tower which channel to use
+        accept.wire_format = WireConstants::FORMAT_VERSION; // Tower may switch to compact frames
+        accept.member_index = towers->getMemberIndex(towerId);
         accept.cfg.pwm_freq = 0; // Not used but set explicitly
         accept.cfg.rx_window_ms = 20;
         accept.cfg.rx_period_ms = 100;
@@ -192,6 +193,7 @@ bool Reservoir::begin() {
     mqtt->setCommandCallback([this](const String& topic, const String& payload) {
         this->handleMqttCommand(topic, payload);
     });
+    applyTelemetryConfig();
 
     Logger::info("Initializing tower registry...");
     bool towersOk = towers->begin();
@@ -257,6 +259,7 @@ bool Reservoir::begin() {
     groupConnected.assign(groupCount, false);
     groupFlashDl.assign(groupCount, Deadline());
     rebuildLedMappingFromRegistry();
+    applyLedConfig();
 
     bool zonesOk = zones->begin();
     recordBootStatus("Zones", zonesOk, zonesOk ? "control ready" : "init failed");
@@ -355,17 +358,20 @@ void Reservoir::loop() {
         flashAllTick(millis());
     }
 
-    // Always update per-tower LEDs (show connection state)
-    if (!statusLed.isPulsing()) {
+    // Per-tower LEDs show connection state; a pulse draws over the whole
+    // strip, so every group is repainted once it ends
+    if (statusLed.isPulsing()) {
+        ledCompositor.invalidate();
+    } else {
         updateLeds();
     }
 
-    // Periodically ping and check staleness
+    // Periodically refresh who gets pinged and check staleness
     static uint32_t lastPing = 0;
     static uint32_t lastStaleCheck = 0;
     uint32_t now = millis();
-    if (now - lastPing > 2000) {
-        sendHealthPings();
+    if (now - lastPing > PING_INTERVAL_MS) {
+        updatePingTargets();
         lastPing = now;
     }
     if (now - lastStaleCheck > 5000) {
@@ -426,219 +432,279 @@ void Reservoir::onButtonEvent(const String& buttonId, bool pressed) {
     startPairingWindow(windowMs, "button");
 }
 
-void Reservoir::handleTowerMessage(const String& towerId, const uint8_t* data, size_t len) {
-    // Parse the JSON payload to detect message type
-    String payload((const char*)data, len);
-    MessageType mt = MessageFactory::getMessageType(payload);
+void Reservoir::registerTowerHandlers() {
+    towerHandlers.on(MessageType::JOIN_REQUEST, "join", &Reservoir::onJoinRequest);
+    towerHandlers.on(MessageType::NODE_STATUS, "status", &Reservoir::onNodeStatus);
+    towerHandlers.on(MessageType::TOWER_TELEMETRY, "telemetry", &Reservoir::onTowerTelemetry);
+    towerHandlers.on(MessageType::TOWER_TELEMETRY_BATCH, "telemetry_batch", &Reservoir::onTowerTelemetryBatch);
+    towerHandlers.on(MessageType::TOWER_TELEMETRY_DELTA, "telemetry_delta", &Reservoir::onTowerTelemetryDelta);
+    towerHandlers.on(MessageType::TOWER_JOIN_REQUEST, "tower_join", &Reservoir::onTowerJoinRequest);
+}
 
-    // Auto-accept any tower JOIN_REQUEST (no formal pairing required)
-    if (mt == MessageType::JOIN_REQUEST && towers) {
-        // towerId is the MAC string - add as peer first
-        uint8_t mac[6];
-        if (EspNow::macStringToBytes(towerId, mac)) {
-            espNow->addPeer(mac);
-        }
-        
-        // Auto-register if not already known
-        String existingLight = towers->getLightForTower(towerId);
-        if (existingLight.length() == 0) {
-            // Generate light ID from MAC last 3 bytes
-            char lightIdBuf[16];
-            snprintf(lightIdBuf, sizeof(lightIdBuf), "L%s", towerId.substring(towerId.length() - 8).c_str());
-            // Remove colons
-            String lightId = String(lightIdBuf);
-            lightId.replace(":", "");
-            towers->registerTower(towerId, lightId);
-            existingLight = lightId;
-            Logger::info("Auto-registered tower %s as %s", towerId.c_str(), lightId.c_str());
-        }
-        
-        // Always respond with join_accept
-        JoinAcceptMessage accept;
-        accept.node_id = towerId;  // Keep wire format field name for compatibility
-        accept.light_id = existingLight;
-        accept.lmk = "";
-        // CRITICAL: Include current WiFi channel so tower can switch
-        uint8_t currentChannel = 1;
-        wifi_second_chan_t second = WIFI_SECOND_CHAN_NONE;
-        esp_wifi_get_channel(&currentChannel, &second);
-        accept.wifi_channel = currentChannel;
-        accept.cfg.rx_window_ms = 20;
-        accept.cfg.rx_period_ms = 100;
-        String json = accept.toJson();
-        
-        uint8_t mac2[6];
-        if (EspNow::macStringToBytes(towerId, mac2)) {
-            if (!espNow->sendToMac(mac2, json)) {
-                Logger::warn("Failed to send join_accept to %s", towerId.c_str());
-            } else {
-                Logger::info("Sent join_accept to %s", towerId.c_str());
-            }
+void Reservoir::handleTowerMessage(const String& towerId, const EspNowMessage& msg, size_t len) {
+    // Already decoded by EspNow; resolve the tower once, then dispatch on the type
+    uint32_t t0 = micros();
+    TowerContext tower;
+    resolveTower(towerId, tower);
+    uint32_t t1 = micros();
+    resolveLatency.record(t1 - t0);
+
+    DispatchTable<TowerHandler>::Entry* entry = towerHandlers.find(msg.type);
+    Logger::debug("[Tower %d] %s %s | %d bytes", tower.group + 1, towerId.c_str(),
+                  entry ? entry->name : "unhandled", (int)len);
+    if (entry) (this->*entry->handler)(tower, msg);
+    uint32_t t2 = micros();
+    handleLatency.record(t2 - t1);
+
+    // Every frame counts as a sign of life
+    if (towers) towers->updateTowerStatus(towerId, 0);
+    if (tower.group >= 0) groupFlashDl[tower.group].set(150); // brief activity flash on each message
+    // Deferred and coalesced with the tower's other frames
+    if (tower.ack && tower.haveMac) espNow->ackLater(tower.mac);
+    finishLatency.record(micros() - t2);
+}
+
+void Reservoir::resolveTower(const String& towerId, TowerContext& tower) {
+    tower.towerId = &towerId;
+    tower.haveMac = EspNow::macStringToBytes(towerId, tower.mac);
+    tower.ack = false;
+
+    // Ensure we have a group assigned for this tower
+    tower.group = getGroupIndexForTower(towerId);
+    if (tower.group < 0) {
+        tower.group = assignGroupForTower(towerId);
+        Logger::info("Assigned group %d to tower %s", tower.group + 1, towerId.c_str());
+    }
+    if (tower.group >= 0) {
+        if (!groupConnected[tower.group]) {
+            Logger::info("[Tower %d] %s CONNECTED", tower.group + 1, towerId.c_str());
         }
+        groupConnected[tower.group] = true; // mark as active connection
     }
+}
 
-    // Update last-seen for any message first
-    if (towers) {
-        towers->updateTowerStatus(towerId, 0);
+// Auto-accept any tower JOIN_REQUEST (no formal pairing required)
+void Reservoir::onJoinRequest(TowerContext& tower, const EspNowMessage& msg) {
+    if (!towers) return;
+    const String& towerId = *tower.towerId;
+    // towerId is the MAC string - add as peer first
+    if (tower.haveMac) {
+        espNow->addPeer(tower.mac);
     }
-    
-    // Ensure we have a group assigned for this tower
-    int idx = getGroupIndexForTower(towerId);
-    if (idx < 0) {
-        idx = assignGroupForTower(towerId);
-        Logger::info("Assigned group %d to tower %s", idx + 1, towerId.c_str());
+
+    // Auto-register if not already known
+    String existingLight = towers->getLightForTower(towerId);
+    if (existingLight.length() == 0) {
+        // Generate light ID from MAC last 3 bytes
+        char lightIdBuf[16];
+        snprintf(lightIdBuf, sizeof(lightIdBuf), "L%s", towerId.substring(towerId.length() - 8).c_str());
+        // Remove colons
+        String lightId = String(lightIdBuf);
+        lightId.replace(":", "");
+        towers->registerTower(towerId, lightId);
+        existingLight = lightId;
+        Logger::info("Auto-registered tower %s as %s", towerId.c_str(), lightId.c_str());
     }
-    if (idx >= 0) {
-        if (!groupConnected[idx]) {
-            Logger::info("[Tower %d] %s CONNECTED", idx + 1, towerId.c_str());
+
+    // Always respond with join_accept
+    JoinAcceptMessage accept;
+    accept.node_id = towerId;  // Keep wire format field name for compatibility
+    accept.light_id = existingLight;
+    accept.lmk = "";
+    // CRITICAL: Include current WiFi channel so tower can switch
+    uint8_t currentChannel = 1;
+    wifi_second_chan_t second = WIFI_SECOND_CHAN_NONE;
+    esp_wifi_get_channel(&currentChannel, &second);
+    accept.wifi_channel = currentChannel;
+    accept.wire_format = WireConstants::FORMAT_VERSION;
+    accept.member_index = towers->getMemberIndex(towerId);
+    accept.cfg.rx_window_ms = 20;
+    accept.cfg.rx_period_ms = 100;
+    String json = accept.toJson();
+
+    if (tower.haveMac) {
+        if (!espNow->sendToMac(tower.mac, json)) {
+            Logger::warn("Failed to send join_accept to %s", towerId.c_str());
+        } else {
+            Logger::info("Sent join_accept to %s", towerId.c_str());
         }
-        groupConnected[idx] = true; // mark as active connection
-        flashLedForTower(towerId, 150); // brief activity flash on each message
     }
+}
 
-    // Improved logging per tower index with MAC
-    Logger::info("[Tower %d] %s %s | %d bytes", 
-                 idx >= 0 ? idx + 1 : 0,
-                 towerId.c_str(),
-                 mt == MessageType::NODE_STATUS ? "STATUS" : "MESSAGE", 
-                 (int)len);
+void Reservoir::onNodeStatus(TowerContext& tower, const EspNowMessage& msg) {
+    if (!towers) return;
+    const NodeStatusMessage& statusMsg = static_cast<const NodeStatusMessage&>(msg);
+    updateTowerTelemetryCache(*tower.towerId, statusMsg);
 
-    // Mark last seen on status and log sensor data
-    if (mt == MessageType::NODE_STATUS && towers) {
-        towers->updateTowerStatus(towerId, 0);
-        
-        // Parse and log sensor data from telemetry
-        EspNowMessage* msg = MessageFactory::createMessage(payload);
-        if (msg) {
-            if (msg->type == MessageType::NODE_STATUS) {
-                NodeStatusMessage* statusMsg = static_cast<NodeStatusMessage*>(msg);
-                updateTowerTelemetryCache(towerId, *statusMsg);
-                
-                // Log temperature if available
-                if (statusMsg->temperature > -50.0f && statusMsg->temperature < 150.0f) {
-                    Logger::info("  [Tower %d] Temperature: %.2f C", 
-                                 idx >= 0 ? idx + 1 : 0, 
-                                 statusMsg->temperature);
-                }
-                
-                // Log button state
-                Logger::info("  [Tower %d] Button: %s, RGBW: (%d,%d,%d,%d)", 
-                             idx >= 0 ? idx + 1 : 0,
-                             statusMsg->button_pressed ? "PRESSED" : "Released",
-                             statusMsg->avg_r, statusMsg->avg_g, statusMsg->avg_b, statusMsg->avg_w);
-            }
-            delete msg;
-        }
-        
-        // Send ACK back to tower to keep connection alive
-        uint8_t mac[6];
-        if (EspNow::macStringToBytes(towerId, mac)) {
-            AckMessage ack;
-            ack.cmd_id = "telemetry_ack";
-            String ackJson = ack.toJson();
-            if (!espNow->sendToMac(mac, ackJson)) {
-                Logger::debug("Failed to send telemetry ACK to %s", towerId.c_str());
-            }
-        }
+    if (statusMsg.temperature > -50.0f && statusMsg.temperature < 150.0f) {
+        Logger::debug("  [Tower %d] Temperature: %.2f C", tower.group + 1, statusMsg.temperature);
     }
+    Logger::debug("  [Tower %d] Button: %s, RGBW: (%d,%d,%d,%d)",
+                  tower.group + 1,
+                  statusMsg.button_pressed ? "PRESSED" : "Released",
+                  statusMsg.avg_r, statusMsg.avg_g, statusMsg.avg_b, statusMsg.avg_w);
 
-    // ===== Hydroponic Tower Telemetry Forwarding =====
-    // Forward tower telemetry from ESP-NOW to MQTT for backend/dashboard consumption
-    if (mt == MessageType::TOWER_TELEMETRY && mqtt) {
-        EspNowMessage* msg = MessageFactory::createMessage(payload);
-        if (msg) {
-            if (msg->type == MessageType::TOWER_TELEMETRY) {
-                TowerTelemetryMessage* telemetry = static_cast<TowerTelemetryMessage*>(msg);
-                
-                // Log tower environmental data
-                Logger::info("[Tower %s] Air: %.1f C, Humidity: %.1f%%, Light: %.0f lux", 
-                             telemetry->tower_id.c_str(),
-                             telemetry->air_temp_c, 
-                             telemetry->humidity_pct,
-                             telemetry->light_lux);
-                Logger::info("[Tower %s] Pump: %s, Light: %s (brightness: %d)", 
-                             telemetry->tower_id.c_str(),
-                             telemetry->pump_on ? "ON" : "OFF",
-                             telemetry->light_on ? "ON" : "OFF",
-                             telemetry->light_brightness);
-                
-                // Forward to MQTT broker
-                mqtt->publishTowerTelemetry(*telemetry);
-                
-                // Send ACK back to tower
-                uint8_t mac[6];
-                if (EspNow::macStringToBytes(towerId, mac)) {
-                    AckMessage ack;
-                    ack.cmd_id = "tower_telemetry_ack";
-                    String ackJson = ack.toJson();
-                    if (!espNow->sendToMac(mac, ackJson)) {
-                        Logger::debug("Failed to send tower telemetry ACK to %s", towerId.c_str());
-                    }
-                }
-            }
-            delete msg;
-        }
+    // The tower keeps the link alive on our ACKs; one per window covers all its frames
+    tower.ack = true;
+}
+
+// ===== Hydroponic Tower Telemetry Forwarding =====
+// Forward tower telemetry from ESP-NOW to MQTT for backend/dashboard consumption.
+void Reservoir::onTowerTelemetry(TowerContext& tower, const EspNowMessage& msg) {
+    if (!mqtt) return;
+    forwardTowerTelemetry(static_cast<const TowerTelemetryMessage&>(msg));
+    tower.ack = true;
+}
+
+// One MQTT record per sample, each with its own sample time
+void Reservoir::onTowerTelemetryBatch(TowerContext& tower, const EspNowMessage& msg) {
+    if (!mqtt) return;
+    const TowerTelemetryBatchMessage& batch = static_cast<const TowerTelemetryBatchMessage&>(msg);
+    Logger::info("[Tower %s] Telemetry batch: %u samples", batch.tower_id.c_str(), (unsigned)batch.count);
+    TowerTelemetryMessage sample;
+    for (uint8_t i = 0; i < batch.count; i++) {
+        batch.sample(i, sample);
+        forwardTowerTelemetry(sample, batch.ts - sample.ts);
+    }
+    tower.ack = true;
+}
+
+// Rebuilt into the full message first and answered with a sync frame
+// (keyframe ack or keyframe request) instead of an ACK
+void Reservoir::onTowerTelemetryDelta(TowerContext& tower, const EspNowMessage& msg) {
+    if (!mqtt || !tower.haveMac) return;
+    const String& towerId = *tower.towerId;
+    const TowerTelemetryDeltaMessage& frame = static_cast<const TowerTelemetryDeltaMessage&>(msg);
+    TowerTelemetryMessage rebuilt;
+    TowerTelemetryAssembler::Result result = telemetryAssembler.apply(macKey(tower.mac), millis(), frame, rebuilt);
+    if (result == TowerTelemetryAssembler::Result::NEED_KEYFRAME) {
+        Logger::info("[Tower %s] Delta against unknown keyframe %u, requesting keyframe",
+                     towerId.c_str(), (unsigned)frame.key_id);
+    } else {
+        forwardTowerTelemetry(rebuilt);
+    }
+    TowerTelemetrySyncMessage sync = TowerTelemetryAssembler::syncFor(frame, result);
+    if (!espNow->sendToMac(tower.mac, sync)) {
+        Logger::debug("Failed to send tower telemetry sync to %s", towerId.c_str());
     }
+}
 
-    // ===== Hydroponic Tower Join Request =====
-    // Handle tower-specific join requests (different from legacy join)
-    if (mt == MessageType::TOWER_JOIN_REQUEST && mqtt) {
-        EspNowMessage* msg = MessageFactory::createMessage(payload);
-        if (msg) {
-            if (msg->type == MessageType::TOWER_JOIN_REQUEST) {
-                TowerJoinRequestMessage* joinReq = static_cast<TowerJoinRequestMessage*>(msg);
-                
-                // Add as ESP-NOW peer
-                uint8_t mac[6];
-                if (EspNow::macStringToBytes(towerId, mac)) {
-                    espNow->addPeer(mac);
-                }
-                
-                // Generate tower ID from MAC
-                char towerIdBuf[24];
-                snprintf(towerIdBuf, sizeof(towerIdBuf), "T%s", towerId.substring(towerId.length() - 8).c_str());
-                String assignedTowerId = String(towerIdBuf);
-                assignedTowerId.replace(":", "");
-                
-                Logger::info("Tower join request from %s (FW: %s), assigning ID: %s", 
-                             towerId.c_str(), joinReq->fw.c_str(), assignedTowerId.c_str());
-                Logger::info("  Capabilities: DHT=%d, Light=%d, Pump=%d, GrowLight=%d, Slots=%d",
-                             joinReq->caps.dht_sensor, joinReq->caps.light_sensor,
-                             joinReq->caps.pump_relay, joinReq->caps.grow_light,
-                             joinReq->caps.slot_count);
-                
-                // Send join accept response
-                TowerJoinAcceptMessage accept;
-                accept.tower_id = assignedTowerId;
-                accept.coord_id = mqtt->getCoordinatorId();
-                accept.farm_id = mqtt->getFarmId();
-                accept.lmk = "";  // TODO: implement secure pairing with LMK
-                
-                // Get current WiFi channel
-                uint8_t currentChannel = 1;
-                wifi_second_chan_t second = WIFI_SECOND_CHAN_NONE;
-                esp_wifi_get_channel(&currentChannel, &second);
-                accept.wifi_channel = currentChannel;
-                
-                // Default configuration
-                accept.cfg.telemetry_interval_ms = 30000;  // 30 seconds
-                accept.cfg.pump_max_duration_s = 300;      // 5 minutes max
-                
-                String json = accept.toJson();
-                if (EspNow::macStringToBytes(towerId, mac)) {
-                    if (!espNow->sendToMac(mac, json)) {
-                        Logger::warn("Failed to send tower_join_accept to %s", towerId.c_str());
-                    } else {
-                        Logger::info("Sent tower_join_accept to %s (tower_id: %s)", 
-                                     towerId.c_str(), assignedTowerId.c_str());
-                    }
-                }
-            }
-            delete msg;
+// ===== Hydroponic Tower Join Request =====
+// Handle tower-specific join requests (different from legacy join)
+void Reservoir::onTowerJoinRequest(TowerContext& tower, const EspNowMessage& msg) {
+    if (!mqtt) return;
+    const String& towerId = *tower.towerId;
+    const TowerJoinRequestMessage& joinReq = static_cast<const TowerJoinRequestMessage&>(msg);
+
+    // Add as ESP-NOW peer
+    if (tower.haveMac) {
+        espNow->addPeer(tower.mac);
+    }
+
+    // Generate tower ID from MAC
+    char towerIdBuf[24];
+    snprintf(towerIdBuf, sizeof(towerIdBuf), "T%s", towerId.substring(towerId.length() - 8).c_str());
+    String assignedTowerId = String(towerIdBuf);
+    assignedTowerId.replace(":", "");
+
+    Logger::info("Tower join request from %s (FW: %s), assigning ID: %s",
+                 towerId.c_str(), joinReq.fw.c_str(), assignedTowerId.c_str());
+    Logger::info("  Capabilities: DHT=%d, Light=%d, Pump=%d, GrowLight=%d, Slots=%d",
+                 joinReq.caps.dht_sensor, joinReq.caps.light_sensor,
+                 joinReq.caps.pump_relay, joinReq.caps.grow_light,
+                 joinReq.caps.slot_count);
+
+    // Send join accept response
+    TowerJoinAcceptMessage accept;
+    accept.tower_id = assignedTowerId;
+    accept.coord_id = mqtt->getCoordinatorId();
+    accept.farm_id = mqtt->getFarmId();
+    accept.lmk = "";  // TODO: implement secure pairing with LMK
+
+    // Get current WiFi channel
+    uint8_t currentChannel = 1;
+    wifi_second_chan_t second = WIFI_SECOND_CHAN_NONE;
+    esp_wifi_get_channel(&currentChannel, &second);
+    accept.wifi_channel = currentChannel;
+    accept.wire_format = WireConstants::FORMAT_VERSION;
+
+    // Default configuration
+    accept.cfg.telemetry_interval_ms = 30000;  // 30 seconds
+    accept.cfg.pump_max_duration_s = 300;      // 5 minutes max
+
+    String json = accept.toJson();
+    if (tower.haveMac) {
+        if (!espNow->sendToMac(tower.mac, json)) {
+            Logger::warn("Failed to send tower_join_accept to %s", towerId.c_str());
+        } else {
+            Logger::info("Sent tower_join_accept to %s (tower_id: %s)",
+                         towerId.c_str(), assignedTowerId.c_str());
         }
     }
 }
 
+void Reservoir::logIngestStats() {
+    const StageLatency* decode = espNow ? &espNow->getDecodeLatency() : nullptr;
+    if (decode) {
+        Logger::info("Ingest decode:  %u frames, avg %u us, max %u us",
+                     (unsigned)decode->count, (unsigned)decode->avgUs(), (unsigned)decode->maxUs);
+    }
+    Logger::info("Ingest resolve: avg %u us, max %u us", (unsigned)resolveLatency.avgUs(), (unsigned)resolveLatency.maxUs);
+    Logger::info("Ingest handle:  avg %u us, max %u us", (unsigned)handleLatency.avgUs(), (unsigned)handleLatency.maxUs);
+    Logger::info("Ingest finish:  avg %u us, max %u us", (unsigned)finishLatency.avgUs(), (unsigned)finishLatency.maxUs);
+    towerHandlers.forEach([](MessageType type, const DispatchTable<TowerHandler>::Entry& e) {
+        Logger::info("  %-16s %u frames", e.name, (unsigned)e.frames);
+    });
+    Logger::info("  %-16s %u frames", "unhandled", (unsigned)towerHandlers.unhandledFrames());
+    Logger::info("Telemetry history: %u/%u towers, %u bytes each (%u samples of %u bytes), %u bytes total",
+                 (unsigned)towerHistory.towerCount(), (unsigned)TowerHistory::TOWERS,
+                 (unsigned)TowerHistory::bytesPerTower(), (unsigned)TowerHistory::SAMPLES,
+                 (unsigned)TowerHistory::bytesPerSample(), (unsigned)TowerHistory::totalBytes());
+    const GroupLeds::Counters& led = ledCompositor.counters();
+    Logger::info("LED frames: %u shown (%u groups pushed) at up to %u fps, %u show() avoided "
+                 "(%u unchanged, %u rate-limited)",
+                 (unsigned)led.frames, (unsigned)led.groupsPushed, (unsigned)ledCompositor.frameRate(),
+                 (unsigned)led.avoided(), (unsigned)led.clean, (unsigned)led.deferred);
+    if (mqtt) {
+        const Mqtt::TelemetryBatchStats& b = mqtt->getTelemetryBatchStats();
+        Logger::info("Telemetry batches: %u records in %u publishes, %u bytes, %u spooled, %u dropped",
+                     (unsigned)b.records, (unsigned)b.batches, (unsigned)b.bytes, (unsigned)b.spooled,
+                     (unsigned)b.dropped);
+        const Mqtt::Spool::Counters& s = mqtt->getSpoolCounters();
+        Logger::info("Telemetry spool: %u spooled, %u replayed, %u rejected, %u segments dropped, %u torn, "
+                     "%u KB written in %u flushes",
+                     (unsigned)s.spooled, (unsigned)s.replayed, (unsigned)s.rejected, (unsigned)s.segmentsDropped,
+                     (unsigned)s.tornRecords, (unsigned)(s.bytesWritten / 1024), (unsigned)s.flushes);
+    }
+}
+
+void Reservoir::forwardTowerTelemetry(const TowerTelemetryMessage& telemetry, uint32_t ageMs) {
+    // Kept whether or not the publish below gets through
+    TowerHistory::Sample h;
+    uint32_t now = millis();
+    h.timeS = ageMs > now ? 0 : (now - ageMs) / 1000;  // older than our uptime: pin to boot
+    h.airTempC = telemetry.air_temp_c;
+    h.humidityPct = telemetry.humidity_pct;
+    h.lightLux = telemetry.light_lux;
+    h.actuators = (telemetry.pump_on ? TowerHistory::PUMP_ON : 0) | (telemetry.light_on ? TowerHistory::LIGHT_ON : 0);
+    towerHistory.record(telemetry.tower_id.c_str(), h);
+
+    // Log tower environmental data
+    Logger::info("[Tower %s] Air: %.1f C, Humidity: %.1f%%, Light: %.0f lux", 
+                 telemetry.tower_id.c_str(),
+                 telemetry.air_temp_c, 
+                 telemetry.humidity_pct,
+                 telemetry.light_lux);
+    Logger::info("[Tower %s] Pump: %s, Light: %s (brightness: %d)", 
+                 telemetry.tower_id.c_str(),
+                 telemetry.pump_on ? "ON" : "OFF",
+                 telemetry.light_on ? "ON" : "OFF",
+                 telemetry.light_brightness);
+    
+    // Forward to MQTT broker
+    mqtt->publishTowerTelemetry(telemetry);
+}
+
 // ===== LED mapping helpers =====
 void Reservoir::rebuildLedMappingFromRegistry() {
     towerToGroup.clear();
@@ -657,8 +723,8 @@ void Reservoir::rebuildLedMappingFromRegistry() {
         if (idx >= maxGroups) break;
         towerToGroup[t.towerId] = idx;
         groupToTower[idx] = t.towerId;
-        // Mark as connected if recently seen (within last 6 seconds)
-        groupConnected[idx] = (t.lastSeenMs > 0 && (now - t.lastSeenMs) <= 6000U);
+        // Mark as connected if recently seen
+        groupConnected[idx] = (t.lastSeenMs > 0 && (now - t.lastSeenMs) <= TOWER_STALE_MS);
         idx++;
     }
 }
@@ -722,13 +788,12 @@ void Reservoir::updateLeds() {
         } else {
             r=0; gc=0; b=0;
         }
-        // Paint the 4-pixel group
-        int base = g * 4;
-        for (int k=0;k<4;k++) {
-            statusLed.setPixel(base+k, r, gc, b);
-        }
+        ledCompositor.setGroup(g, r, gc, b);
     }
-    statusLed.show();
+    // Only changed groups are repainted, and show() only runs when one did
+    ledCompositor.render(millis(),
+                         [this](size_t i, uint8_t r, uint8_t g, uint8_t b) { statusLed.setPixel(i, r, g, b); },
+                         [this]() { statusLed.show(); });
 }
 
 void Reservoir::logConnectedTowers() {
@@ -763,8 +828,7 @@ void Reservoir::checkStaleConnections() {
     for (const auto& tower : allTowers) {
         int idx = getGroupIndexForTower(tower.towerId);
         if (idx >= 0 && groupConnected[idx]) {
-            // Mark disconnected if last seen > 6s
-            if (tower.lastSeenMs > 0 && (now - tower.lastSeenMs) > 6000U) {
+            if (tower.lastSeenMs > 0 && (now - tower.lastSeenMs) > TOWER_STALE_MS) {
                 groupConnected[idx] = false;
                 Logger::warn("[Tower %d] DISCONNECTED (timeout)", idx + 1);
             }
@@ -772,16 +836,16 @@ void Reservoir::checkStaleConnections() {
     }
 }
 
-void Reservoir::sendHealthPings() {
+void Reservoir::updatePingTargets() {
     if (!espNow) return;
     int groupCount = Pins::RgbLed::NUM_PIXELS / 4;
     for (int g = 0; g < groupCount; ++g) {
-        // Only ping towers that currently appear connected
-        if (groupToTower[g].length() == 0 || !groupConnected[g]) continue;
+        // Only towers that currently appear connected are pinged
+        if (groupToTower[g].length() == 0) continue;
         uint8_t mac[6];
         if (!EspNow::macStringToBytes(groupToTower[g], mac)) continue;
-        const String ping = "{\"msg\":\"ping\"}";
-        espNow->sendToMac(mac, ping);
+        if (groupConnected[g]) espNow->watchPeer(mac);
+        else espNow->unwatchPeer(mac);
     }
 }
 
@@ -820,15 +884,40 @@ void Reservoir::flashAllTick(uint32_t now) {
     lastFlashTick = now;
     flashOn = !flashOn;
 
-    // Send white on/off to all connected towers with short TTL and override_status
-    auto all = towers->getAllTowers();
-    for (const auto& t : all) {
-        int gi = getGroupIndexForTower(t.towerId);
-        if (gi < 0 || !groupConnected[gi]) continue;
-        uint8_t level = flashOn ? 128 : 0; // 50% brightness
-        // quick fade for nicer blink
-        espNow->sendLightCommand(t.towerId, level, 60 /*fadeMs*/, true /*override*/, 500 /*ttl*/);
+    // White on/off to the whole fleet in one broadcast, short TTL and override_status
+    GroupCommandMessage cmd;
+    cmd.group_id = GroupConstants::GROUP_ALL;
+    cmd.w = flashOn ? 128 : 0; // 50% brightness
+    cmd.fade_ms = 60;          // quick fade for nicer blink
+    cmd.override_status = true;
+    cmd.ttl_ms = 500;
+    espNow->sendGroupCommand(cmd);
+}
+
+bool Reservoir::setZoneLight(const String& zoneId, uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint16_t fadeMs) {
+    if (!zones || !towers || !espNow) return false;
+    GroupCommandMessage cmd;
+    cmd.group_id = zones->getGroupForZone(zoneId);
+    if (cmd.group_id == ZoneControl::NO_GROUP) {
+        Logger::warn("Zone %s unknown - light command dropped", zoneId.c_str());
+        return false;
     }
+    bool on = (r | g | b | w) != 0;
+    size_t members = 0;
+    for (const String& lightId : zones->getLightsForZone(zoneId)) {
+        if (cmd.addMember(towers->getMemberIndex(towers->getTowerForLight(lightId)))) members++;
+        zones->updateLightState(lightId, on);
+    }
+    if (members == 0) {
+        Logger::info("Zone %s has no addressable towers", zoneId.c_str());
+        return false;
+    }
+    cmd.r = r; cmd.g = g; cmd.b = b; cmd.w = w;
+    cmd.fade_ms = fadeMs;
+    bool sent = espNow->sendGroupCommand(cmd);
+    Logger::info("Zone %s (group %u): %u tower(s) in one broadcast%s", zoneId.c_str(),
+                 (unsigned)cmd.group_id, (unsigned)members, sent ? "" : " - not queued");
+    return sent;
 }
 
 void Reservoir::triggerTowerWaveTest() {
@@ -852,27 +941,28 @@ void Reservoir::triggerTowerWaveTest() {
 
     Logger::info("Starting wave on %d connected tower(s)...", connected.size());
 
-    // Deterministic order and synchronized start time across towers
-    std::sort(connected.begin(), connected.end(), [](const TowerInfo& a, const TowerInfo& b) {
-        return a.towerId < b.towerId;
-    });
-
-    const uint32_t now = millis();
-    const uint32_t startAt = now + 300; // 300ms in the future to allow delivery jitter
-    const uint16_t periodMs = 1200;
-    const uint16_t durationMs = 4000;
+    // One broadcast carries the whole wave: every member lights up in member
+    // index order, one stagger step after the previous one, and holds for a
+    // pulse. Everyone hears the same frame, so the steps stay even.
+    const uint16_t periodMs = 1200;  // time for the wave to cross all towers
+    const uint16_t pulseMs = 400;    // how long each tower stays lit
 
+    GroupCommandMessage wave;
+    wave.group_id = GroupConstants::GROUP_ALL;
     for (const auto& tower : connected) {
-        uint8_t mac[6];
-        if (!EspNow::macStringToBytes(tower.towerId, mac)) continue;
-        // Include start_at to coordinate across towers
-        String wave = String("{\"msg\":\"wave\",\"period_ms\":") + String(periodMs) +
-                      ",\"duration_ms\":" + String(durationMs) +
-                      ",\"start_at\":" + String(startAt) + "}";
-        espNow->sendToMac(mac, wave);
+        wave.addMember(towers->getMemberIndex(tower.towerId));
+    }
+    wave.w = 160;
+    wave.fade_ms = 80;
+    wave.override_status = true;
+    wave.stagger_ms = periodMs / connected.size();
+    wave.hold_ms = pulseMs;
+
+    if (espNow->sendGroupCommand(wave)) {
+        Logger::info("Wave command sent (%u ms per step)", (unsigned)wave.stagger_ms);
+    } else {
+        Logger::warn("Wave command could not be queued");
     }
-
-    Logger::info("Wave command sent");
 }
 
 void Reservoir::handleMqttCommand(const String& topic, const String& payload) {
@@ -929,6 +1019,10 @@ void Reservoir::handleMqttCommand(const String& topic, const String& payload) {
         } else {
             Logger::error("ESP-NOW not initialized, cannot send to tower");
         }
+    } else if (cmd == "set_light" && doc.containsKey("zone")) {
+        // Whole zone in one broadcast rather than a set_light per tower
+        String zoneId = doc["zone"] | "";
+        setZoneLight(zoneId, doc["r"] | 0, doc["g"] | 0, doc["b"] | 0, doc["w"] | 0, doc["fade_ms"] | 200);
     } else if (cmd == "led.set") {
         manualR = doc["r"] | 0;
         manualG = doc["g"] | 0;
@@ -943,6 +1037,14 @@ void Reservoir::handleMqttCommand(const String& topic, const String& payload) {
         }
         Logger::info("Manual LED override: RGB(%d,%d,%d)", manualR, manualG, manualB);
         updateLeds();
+    } else if (cmd == "link.report") {
+        if (espNow && mqtt) mqtt->publishLinkReport(espNow->getLinkSnapshots());
+    } else if (cmd == "ingest.report") {
+        logIngestStats();
+    } else if (cmd == "telemetry.history") {
+        String towerId = doc["tower_id"] | "";
+        uint32_t minutes = doc["minutes"] | 10;
+        publishTowerHistory(towerId, minutes);
     } else if (cmd == "led.reset") {
         manualLedMode = false;
         Logger::info("Manual LED override cleared");
@@ -993,6 +1095,9 @@ void Reservoir::handleMqttCommand(const String& topic, const String& payload) {
             publishLog(msg, "INFO", "config");
             Logger::info("%s", msg.c_str());
             
+            applyTelemetryConfig();
+            applyLedConfig();
+
             // Note: A reboot may be required for some parameters to take effect
             if (updateCount > 0) {
                 Logger::warn("Some config changes may require restart to take effect");
@@ -1003,6 +1108,49 @@ void Reservoir::handleMqttCommand(const String& topic, const String& payload) {
     }
 }
 
+// Tower telemetry publishing from the "reservoir" config namespace (update_config):
+// tlm_mode 0 = per-tower topics, 1 = batch topic, 2 = both; tlm_batch_ms = batch
+// window; spool_rate = records per second replayed after an outage
+void Reservoir::applyTelemetryConfig() {
+    if (!mqtt) return;
+    ConfigManager config("reservoir");
+    if (!config.begin()) return;
+    int mode = config.getInt("tlm_mode", 0);
+    int windowMs = config.getInt("tlm_batch_ms", (int)Mqtt::DEFAULT_BATCH_WINDOW_MS);
+    int replayRate = config.getInt("spool_rate", Mqtt::Spool::DEFAULT_REPLAY_PER_S);
+    config.end();
+    if (mode < 0 || mode > 2) mode = 0;
+    if (windowMs <= 0) windowMs = (int)Mqtt::DEFAULT_BATCH_WINDOW_MS;
+    mqtt->setTowerTelemetryMode(static_cast<Mqtt::TelemetryMode>(mode), (uint32_t)windowMs);
+    if (replayRate <= 0 || replayRate > 1000) replayRate = Mqtt::Spool::DEFAULT_REPLAY_PER_S;
+    mqtt->setSpoolReplayRate((uint16_t)replayRate);
+}
+
+void Reservoir::applyLedConfig() {
+    ConfigManager config("reservoir");
+    if (!config.begin()) return;
+    int fps = config.getInt("led_fps", GroupLeds::DEFAULT_FPS);
+    config.end();
+    // Out of range falls back to the default inside setFrameRate
+    ledCompositor.setFrameRate(fps > 0 && fps <= 0xFFFF ? (uint16_t)fps : 0);
+}
+
+void Reservoir::publishTowerHistory(const String& towerId, uint32_t minutes) {
+    if (!mqtt || towerId.length() == 0) {
+        Logger::warn("telemetry.history needs a tower_id");
+        return;
+    }
+    uint32_t nowS = millis() / 1000;
+    uint32_t spanS = minutes * 60;
+    std::vector<TowerHistory::Sample> samples;
+    samples.reserve(towerHistory.count(towerId.c_str()));
+    towerHistory.query(towerId.c_str(), spanS < nowS ? nowS - spanS : 0, nowS,
+                       [&samples](const TowerHistory::Sample& s) { samples.push_back(s); });
+    Logger::info("Tower %s history: %u samples in the last %u min",
+                 towerId.c_str(), (unsigned)samples.size(), (unsigned)minutes);
+    mqtt->publishTowerHistory(towerId, samples, nowS);
+}
+
 void Reservoir::startPairingWindow(uint32_t durationMs, const char* reason) {
     if (!towers || !espNow) {
         return;
@@ -6,15 +6,21 @@
 #include "../comm/EspNow.h"
 #include "../comm/Mqtt.h"
 #include "../towers/TowerRegistry.h"
+#include "../towers/TowerTelemetryAssembler.h"
+#include "../towers/TowerIngest.h"
+#include "../towers/TowerHistory.h"
 #include "../zones/ZoneControl.h"
 #include "../input/ButtonControl.h"
 #include "../sensors/ThermalControl.h"
 #include "../utils/StatusLed.h"
+#include "../utils/LedCompositor.h"
 #include "../../shared/src/utils/SafeTimer.h"
 
 class WifiManager;
 class AmbientLightSensor;
+struct EspNowMessage;
 struct NodeStatusMessage;
+struct TowerTelemetryMessage;
 struct NodeThermalData;
 
 class Reservoir {
@@ -53,6 +59,10 @@ private:
         uint32_t lastUpdateMs = 0;
     };
     std::map<String, TowerTelemetrySnapshot> towerTelemetry;
+    // Rebuilds full tower telemetry from delta frames
+    TowerTelemetryAssembler telemetryAssembler;
+    // Recent telemetry per tower for backfill after an outage ("telemetry.history")
+    TowerHistory towerHistory;
     ReservoirSensorSnapshot reservoirSensors;
     bool zoneOccupiedState = false;
     uint32_t lastSensorSampleMs = 0;
@@ -63,6 +73,11 @@ private:
     std::vector<String> groupToTower;           // size = NUM_PIXELS/4
     std::vector<bool> groupConnected;           // true if connected
     std::vector<Deadline> groupFlashDl;          // activity flash deadlines
+    // Pushes group colours to the strip only on change, at most led_fps a second
+    typedef LedCompositor<Pins::RgbLed::NUM_PIXELS / 4> GroupLeds;
+    GroupLeds ledCompositor;
+    static constexpr uint32_t TOWER_STALE_MS = 6000;     // silent this long: disconnected
+    static constexpr uint32_t PING_INTERVAL_MS = 2000;
 
     // Helpers for LED mapping and updates
     void rebuildLedMappingFromRegistry();
@@ -72,7 +87,7 @@ private:
     void flashLedForTower(const String& towerId, uint32_t durationMs);
     void logConnectedTowers();
     void checkStaleConnections();
-    void sendHealthPings();
+    void updatePingTargets();
 
     // Button/flash state
     bool buttonDown = false;
@@ -102,14 +117,44 @@ private:
     void startFlashAll();
     void stopFlashAll();
     void flashAllTick(uint32_t now);
+    // Light every tower in a zone with one broadcast group command
+    bool setZoneLight(const String& zoneId, uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint16_t fadeMs);
     
     // Event handlers
     void onThermalEvent(const String& towerId, const NodeThermalData& data);
     void onButtonEvent(const String& buttonId, bool pressed);
-    void handleTowerMessage(const String& towerId, const uint8_t* data, size_t len);
+    void handleTowerMessage(const String& towerId, const EspNowMessage& msg, size_t len);
+
+    // Tower frame ingest (see TowerIngest.h): resolved once, then dispatched on the type
+    struct TowerContext {
+        const String* towerId;  // MAC string
+        uint8_t mac[6];
+        bool haveMac;
+        int group;              // LED group, -1 when none is free
+        bool ack;               // set by the handler: acknowledge with a deferred ACK
+    };
+    typedef void (Reservoir::*TowerHandler)(TowerContext& tower, const EspNowMessage& msg);
+    DispatchTable<TowerHandler> towerHandlers;
+    StageLatency resolveLatency;
+    StageLatency handleLatency;
+    StageLatency finishLatency;
+    void registerTowerHandlers();
+    void resolveTower(const String& towerId, TowerContext& tower);
+    void onJoinRequest(TowerContext& tower, const EspNowMessage& msg);
+    void onNodeStatus(TowerContext& tower, const EspNowMessage& msg);
+    void onTowerTelemetry(TowerContext& tower, const EspNowMessage& msg);
+    void onTowerTelemetryBatch(TowerContext& tower, const EspNowMessage& msg);
+    void onTowerTelemetryDelta(TowerContext& tower, const EspNowMessage& msg);
+    void onTowerJoinRequest(TowerContext& tower, const EspNowMessage& msg);
+    void logIngestStats();
+    // ageMs: how long before the frame was sent the sample was taken (batched samples)
+    void forwardTowerTelemetry(const TowerTelemetryMessage& telemetry, uint32_t ageMs = 0);
+    void publishTowerHistory(const String& towerId, uint32_t minutes);
     void triggerTowerWaveTest();
     void handleMqttCommand(const String& topic, const String& payload);
     void startPairingWindow(uint32_t durationMs, const char* reason);
+    void applyTelemetryConfig();
+    void applyLedConfig();
     void updateTowerTelemetryCache(const String& towerId, const NodeStatusMessage& statusMsg);
     void refreshReservoirSensors();
     void printSerialTelemetry();
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+
+// Recent telemetry of each tower, kept on the coordinator so a broker or
+// backend outage can be backfilled afterwards.
+//
+// Fixed memory: TOWERS rings of SAMPLES each, allocated with the object. A
+// ring is columnar, one array per field, and stores each field quantized:
+//
+//   time         uint32  coordinator seconds (millis() / 1000)
+//   temperature  int16   0.1 C
+//   humidity     uint8   0.5 %
+//   light        uint16  1 lux, clamped to 65534
+//   actuators    uint8   bit 0 pump, bit 1 grow light
+//
+// 10 bytes a sample instead of the 40-odd of TowerTelemetryMessage. Missing
+// readings (NaN) are kept as a sentinel and come back as NaN.
+//
+// TOWERS is deliberately below the fleet limit (MAX_FLEET_TOWERS, PeerTable.h):
+// rings for the whole fleet would take over 120 KB of RAM. When every ring is
+// taken, the tower heard from least recently gives its ring up, so a farm with
+// more than TOWERS towers reporting keeps recycling rings and only the towers
+// heard from most recently have history to backfill.
+class TowerHistory {
+public:
+    static constexpr size_t TOWERS = 16;
+    static constexpr size_t SAMPLES = 128;      // about an hour at the 30 s telemetry interval
+    static constexpr size_t ID_LEN = 24;
+    static constexpr uint8_t PUMP_ON = 0x01;
+    static constexpr uint8_t LIGHT_ON = 0x02;
+
+    struct Sample {
+        uint32_t timeS;
+        float airTempC;
+        float humidityPct;
+        float lightLux;
+        uint8_t actuators;
+    };
+
+    TowerHistory() { clear(); }
+
+    void clear() {
+        for (size_t i = 0; i < TOWERS; i++) {
+            rings[i].id[0] = '\0';
+            rings[i].head = 0;
+            rings[i].count = 0;
+            rings[i].lastS = 0;
+        }
+    }
+
+    void record(const char* towerId, const Sample& s) {
+        if (!towerId || !towerId[0]) return;
+        Ring* r = claim(towerId);
+        size_t i = r->head;
+        r->timeS[i] = s.timeS;
+        r->tempD[i] = isnan(s.airTempC) ? NO_TEMP : (int16_t)clampRound(s.airTempC * 10.0f, -32767, 32767);
+        r->humH[i] = isnan(s.humidityPct) ? NO_HUM : (uint8_t)clampRound(s.humidityPct * 2.0f, 0, 200);
+        r->lux[i] = isnan(s.lightLux) ? NO_LUX : (uint16_t)clampRound(s.lightLux, 0, 65534);
+        r->bits[i] = s.actuators;
+        r->head = (uint16_t)((i + 1) % SAMPLES);
+        if (r->count < SAMPLES) r->count++;
+        if ((int32_t)(s.timeS - r->lastS) > 0 || r->count == 1) r->lastS = s.timeS;
+    }
+
+    // Samples of one tower with fromS <= time <= toS, oldest first, to
+    // fn(const Sample&). Returns how many were handed out.
+    template <typename Fn>
+    size_t query(const char* towerId, uint32_t fromS, uint32_t toS, Fn fn) const {
+        int slot = indexOf(towerId);
+        if (slot < 0) return 0;
+        const Ring* r = &rings[slot];
+        size_t n = 0;
+        size_t first = (r->head + SAMPLES - r->count) % SAMPLES;
+        for (size_t k = 0; k < r->count; k++) {
+            size_t i = (first + k) % SAMPLES;
+            uint32_t t = r->timeS[i];
+            if ((int32_t)(t - fromS) < 0 || (int32_t)(toS - t) < 0) continue;
+            Sample s;
+            s.timeS = t;
+            s.airTempC = r->tempD[i] == NO_TEMP ? NAN : r->tempD[i] / 10.0f;
+            s.humidityPct = r->humH[i] == NO_HUM ? NAN : r->humH[i] / 2.0f;
+            s.lightLux = r->lux[i] == NO_LUX ? NAN : (float)r->lux[i];
+            s.actuators = r->bits[i];
+            fn(s);
+            n++;
+        }
+        return n;
+    }
+
+    size_t count(const char* towerId) const {
+        int slot = indexOf(towerId);
+        return slot < 0 ? 0 : rings[slot].count;
+    }
+
+    size_t towerCount() const {
+        size_t n = 0;
+        for (size_t i = 0; i < TOWERS; i++) n += rings[i].id[0] ? 1 : 0;
+        return n;
+    }
+
+    // Memory cost: every ring is allocated up front whether used or not
+    static constexpr size_t bytesPerTower() { return sizeof(Ring); }
+    static constexpr size_t bytesPerSample() {
+        return sizeof(uint32_t) + sizeof(int16_t) + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint8_t);
+    }
+    static constexpr size_t totalBytes() { return sizeof(Ring) * TOWERS; }
+
+private:
+    static constexpr int16_t NO_TEMP = INT16_MIN;
+    static constexpr uint8_t NO_HUM = 0xFF;
+    static constexpr uint16_t NO_LUX = 0xFFFF;
+
+    struct Ring {
+        char id[ID_LEN];
+        uint16_t head;          // next slot to write
+        uint16_t count;
+        uint32_t lastS;         // newest sample time, to pick a ring to give up
+        uint32_t timeS[SAMPLES];
+        int16_t tempD[SAMPLES];
+        uint16_t lux[SAMPLES];
+        uint8_t humH[SAMPLES];
+        uint8_t bits[SAMPLES];
+    };
+    Ring rings[TOWERS];
+
+    static long clampRound(float v, long lo, long hi) {
+        long q = lroundf(v);
+        return q < lo ? lo : (q > hi ? hi : q);
+    }
+
+    int indexOf(const char* towerId) const {
+        for (size_t i = 0; i < TOWERS; i++) {
+            if (rings[i].id[0] && strncmp(rings[i].id, towerId, ID_LEN - 1) == 0) return (int)i;
+        }
+        return -1;
+    }
+
+    // The tower's ring, else a free one, else the one heard from longest ago
+    Ring* claim(const char* towerId) {
+        int slot = indexOf(towerId);
+        if (slot >= 0) return &rings[slot];
+        Ring* r = nullptr;
+        for (size_t i = 0; i < TOWERS; i++) {
+            Ring& c = rings[i];
+            if (!c.id[0]) {
+                r = &c;
+                break;
+            }
+            if (!r || (int32_t)(c.lastS - r->lastS) < 0) r = &c;
+        }
+        strncpy(r->id, towerId, ID_LEN - 1);
+        r->id[ID_LEN - 1] = '\0';
+        r->head = 0;
+        r->count = 0;
+        r->lastS = 0;
+        return r;
+    }
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../../shared/src/EspNowMessage.h"
+#include "../utils/StageLatency.h"
+
+// Staged ingest of tower frames, as Reservoir runs it:
+//
+//   decode    EspNow parses the frame once into a typed message
+//   resolve   the tower context (MAC bytes, LED group, connected flag) is
+//             looked up once per frame
+//   handle    the handler registered for the message type gets both
+//   finish    shared bookkeeping after the handler (registry touch,
+//             activity flash, ACK)
+//
+// A new message type is one on() call with its handler; nothing else
+// changes. Each stage records its own StageLatency.
+
+// Handlers indexed by MessageType, so dispatch is one array read
+template <typename Handler>
+class DispatchTable {
+public:
+    static constexpr size_t SLOTS = (size_t)MessageType::GROUP_COMMAND + 1;
+
+    struct Entry {
+        Handler handler;
+        const char* name;
+        uint32_t frames;
+    };
+
+    DispatchTable() {
+        for (size_t i = 0; i < SLOTS; i++) entries[i] = Entry{ Handler(), nullptr, 0 };
+    }
+
+    // False for a type outside the table
+    bool on(MessageType type, const char* name, Handler handler) {
+        size_t i = (size_t)type;
+        if (i >= SLOTS) return false;
+        entries[i].handler = handler;
+        entries[i].name = name;
+        return true;
+    }
+
+    // Null when nothing handles this type; counts the frames it hands out
+    Entry* find(MessageType type) {
+        size_t i = (size_t)type;
+        if (i >= SLOTS || !entries[i].name) {
+            unhandled++;
+            return nullptr;
+        }
+        entries[i].frames++;
+        return &entries[i];
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < SLOTS; i++) {
+            if (entries[i].name) fn((MessageType)i, entries[i]);
+        }
+    }
+
+    uint32_t unhandledFrames() const { return unhandled; }
+
+private:
+    Entry entries[SLOTS];
+    uint32_t unhandled = 0;
+};
@@ -56,6 +56,10 @@ bool TowerRegistry::registerTower(const String& towerId, const String& lightId)
     info.temperature = 0;
     info.isDerated = false;
     info.derationLevel = 100;
+    info.memberIndex = nextFreeMemberIndex();
+    if (info.memberIndex == NO_MEMBER) {
+        Logger::warning("No member index left for tower %s; group commands will skip it", towerId.c_str());
+    }
     
     towers[towerId] = info;
     lightToTower[lightId] = towerId;
@@ -160,6 +164,33 @@ String TowerRegistry::getLightForTower(const String& towerId) const {
     return it != towers.end() ? it->second.lightId : String();
 }
 
+uint8_t TowerRegistry::getMemberIndex(const String& towerId) const {
+    auto it = towers.find(towerId);
+    return it != towers.end() ? it->second.memberIndex : NO_MEMBER;
+}
+
+uint8_t TowerRegistry::nextFreeMemberIndex() const {
+    // Lowest index not in use keeps group command bitmaps short
+    bool used[NO_MEMBER] = {};
+    for (const auto& pair : towers) {
+        if (pair.second.memberIndex != NO_MEMBER) used[pair.second.memberIndex] = true;
+    }
+    for (uint8_t i = 0; i < NO_MEMBER; i++) {
+        if (!used[i]) return i;
+    }
+    return NO_MEMBER;
+}
+
+void TowerRegistry::assignMissingMemberIndexes() {
+    bool assigned = false;
+    for (auto& pair : towers) {
+        if (pair.second.memberIndex != NO_MEMBER) continue;
+        pair.second.memberIndex = nextFreeMemberIndex();
+        assigned = assigned || pair.second.memberIndex != NO_MEMBER;
+    }
+    if (assigned) saveToStorage();
+}
+
 std::vector<String> TowerRegistry::getAllTowerMacs() const {
     std::vector<String> macs;
     macs.reserve(towers.size());
@@ -178,19 +209,21 @@ void TowerRegistry::loadFromStorage() {
         String key = "tower" + String(i);
         String data = prefs.getString(key.c_str());
         
-        // Parse tower data (format: "towerId,lightId,lastDuty")
+        // Parse tower data (format: "towerId,lightId,lastDuty[,memberIndex]")
         int comma1 = data.indexOf(',');
         int comma2 = data.indexOf(',', comma1 + 1);
         if (comma1 > 0 && comma2 > comma1) {
+            int comma3 = data.indexOf(',', comma2 + 1);
             String towerId = data.substring(0, comma1);
             String lightId = data.substring(comma1 + 1, comma2);
-            uint8_t lastDuty = data.substring(comma2 + 1).toInt();
+            uint8_t lastDuty = data.substring(comma2 + 1, comma3 > comma2 ? comma3 : data.length()).toInt();
             
             TowerInfo info;
             info.towerId = towerId;
             info.lightId = lightId;
             info.lastDuty = lastDuty;
             info.lastSeenMs = 0; // Mark as not seen in this session
+            if (comma3 > comma2) info.memberIndex = data.substring(comma3 + 1).toInt();
             
             towers[towerId] = info;
             lightToTower[lightId] = towerId;
@@ -230,6 +263,9 @@ void TowerRegistry::loadFromStorage() {
             saveToStorage();
         }
     }
+    
+    // Towers stored before member indexes existed get one now
+    assignMissingMemberIndexes();
 }
 
 void TowerRegistry::saveToStorage() {
@@ -242,7 +278,7 @@ void TowerRegistry::saveToStorage() {
     size_t i = 0;
     for (const auto& pair : towers) {
         const TowerInfo& info = pair.second;
-        String data = info.towerId + "," + info.lightId + "," + String(info.lastDuty);
+        String data = info.towerId + "," + info.lightId + "," + String(info.lastDuty) + "," + String(info.memberIndex);
         prefs.putString(("tower" + String(i)).c_str(), data);
         i++;
     }
@@ -37,6 +37,8 @@ public:
     // Tower-Light mapping
     String getTowerForLight(const String& lightId) const;
     String getLightForTower(const String& towerId) const;
+    // Stable per-tower index that group commands address; 0xFF when unknown
+    uint8_t getMemberIndex(const String& towerId) const;
     
     // Get all stored tower MAC addresses (for re-pairing on boot)
     std::vector<String> getAllTowerMacs() const;
@@ -65,10 +67,13 @@ private:
     void loadFromStorage();
     void saveToStorage();
     void cleanupStaleTowers();
+    uint8_t nextFreeMemberIndex() const;
+    void assignMissingMemberIndexes();
     std::function<void(const String& towerId, const String& lightId)> towerRegisteredCallback = nullptr;
     
     static const char* STORAGE_NAMESPACE;
     static const uint32_t TOWER_TIMEOUT_MS = 300000; // 5 minutes
+    static const uint8_t NO_MEMBER = 0xFF;
 };
 
 // Backward compatibility alias
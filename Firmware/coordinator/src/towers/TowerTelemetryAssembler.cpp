@@ -0,0 +1,59 @@
+#include "TowerTelemetryAssembler.h"
+
+TowerTelemetryAssembler::Result TowerTelemetryAssembler::apply(MacKey tower, uint32_t nowMs,
+                                                               const TowerTelemetryDeltaMessage& frame,
+                                                               TowerTelemetryMessage& out) {
+    if (frame.keyframe) {
+        Baseline& b = baselineFor(tower, nowMs);
+        b.keyId = frame.key_id;
+        b.lastMs = nowMs;
+        frame.applyTo(b.state);
+        out = b.state;
+        keyframeCount++;
+        return Result::KEYFRAME;
+    }
+
+    Baseline* b = baselines.find(tower);
+    if (!b || b->keyId != frame.key_id) {
+        // Coordinator restarted, the baseline was recycled, or the keyframe
+        // this delta refers to was lost
+        resyncCount++;
+        return Result::NEED_KEYFRAME;
+    }
+    b->lastMs = nowMs;
+    // Deltas are relative to the keyframe, never to each other, so the baseline stays put
+    out = b->state;
+    frame.applyTo(out);
+    deltaCount++;
+    return Result::DELTA;
+}
+
+void TowerTelemetryAssembler::forget(MacKey tower) {
+    baselines.erase(tower);
+}
+
+TowerTelemetryAssembler::Baseline& TowerTelemetryAssembler::baselineFor(MacKey tower, uint32_t nowMs) {
+    Baseline* b = baselines.insert(tower);
+    if (b) return *b;
+
+    // Full: the tower heard from longest ago gives its slot up
+    MacKey stalest = tower;
+    uint32_t oldestAge = 0;
+    baselines.forEach([&](MacKey k, const Baseline& s) {
+        uint32_t age = nowMs - s.lastMs;
+        if (stalest == tower || age > oldestAge) {
+            stalest = k;
+            oldestAge = age;
+        }
+    });
+    baselines.erase(stalest);
+    recycledCount++;
+    return *baselines.insert(tower);
+}
+
+TowerTelemetrySyncMessage TowerTelemetryAssembler::syncFor(const TowerTelemetryDeltaMessage& frame, Result result) {
+    TowerTelemetrySyncMessage sync;
+    sync.key_id = frame.key_id;
+    sync.keyframe_request = (result == Result::NEED_KEYFRAME);
+    return sync;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../../shared/src/EspNowMessage.h"
+#include "../comm/PeerTable.h"
+
+// Rebuilds full tower telemetry from tower_telemetry_delta frames.
+// Keeps the last keyframe per tower, in a fixed table sized for the fleet,
+// and applies each delta on top of it. A delta that refers to a keyframe we
+// do not hold cannot be rebuilt; the caller answers it with a keyframe
+// request. When the table is full, a new tower takes the slot of the tower
+// heard from longest ago, which recovers through that same request.
+class TowerTelemetryAssembler {
+public:
+    enum class Result {
+        KEYFRAME,        // new baseline stored; 'out' is complete
+        DELTA,           // applied to the baseline; 'out' is complete
+        NEED_KEYFRAME    // no matching baseline; 'out' untouched
+    };
+
+    Result apply(MacKey tower, uint32_t nowMs, const TowerTelemetryDeltaMessage& frame, TowerTelemetryMessage& out);
+    void forget(MacKey tower);
+
+    // Reply for a frame: ack its keyframe, or ask for a new one
+    static TowerTelemetrySyncMessage syncFor(const TowerTelemetryDeltaMessage& frame, Result result);
+
+    uint32_t getKeyframeCount() const { return keyframeCount; }
+    uint32_t getDeltaCount() const { return deltaCount; }
+    uint32_t getResyncCount() const { return resyncCount; }
+    uint32_t getRecycledCount() const { return recycledCount; }
+    size_t getTowerCount() const { return baselines.size(); }
+
+private:
+    struct Baseline {
+        uint8_t keyId = 0;
+        uint32_t lastMs = 0;
+        TowerTelemetryMessage state;
+    };
+    MacTable<Baseline, macTableSlots(MAX_FLEET_TOWERS)> baselines;
+    uint32_t keyframeCount = 0;
+    uint32_t recycledCount = 0;
+    uint32_t deltaCount = 0;
+    uint32_t resyncCount = 0;
+
+    Baseline& baselineFor(MacKey tower, uint32_t nowMs);
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Per-group LED state between Reservoir and the strip.
+//
+// Reservoir states the colour each group should show every loop; only groups
+// whose colour changed are marked dirty, and the strip is pushed (setPixel for
+// the dirty groups, then one show()) only when something is dirty and a frame
+// interval has passed since the last push. Changes within a frame interval are
+// coalesced into the next frame. show() on a NeoPixel strip bit-bangs with
+// interrupts off for the whole strip, so every push avoided is radio time won.
+//
+// Hardware-agnostic: render() takes setPixel(index, r, g, b) and show().
+template <size_t GROUPS, size_t PIXELS_PER_GROUP = 4>
+class LedCompositor {
+public:
+    static_assert(GROUPS <= 32, "dirty mask is 32 bits");
+    static constexpr uint16_t DEFAULT_FPS = 30;
+    static constexpr uint16_t MAX_FPS = 100;
+
+    struct Counters {
+        uint32_t frames = 0;        // show() calls made
+        uint32_t groupsPushed = 0;  // groups rewritten across those frames
+        uint32_t clean = 0;         // render() with nothing changed: show() avoided
+        uint32_t deferred = 0;      // render() inside the frame interval: show() avoided
+        uint32_t avoided() const { return clean + deferred; }
+    };
+
+    LedCompositor() { setFrameRate(DEFAULT_FPS); invalidate(); }
+
+    // Frames per second cap; 0 or out of range falls back to DEFAULT_FPS
+    void setFrameRate(uint16_t fps) {
+        if (fps == 0 || fps > MAX_FPS) fps = DEFAULT_FPS;
+        fps_ = fps;
+        frameMs = 1000 / fps;
+    }
+    uint16_t frameRate() const { return fps_; }
+
+    // Target colour of a group; marks it dirty only if that changes it
+    void setGroup(size_t g, uint8_t r, uint8_t gc, uint8_t b) {
+        if (g >= GROUPS) return;
+        Rgb& t = target[g];
+        if (t.r == r && t.g == gc && t.b == b) return;
+        t.r = r;
+        t.g = gc;
+        t.b = b;
+        dirtyMask |= 1UL << g;
+    }
+
+    // Strip contents lost (someone else drew on it): repaint every group
+    void invalidate() { dirtyMask = GROUPS == 32 ? 0xFFFFFFFFUL : (1UL << GROUPS) - 1; }
+    bool dirty() const { return dirtyMask != 0; }
+
+    // Pushes dirty groups if the frame interval allows. True if show() ran.
+    template <typename SetPixel, typename Show>
+    bool render(uint32_t nowMs, SetPixel setPixel, Show show) {
+        if (!dirtyMask) {
+            stats.clean++;
+            return false;
+        }
+        if (shown && nowMs - lastFrameMs < frameMs) {
+            stats.deferred++;
+            return false;
+        }
+        for (size_t g = 0; g < GROUPS; g++) {
+            if (!(dirtyMask & (1UL << g))) continue;
+            for (size_t k = 0; k < PIXELS_PER_GROUP; k++) {
+                setPixel(g * PIXELS_PER_GROUP + k, target[g].r, target[g].g, target[g].b);
+            }
+            stats.groupsPushed++;
+        }
+        show();
+        dirtyMask = 0;
+        shown = true;
+        lastFrameMs = nowMs;
+        stats.frames++;
+        return true;
+    }
+
+    const Counters& counters() const { return stats; }
+
+private:
+    struct Rgb {
+        uint8_t r = 0, g = 0, b = 0;
+    };
+    Rgb target[GROUPS];
+    uint32_t dirtyMask = 0;
+    uint16_t fps_ = DEFAULT_FPS;
+    uint32_t frameMs = 0;
+    uint32_t lastFrameMs = 0;
+    bool shown = false;
+    Counters stats;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Latency of one processing stage in microseconds: last, max and an EWMA
+// (weight 1/16). Fixed size, no allocation; record() from one task only.
+struct StageLatency {
+    uint32_t count = 0;
+    uint32_t lastUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t avgQ4 = 0;   // us * 16
+
+    void record(uint32_t us) {
+        avgQ4 = count ? (uint32_t)((int64_t)avgQ4 + ((int64_t)us * 16 - avgQ4) / 16) : us * 16;
+        lastUs = us;
+        if (us > maxUs) maxUs = us;
+        count++;
+    }
+    uint32_t avgUs() const { return avgQ4 / 16; }
+};
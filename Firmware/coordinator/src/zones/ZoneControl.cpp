@@ -24,6 +24,7 @@ bool ZoneControl::addZone(const String& zoneId) {
     }
     
     zoneToLights[zoneId] = std::vector<String>();
+    zoneGroups[zoneId] = nextFreeGroup();
     saveToStorage();
     Logger::info("Added new zone: %s", zoneId.c_str());
     return true;
@@ -46,6 +47,7 @@ bool ZoneControl::removeZone(const String& zoneId) {
     }
     
     zoneToLights.erase(it);
+    zoneGroups.erase(zoneId);
     saveToStorage();
     Logger::info("Removed zone: %s", zoneId.c_str());
     return true;
@@ -110,6 +112,20 @@ std::vector<String> ZoneControl::getLightsForZone(const String& zoneId) const {
     return it != zoneToLights.end() ? it->second : std::vector<String>();
 }
 
+uint8_t ZoneControl::getGroupForZone(const String& zoneId) const {
+    auto it = zoneGroups.find(zoneId);
+    return it != zoneGroups.end() ? it->second : NO_GROUP;
+}
+
+uint8_t ZoneControl::nextFreeGroup() const {
+    bool used[256] = {};
+    for (const auto& pair : zoneGroups) used[pair.second] = true;
+    for (int g = 1; g < 255; g++) {
+        if (!used[g]) return (uint8_t)g;
+    }
+    return NO_GROUP;
+}
+
 std::vector<String> ZoneControl::getZonesForLight(const String& lightId) const {
     auto it = lightToZones.find(lightId);
     return it != lightToZones.end() ? it->second : std::vector<String>();
@@ -154,6 +170,15 @@ void ZoneControl::loadFromStorage() {
         }
         
         zoneToLights[zoneId] = lights;
+        uint8_t group = (uint8_t)prefs.getUInt((zoneKey + "_g").c_str(), NO_GROUP);
+        if (group != NO_GROUP) zoneGroups[zoneId] = group;
+    }
+    
+    // Zones saved before group ids existed get one now
+    for (const auto& zonePair : zoneToLights) {
+        if (zoneGroups.find(zonePair.first) == zoneGroups.end()) {
+            zoneGroups[zonePair.first] = nextFreeGroup();
+        }
     }
     
     prefs.end();
@@ -175,6 +200,7 @@ void ZoneControl::saveToStorage() {
         String zoneKey = "z" + String(zoneIndex);
         prefs.putString((zoneKey + "_id").c_str(), zonePair.first.c_str());
         prefs.putUInt((zoneKey + "_count").c_str(), zonePair.second.size());
+        prefs.putUInt((zoneKey + "_g").c_str(), getGroupForZone(zonePair.first));
         
         size_t lightIndex = 0;
         for (const String& lightId : zonePair.second) {
@@ -21,17 +21,23 @@ public:
     
     // Zone queries
     std::vector<String> getLightsForZone(const String& zoneId) const;
+    // Group id this zone's broadcast commands carry (1..254); NO_GROUP if unknown
+    uint8_t getGroupForZone(const String& zoneId) const;
     std::vector<String> getZonesForLight(const String& lightId) const;
     bool isLightActive(const String& lightId) const;
     
     // Light state tracking
     void updateLightState(const String& lightId, bool active);
 
+    static const uint8_t NO_GROUP = 0;  // also the fleet-wide group id on the wire
+
 private:
     std::map<String, std::vector<String>> zoneToLights;  // zoneId -> [lightId]
     std::map<String, std::vector<String>> lightToZones;  // lightId -> [zoneId]
     std::map<String, bool> lightStates;  // lightId -> active
+    std::map<String, uint8_t> zoneGroups;  // zoneId -> group id, stable across reboots
     
+    uint8_t nextFreeGroup() const;
     void loadFromStorage();
     void saveToStorage();
 };
@@ -0,0 +1,127 @@
+#pragma once
+
+// Minimal Arduino core for host-side tests (env:native).
+// Covers what the shared protocol code and the pure-C++ coordinator helpers
+// use: String, millis()/micros() on a settable clock, and a Serial that
+// prints only when HOST_VERBOSE is set in the environment.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+// --- Clock ---
+inline uint32_t& hostMillis() {
+    static uint32_t ms = 0;
+    return ms;
+}
+inline void hostAdvanceMillis(uint32_t ms) { hostMillis() += ms; }
+inline unsigned long millis() { return hostMillis(); }
+inline unsigned long micros() { return hostMillis() * 1000UL; }
+inline void delay(uint32_t ms) { hostAdvanceMillis(ms); }
+inline void yield() {}
+
+// --- String ---
+class String {
+public:
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    String(const char* c, size_t n) : s(c, n) {}
+    String(const std::string& x) : s(x) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(int v) : s(std::to_string(v)) {}
+    explicit String(unsigned v) : s(std::to_string(v)) {}
+    explicit String(long v) : s(std::to_string(v)) {}
+    explicit String(unsigned long v) : s(std::to_string(v)) {}
+    explicit String(float v, int decimals = 2) { format(v, decimals); }
+    explicit String(double v, int decimals = 2) { format(v, decimals); }
+
+    String& operator=(const char* c) { s = c ? c : ""; return *this; }
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned length() const { return (unsigned)s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    bool reserve(unsigned n) { s.reserve(n); return true; }
+    bool concat(const char* c) { if (c) s += c; return true; }
+    bool concat(char c) { s += c; return true; }
+
+    int indexOf(const char* x, unsigned from = 0) const { return pos(s.find(x, from)); }
+    int indexOf(const String& x, unsigned from = 0) const { return pos(s.find(x.s, from)); }
+    int indexOf(char c, unsigned from = 0) const { return pos(s.find(c, from)); }
+    String substring(unsigned from) const { return from >= s.size() ? String() : String(s.substr(from)); }
+    String substring(unsigned from, unsigned to) const { return from >= s.size() || to <= from ? String() : String(s.substr(from, to - from)); }
+    void replace(const char* from, const char* to) {
+        const std::string f(from), t(to);
+        if (f.empty()) return;
+        for (size_t p = s.find(f); p != std::string::npos; p = s.find(f, p + t.size())) s.replace(p, f.size(), t);
+    }
+    bool startsWith(const String& x) const { return s.compare(0, x.s.size(), x.s) == 0; }
+    bool endsWith(const String& x) const { return s.size() >= x.s.size() && s.compare(s.size() - x.s.size(), x.s.size(), x.s) == 0; }
+    bool equals(const String& x) const { return s == x.s; }
+    void toLowerCase() { for (auto& c : s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (auto& c : s) c = (char)toupper((unsigned char)c); }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return (float)atof(s.c_str()); }
+    char charAt(unsigned i) const { return i < s.size() ? s[i] : 0; }
+    char operator[](unsigned i) const { return charAt(i); }
+
+    String& operator+=(const String& x) { s += x.s; return *this; }
+    String& operator+=(const char* x) { if (x) s += x; return *this; }
+    String& operator+=(char x) { s += x; return *this; }
+    bool operator==(const String& x) const { return s == x.s; }
+    bool operator==(const char* x) const { return s == (x ? x : ""); }
+    bool operator!=(const String& x) const { return s != x.s; }
+    bool operator!=(const char* x) const { return !(*this == x); }
+    bool operator<(const String& x) const { return s < x.s; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.s); }
+
+private:
+    std::string s;
+
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+    void format(double v, int decimals) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        s = buf;
+    }
+};
+
+// ArduinoJson names this type when ARDUINOJSON_ENABLE_ARDUINO_STRING is set
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+};
+
+// --- Serial ---
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+    int printf(const char* fmt, ...) {
+        if (!verbose()) return 0;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vprintf(fmt, ap);
+        va_end(ap);
+        return n;
+    }
+    void print(const char* s) { if (verbose()) fputs(s, stdout); }
+    void print(const String& s) { print(s.c_str()); }
+    void println(const char* s = "") { if (verbose()) puts(s); }
+    void println(const String& s) { println(s.c_str()); }
+    void flush() { fflush(stdout); }
+    explicit operator bool() const { return true; }
+
+private:
+    static bool verbose() { return getenv("HOST_VERBOSE") != nullptr; }
+};
+
+static HostSerial Serial __attribute__((unused));
@@ -0,0 +1,77 @@
+#pragma once
+
+// Heap accounting for host-side tests (env:native).
+// env:native links with --wrap for malloc/free/realloc/calloc, so every C
+// allocation made from test code (ArduinoJson, String, operator new) lands
+// here. Include from exactly one translation unit per test binary.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+
+struct HostHeap {
+    uint32_t allocs;        // allocation calls since start
+    size_t liveBytes;       // currently allocated
+    size_t peakBytes;       // high-water mark of liveBytes
+
+    static HostHeap& stats() {
+        static HostHeap h = {0, 0, 0};
+        return h;
+    }
+    // Restart the high-water mark from the current live size
+    static void resetPeak() { stats().peakBytes = stats().liveBytes; }
+
+    static void track(void* p) {
+        if (!p) return;
+        HostHeap& h = stats();
+        h.allocs++;
+        h.liveBytes += malloc_usable_size(p);
+        if (h.liveBytes > h.peakBytes) h.peakBytes = h.liveBytes;
+    }
+    static void untrack(void* p) {
+        if (!p) return;
+        stats().liveBytes -= malloc_usable_size(p);
+    }
+};
+
+extern "C" {
+void* __real_malloc(size_t size);
+void __real_free(void* p);
+void* __real_realloc(void* p, size_t size);
+void* __real_calloc(size_t n, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    HostHeap::track(p);
+    return p;
+}
+void __wrap_free(void* p) {
+    HostHeap::untrack(p);
+    __real_free(p);
+}
+void* __wrap_realloc(void* p, size_t size) {
+    HostHeap::untrack(p);
+    void* q = __real_realloc(p, size);
+    // A failed realloc leaves the old block in place
+    HostHeap::track(q ? q : (size ? p : nullptr));
+    return q;
+}
+void* __wrap_calloc(size_t n, size_t size) {
+    void* p = __real_calloc(n, size);
+    HostHeap::track(p);
+    return p;
+}
+}
+
+void* operator new(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
@@ -0,0 +1,110 @@
+#ifdef UNIT_TEST
+
+// AckCoalescer, EspNow's deferred telemetry acks (pio test -e native -f test_native_ack_coalescer)
+//
+// The tests play loop(): note() for every frame that wants an ack, flush()
+// with a recording send function. Covers one cumulative ack per window,
+// piggybacking on other traffic and the full-table fallback.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "../../src/comm/AckCoalescer.h"
+
+struct SentAck {
+    MacKey peer;
+    uint16_t seq;
+    uint8_t count;
+};
+
+struct Recorder {
+    std::vector<SentAck> acks;
+    void operator()(MacKey peer, uint16_t seq, uint8_t count) { acks.push_back(SentAck{peer, seq, count}); }
+};
+
+static const uint8_t PEER_A[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x0A };
+static const uint8_t PEER_B[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x0B };
+
+void test_one_cumulative_ack_per_window() {
+    AckCoalescer acks;
+    Recorder sent;
+    for (uint16_t seq = 10; seq < 15; seq++) {
+        TEST_ASSERT_TRUE(acks.note(macKey(PEER_A), seq, 1000 + seq));
+    }
+    TEST_ASSERT_TRUE(acks.note(macKey(PEER_B), 7, 3000));
+
+    // Nothing is due before the first frame's window closes
+    acks.flush(1000 + 10 + AckCoalescer::WINDOW_MS - 1, std::ref(sent));
+    TEST_ASSERT_EQUAL(0, sent.acks.size());
+
+    acks.flush(1000 + 10 + AckCoalescer::WINDOW_MS, std::ref(sent));
+    TEST_ASSERT_EQUAL(1, sent.acks.size());
+    TEST_ASSERT_TRUE(sent.acks[0].peer == macKey(PEER_A));
+    TEST_ASSERT_EQUAL(14, sent.acks[0].seq);
+    TEST_ASSERT_EQUAL(5, sent.acks[0].count);
+    TEST_ASSERT_EQUAL(1, acks.pending());
+
+    acks.flush(3000 + AckCoalescer::WINDOW_MS, std::ref(sent));
+    TEST_ASSERT_EQUAL(2, sent.acks.size());
+    TEST_ASSERT_TRUE(sent.acks[1].peer == macKey(PEER_B));
+    TEST_ASSERT_EQUAL(1, sent.acks[1].count);
+    TEST_ASSERT_EQUAL(0, acks.pending());
+
+    TEST_ASSERT_EQUAL(6, acks.counters().noted);
+    TEST_ASSERT_EQUAL(2, acks.counters().sent);
+}
+
+void test_other_traffic_cancels_the_owed_ack() {
+    AckCoalescer acks;
+    Recorder sent;
+    acks.note(macKey(PEER_A), 1, 0);
+    acks.note(macKey(PEER_B), 1, 0);
+    acks.piggyback(macKey(PEER_A));
+    acks.piggyback(macKey(PEER_A)); // nothing owed any more: not counted twice
+
+    acks.flush(AckCoalescer::WINDOW_MS, std::ref(sent));
+    TEST_ASSERT_EQUAL(1, sent.acks.size());
+    TEST_ASSERT_TRUE(sent.acks[0].peer == macKey(PEER_B));
+    TEST_ASSERT_EQUAL(1, acks.counters().piggybacked);
+
+    // A new frame after the piggyback starts a fresh window
+    acks.note(macKey(PEER_A), 2, 6000);
+    acks.flush(6000 + AckCoalescer::WINDOW_MS - 1, std::ref(sent));
+    TEST_ASSERT_EQUAL(1, sent.acks.size());
+}
+
+void test_full_table_asks_for_an_immediate_ack() {
+    AckCoalescer acks;
+    uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x00 };
+    size_t accepted = 0;
+    for (int i = 0; i < 255; i++) {
+        mac[5] = (uint8_t)i;
+        if (acks.note(macKey(mac), 1, 0)) accepted++;
+    }
+    TEST_ASSERT_EQUAL(acks.pending(), accepted);
+    TEST_ASSERT_TRUE(accepted < 255);
+    TEST_ASSERT_TRUE(accepted >= MAX_FLEET_TOWERS);  // only towers past the fleet limit fall back
+
+    // Peers already owed an ack still coalesce while the table is full
+    mac[5] = 0;
+    TEST_ASSERT_TRUE(acks.note(macKey(mac), 2, 10));
+
+    Recorder sent;
+    acks.flush(AckCoalescer::WINDOW_MS, std::ref(sent));
+    TEST_ASSERT_EQUAL(accepted, sent.acks.size());
+    TEST_ASSERT_EQUAL(0, acks.pending());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_cumulative_ack_per_window);
+    RUN_TEST(test_other_traffic_cancels_the_owed_ack);
+    RUN_TEST(test_full_table_asks_for_an_immediate_ack);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
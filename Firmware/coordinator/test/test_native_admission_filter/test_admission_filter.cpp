@@ -0,0 +1,109 @@
+#ifdef UNIT_TEST
+
+// AdmissionFilter, EspNow's first check on every received frame
+// (pio test -e native -f test_native_admission_filter)
+//
+// Covers known peers, the join window, non-pairing frames from strangers, the
+// per-sender and global token buckets and a storm of random source MACs.
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/comm/AdmissionFilter.h"
+
+static MacKey tower(uint8_t n) {
+    const uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0x00, 0x01, n };
+    return macKey(mac);
+}
+
+static int parsed;  // how often the filter had to look at a frame's type
+
+static AdmissionFilter::Verdict check(AdmissionFilter& f, MacKey sender, bool open, uint32_t now, bool pairing = true) {
+    return f.check(sender, open, now, [&]() { parsed++; return pairing; });
+}
+
+void test_known_peers_pass_without_looking_at_the_frame() {
+    AdmissionFilter f;
+    parsed = 0;
+    TEST_ASSERT_TRUE(f.allow(tower(1)));
+    for (uint32_t t = 0; t < 100; t++) {
+        TEST_ASSERT_TRUE(check(f, tower(1), false, t, false) == AdmissionFilter::Verdict::KNOWN);
+    }
+    TEST_ASSERT_EQUAL(0, parsed);
+    TEST_ASSERT_EQUAL(100, f.counters().known);
+
+    f.disallow(tower(1));
+    TEST_ASSERT_FALSE(f.isKnown(tower(1)));
+    TEST_ASSERT_TRUE(check(f, tower(1), false, 100) == AdmissionFilter::Verdict::NOT_OPEN);
+}
+
+void test_strangers_need_an_open_window_and_a_pairing_frame() {
+    AdmissionFilter f;
+    parsed = 0;
+    TEST_ASSERT_TRUE(check(f, tower(7), false, 0) == AdmissionFilter::Verdict::NOT_OPEN);
+    TEST_ASSERT_EQUAL(0, parsed);  // rejected before the type is read
+    TEST_ASSERT_TRUE(check(f, tower(7), true, 0, false) == AdmissionFilter::Verdict::NOT_PAIRING);
+    TEST_ASSERT_TRUE(check(f, tower(7), true, 0) == AdmissionFilter::Verdict::JOINING);
+    TEST_ASSERT_EQUAL(2, parsed);
+
+    const AdmissionFilter::Counters& c = f.counters();
+    TEST_ASSERT_EQUAL(1, c.notOpen);
+    TEST_ASSERT_EQUAL(1, c.notPairing);
+    TEST_ASSERT_EQUAL(1, c.joining);
+    TEST_ASSERT_EQUAL(2, f.dropped());
+}
+
+void test_one_joining_sender_is_rate_limited() {
+    AdmissionFilter f;
+    uint32_t t = 1000;
+    for (uint8_t i = 0; i < AdmissionFilter::BUCKET_SIZE; i++) {
+        TEST_ASSERT_TRUE(check(f, tower(3), true, t) == AdmissionFilter::Verdict::JOINING);
+    }
+    TEST_ASSERT_TRUE(check(f, tower(3), true, t) == AdmissionFilter::Verdict::RATE_LIMITED);
+    TEST_ASSERT_TRUE(check(f, tower(3), true, t + AdmissionFilter::REFILL_MS - 1) == AdmissionFilter::Verdict::RATE_LIMITED);
+
+    // One token back per refill period, never more than the bucket holds
+    t += AdmissionFilter::REFILL_MS;
+    TEST_ASSERT_TRUE(check(f, tower(3), true, t) == AdmissionFilter::Verdict::JOINING);
+    TEST_ASSERT_TRUE(check(f, tower(3), true, t) == AdmissionFilter::Verdict::RATE_LIMITED);
+    t += 100 * AdmissionFilter::REFILL_MS;
+    uint8_t passed = 0;
+    for (int i = 0; i < 10; i++) passed += check(f, tower(3), true, t) == AdmissionFilter::Verdict::JOINING;
+    TEST_ASSERT_EQUAL(AdmissionFilter::BUCKET_SIZE, passed);
+
+    // Another sender has its own bucket
+    TEST_ASSERT_TRUE(check(f, tower(4), true, t) == AdmissionFilter::Verdict::JOINING);
+}
+
+void test_random_mac_storm_is_capped_and_known_peers_unaffected() {
+    AdmissionFilter f;
+    f.allow(tower(1));
+    uint32_t rng = 12345;
+    uint32_t joined = 0, known = 0;
+    const uint32_t SECONDS = 10;
+    // 1000 frames a second, each from a fresh random MAC, plus one from a known tower
+    for (uint32_t ms = 0; ms < SECONDS * 1000; ms++) {
+        rng = rng * 1103515245u + 12345u;
+        MacKey stranger = ((MacKey)rng << 16 | (rng >> 8)) & 0xFEFFFFFFFFFFull;
+        joined += check(f, stranger, true, ms) == AdmissionFilter::Verdict::JOINING;
+        known += check(f, tower(1), true, ms) == AdmissionFilter::Verdict::KNOWN;
+    }
+    TEST_ASSERT_EQUAL(SECONDS * 1000, known);
+    uint32_t cap = AdmissionFilter::GLOBAL_BUCKET_SIZE + SECONDS * 1000 / AdmissionFilter::GLOBAL_REFILL_MS;
+    TEST_ASSERT_TRUE(joined <= cap);
+    TEST_ASSERT_EQUAL(SECONDS * 1000 - joined, f.counters().rateLimited);
+    TEST_ASSERT_EQUAL(1, f.knownCount());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_known_peers_pass_without_looking_at_the_frame);
+    RUN_TEST(test_strangers_need_an_open_window_and_a_pairing_frame);
+    RUN_TEST(test_one_joining_sender_is_rate_limited);
+    RUN_TEST(test_random_mac_storm_is_capped_and_known_peers_unaffected);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,144 @@
+#ifdef UNIT_TEST
+
+// Host benchmark for MessageFactory::decode()  (pio test -e native -f test_native_decode)
+//
+// "Before" replays the receive path as it was before decode() existed: EspNow
+// copied the frame into a String and sniffed the type, Reservoir sniffed it
+// again to pick a branch, and createMessage() sniffed it a third time before
+// parsing the whole frame. "After" is the single decode() call EspNow makes now.
+// Parses come from MessageFactory::jsonParseCount(); allocations are counted
+// by HostHeap (see env:native).
+
+#include <unity.h>
+#include <Arduino.h>
+#include <HostHeap.h>
+#include "../../../shared/src/EspNowMessage.cpp"
+
+struct PathCost {
+    float parses;
+    float allocs;
+    int failures;
+};
+
+static const int ITERATIONS = 200;
+
+static EspNowMessage* legacyReceive(const uint8_t* data, size_t len) {
+    String payload((const char*)data, len);          // EspNow: copy for getMessageType()
+    MessageFactory::getMessageType(payload);         // EspNow: join_request or not
+    MessageFactory::getMessageType(payload);         // Reservoir: pick the branch
+    MessageFactory::getMessageType(payload);         // createMessage: pick the class
+    return MessageFactory::createMessage(payload);   // createMessage: fill the fields
+}
+
+static EspNowMessage* currentReceive(const uint8_t* data, size_t len) {
+    return MessageFactory::decode(data, len);
+}
+
+static PathCost measure(EspNowMessage* (*receive)(const uint8_t*, size_t), const uint8_t* data, size_t len) {
+    uint32_t parses = MessageFactory::jsonParseCount();
+    uint32_t allocs = HostHeap::stats().allocs;
+    PathCost cost;
+    cost.failures = 0;
+    for (int i = 0; i < ITERATIONS; i++) {
+        EspNowMessage* msg = receive(data, len);
+        if (!msg) cost.failures++;
+        delete msg;
+    }
+    cost.parses = (float)(MessageFactory::jsonParseCount() - parses) / ITERATIONS;
+    cost.allocs = (float)(HostHeap::stats().allocs - allocs) / ITERATIONS;
+    return cost;
+}
+
+static void compare(const char* name, const String& frame) {
+    // Frames go over the air with their trailing NUL
+    const uint8_t* data = (const uint8_t*)frame.c_str();
+    const size_t len = frame.length() + 1;
+    PathCost before = measure(legacyReceive, data, len);
+    PathCost after = measure(currentReceive, data, len);
+    printf("  %-16s %4uB  parses/frame %.1f -> %.1f   allocs/frame %.1f -> %.1f\n",
+           name, (unsigned)len, before.parses, after.parses, before.allocs, after.allocs);
+
+    TEST_ASSERT_EQUAL(0, before.failures);
+    TEST_ASSERT_EQUAL(0, after.failures);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, before.parses);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, after.parses);
+    TEST_ASSERT_TRUE(after.allocs < before.allocs);
+}
+
+static String nodeStatusFrame() {
+    NodeStatusMessage m;
+    m.node_id = "AA:BB:CC:DD:EE:01";
+    m.light_id = "LDDEE01";
+    m.avg_r = 12; m.avg_g = 34; m.avg_b = 56; m.avg_w = 78;
+    m.status_mode = StatusMode::OPERATIONAL;
+    m.vbat_mv = 3710;
+    m.temperature = 23.25f;
+    m.fw = "2.1.0";
+    return m.toJson();
+}
+
+static String towerTelemetryFrame() {
+    TowerTelemetryMessage m;
+    m.tower_id = "T0A1B2C";
+    m.air_temp_c = 24.5f;
+    m.humidity_pct = 61.0f;
+    m.light_lux = 830.0f;
+    m.pump_on = true;
+    m.light_on = true;
+    m.light_brightness = 200;
+    m.status_mode = StatusMode::OPERATIONAL;
+    m.uptime_s = 86400;
+    m.fw = "2.1.0";
+    return m.toJson();
+}
+
+static String setLightFrame() {
+    SetLightMessage m;
+    m.cmd_id = "c-1042";
+    m.light_id = "LDDEE01";
+    m.r = 255; m.g = 128; m.b = 0; m.w = 10;
+    m.value = 200;
+    m.fade_ms = 250;
+    return m.toJson();
+}
+
+void test_decode_node_status_json() {
+    compare("node_status", nodeStatusFrame());
+}
+
+void test_decode_tower_telemetry_json() {
+    compare("tower_telemetry", towerTelemetryFrame());
+}
+
+void test_decode_set_light_json() {
+    compare("set_light", setLightFrame());
+}
+
+void test_decode_compact_frames_skip_parser() {
+    NodeStatusMessage m;
+    m.node_id = "AA:BB:CC:DD:EE:01";
+    m.status_mode = StatusMode::OPERATIONAL;
+    uint8_t buf[NodeStatusMessage::BINARY_SIZE];
+    size_t n = m.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(NodeStatusMessage::BINARY_SIZE, n);
+
+    PathCost cost = measure(currentReceive, buf, n);
+    printf("  %-16s %4uB  parses/frame %.1f   allocs/frame %.1f\n",
+           "node_status bin", (unsigned)n, cost.parses, cost.allocs);
+    TEST_ASSERT_EQUAL(0, cost.failures);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, cost.parses);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_decode_node_status_json);
+    RUN_TEST(test_decode_tower_telemetry_json);
+    RUN_TEST(test_decode_set_light_json);
+    RUN_TEST(test_decode_compact_frames_skip_parser);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,185 @@
+#ifdef UNIT_TEST
+
+// Heap soak for MessageFactory::decode() into a MessageSlot
+// (pio test -e native -f test_native_decode_soak)
+//
+// Replays a mix of JSON and compact frames through one reused slot, the way
+// EspNow::processReceivedData() does, and checks that the heap high-water mark
+// stops moving once the first round has warmed up. The same mix through the
+// heap-owning decode() is measured alongside for comparison.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <HostHeap.h>
+#include <vector>
+#include "../../../shared/src/EspNowMessage.cpp"
+
+static const int FRAMES = 100000;
+
+struct Frame {
+    std::vector<uint8_t> bytes;
+};
+
+static std::vector<Frame> g_frames;
+
+static void addJson(const EspNowMessage& m) {
+    String json = m.toJson();
+    Frame f;
+    // Frames go over the air with their trailing NUL
+    f.bytes.assign((const uint8_t*)json.c_str(), (const uint8_t*)json.c_str() + json.length() + 1);
+    g_frames.push_back(f);
+}
+
+static void addBinary(const uint8_t* buf, size_t n) {
+    Frame f;
+    f.bytes.assign(buf, buf + n);
+    g_frames.push_back(f);
+}
+
+static void buildFrames() {
+    g_frames.clear();
+
+    NodeStatusMessage status;
+    status.node_id = "AA:BB:CC:DD:EE:01";
+    status.light_id = "LDDEE01";
+    status.avg_r = 12; status.avg_g = 34; status.avg_b = 56; status.avg_w = 78;
+    status.status_mode = StatusMode::OPERATIONAL;
+    status.vbat_mv = 3710;
+    status.temperature = 23.25f;
+    status.fw = "2.1.0";
+    addJson(status);
+    uint8_t statusBin[NodeStatusMessage::BINARY_SIZE];
+    addBinary(statusBin, status.toBinary(statusBin, sizeof(statusBin)));
+
+    TowerTelemetryMessage tele;
+    tele.tower_id = "T0A1B2C";
+    tele.air_temp_c = 24.5f;
+    tele.humidity_pct = 61.0f;
+    tele.light_lux = 830.0f;
+    tele.pump_on = true;
+    tele.status_mode = StatusMode::OPERATIONAL;
+    tele.uptime_s = 86400;
+    tele.fw = "2.1.0";
+    addJson(tele);
+    uint8_t teleBin[TowerTelemetryMessage::BINARY_SIZE];
+    addBinary(teleBin, tele.toBinary(teleBin, sizeof(teleBin)));
+
+    SetLightMessage light;
+    light.cmd_id = "c-1042";
+    light.light_id = "LDDEE01";
+    light.r = 255; light.g = 128;
+    light.value = 200;
+    light.fade_ms = 250;
+    addJson(light);
+
+    JoinRequestMessage join;
+    join.mac = "AA:BB:CC:DD:EE:02";
+    join.fw = "2.1.0";
+    join.token = "tok-8812";
+    addJson(join);
+
+    AckMessage ack;
+    ack.cmd_id = "c-1042";
+    addJson(ack);
+
+    // Undecodable frames must not leak either
+    const char broken[] = "{\"msg\":\"set_light\"";
+    addBinary((const uint8_t*)broken, sizeof(broken) - 1);
+}
+
+static size_t runSlot(MessageSlot& slot, int frames, int& failures) {
+    size_t bytes = 0;
+    for (int i = 0; i < frames; i++) {
+        const Frame& f = g_frames[i % g_frames.size()];
+        EspNowMessage* msg = MessageFactory::decode(f.bytes.data(), f.bytes.size(), slot);
+        if (!msg) failures++;
+        bytes += f.bytes.size();
+    }
+    return bytes;
+}
+
+static void runHeap(int frames, int& failures) {
+    for (int i = 0; i < frames; i++) {
+        const Frame& f = g_frames[i % g_frames.size()];
+        EspNowMessage* msg = MessageFactory::decode(f.bytes.data(), f.bytes.size());
+        if (!msg) failures++;
+        delete msg;
+    }
+}
+
+void test_slot_decode_heap_stays_flat() {
+    buildFrames();
+    MessageSlot slot;
+    int failures = 0;
+
+    // Warm-up: a couple of passes over the mix let String members reach their
+    // steady size; the peak it leaves behind is the baseline for the soak
+    HostHeap::resetPeak();
+    runSlot(slot, (int)g_frames.size() * 2, failures);
+    const size_t warmPeak = HostHeap::stats().peakBytes;
+    const uint32_t allocsBefore = HostHeap::stats().allocs;
+    failures = 0;
+    size_t bytes = runSlot(slot, FRAMES, failures);
+    const uint32_t slotAllocs = HostHeap::stats().allocs - allocsBefore;
+    const size_t slotPeak = HostHeap::stats().peakBytes;
+
+    int heapFailures = 0;
+    const uint32_t heapBefore = HostHeap::stats().allocs;
+    runHeap(FRAMES, heapFailures);
+    const uint32_t heapAllocs = HostHeap::stats().allocs - heapBefore;
+
+    printf("  %d frames (%u KB)  peak %uB after warm-up, %uB after soak  allocs/frame slot %.2f heap %.2f\n",
+           FRAMES, (unsigned)(bytes / 1024), (unsigned)warmPeak, (unsigned)slotPeak,
+           (float)slotAllocs / FRAMES, (float)heapAllocs / FRAMES);
+
+    // Only the truncated frame fails, on both paths
+    TEST_ASSERT_EQUAL(FRAMES / (int)g_frames.size(), failures);
+    TEST_ASSERT_EQUAL(failures, heapFailures);
+    // High-water mark does not grow with frame count once warmed up
+    TEST_ASSERT_EQUAL(warmPeak, slotPeak);
+    TEST_ASSERT_TRUE(slotAllocs < heapAllocs);
+}
+
+void test_slot_releases_message_on_reset() {
+    buildFrames();
+    const size_t liveBefore = HostHeap::stats().liveBytes;
+    {
+        MessageSlot slot;
+        int failures = 0;
+        runSlot(slot, (int)g_frames.size(), failures);
+    }
+    TEST_ASSERT_EQUAL(liveBefore, HostHeap::stats().liveBytes);
+}
+
+void test_slot_decode_compact_frames_allocation_free() {
+    // Inline string fields: a compact frame decoded into a slot never touches the heap
+    TowerTelemetryMessage tele;
+    tele.tower_id = "T0A1B2C";
+    tele.status_mode = StatusMode::OPERATIONAL;
+    tele.fw = "2.1.0";
+    uint8_t buf[TowerTelemetryMessage::BINARY_SIZE];
+    size_t n = tele.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(TowerTelemetryMessage::BINARY_SIZE, n);
+
+    MessageSlot slot;
+    const uint32_t before = HostHeap::stats().allocs;
+    for (int i = 0; i < 1000; i++) {
+        EspNowMessage* msg = MessageFactory::decode(buf, n, slot);
+        TEST_ASSERT_NOT_NULL(msg);
+    }
+    TEST_ASSERT_EQUAL(0, HostHeap::stats().allocs - before);
+    TEST_ASSERT_EQUAL_STRING("T0A1B2C", static_cast<TowerTelemetryMessage*>(slot.get())->tower_id.c_str());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_slot_decode_heap_stays_flat);
+    RUN_TEST(test_slot_releases_message_on_reset);
+    RUN_TEST(test_slot_decode_compact_frames_allocation_free);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,78 @@
+#ifdef UNIT_TEST
+
+// Send-path allocations  (pio test -e native -f test_native_encode)
+//
+// encode() writes a message into a caller-provided frame through a
+// StaticJsonDocument, so building a frame to send must not touch the heap.
+// toJson() is measured alongside for comparison.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <HostHeap.h>
+#include "../../../shared/src/EspNowMessage.cpp"
+
+static const int ITERATIONS = 200;
+
+static uint32_t encodeAllocs(const EspNowMessage& m, size_t& len) {
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    const uint32_t before = HostHeap::stats().allocs;
+    for (int i = 0; i < ITERATIONS; i++) {
+        len = m.encode(frame, sizeof(frame));
+    }
+    return HostHeap::stats().allocs - before;
+}
+
+static uint32_t toJsonAllocs(const EspNowMessage& m) {
+    const uint32_t before = HostHeap::stats().allocs;
+    for (int i = 0; i < ITERATIONS; i++) {
+        String json = m.toJson();
+    }
+    return HostHeap::stats().allocs - before;
+}
+
+static void check(const EspNowMessage& m) {
+    size_t len = 0;
+    uint32_t encoded = encodeAllocs(m, len);
+    uint32_t legacy = toJsonAllocs(m);
+    printf("  %-16s %4uB  allocs/send toJson %.1f -> encode %.1f\n",
+           m.msg, (unsigned)len, (float)legacy / ITERATIONS, (float)encoded / ITERATIONS);
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_EQUAL(0, encoded);
+}
+
+void test_encode_set_light_allocation_free() {
+    SetLightMessage m;
+    m.cmd_id = "123456-0A1B2C";
+    m.r = 255; m.g = 128; m.w = 10;
+    m.fade_ms = 250;
+    check(m);
+}
+
+void test_encode_ack_allocation_free() {
+    AckMessage m;
+    m.cmd_id = "tower_telemetry_ack";
+    check(m);
+}
+
+void test_encode_node_status_allocation_free() {
+    NodeStatusMessage m;
+    m.node_id = "N0A1B2C";
+    m.light_id = "N0A1B2C";
+    m.status_mode = StatusMode::OPERATIONAL;
+    m.temperature = 23.25f;
+    m.fw = "2.1.0";
+    check(m);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_encode_set_light_allocation_free);
+    RUN_TEST(test_encode_ack_allocation_free);
+    RUN_TEST(test_encode_node_status_allocation_free);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
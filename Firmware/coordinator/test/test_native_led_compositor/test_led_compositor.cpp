@@ -0,0 +1,118 @@
+#ifdef UNIT_TEST
+
+// LedCompositor, Reservoir's per-group status LED rendering
+// (pio test -e native -f test_native_led_compositor)
+//
+// Covers pushing only changed groups, skipping show() when nothing changed,
+// the frame rate cap coalescing changes, and repainting after invalidate().
+
+#include <unity.h>
+#include <Arduino.h>
+#include <vector>
+#include "../../src/utils/LedCompositor.h"
+
+typedef LedCompositor<4> Leds;
+
+struct Strip {
+    uint8_t px[16][3] = {};
+    std::vector<size_t> written;  // pixel indices written since the last show()
+    uint32_t shows = 0;
+
+    bool render(Leds& leds, uint32_t now) {
+        written.clear();
+        return leds.render(now,
+                           [this](size_t i, uint8_t r, uint8_t g, uint8_t b) {
+                               px[i][0] = r; px[i][1] = g; px[i][2] = b;
+                               written.push_back(i);
+                           },
+                           [this]() { shows++; });
+    }
+};
+
+void test_first_frame_paints_everything_then_only_changes() {
+    Leds leds;
+    Strip strip;
+    TEST_ASSERT_TRUE(strip.render(leds, 0));
+    TEST_ASSERT_EQUAL(16, strip.written.size());
+
+    leds.setGroup(2, 0, 45, 0);
+    TEST_ASSERT_TRUE(strip.render(leds, 100));
+    TEST_ASSERT_EQUAL(4, strip.written.size());
+    for (size_t k = 0; k < 4; k++) {
+        TEST_ASSERT_EQUAL(8 + k, strip.written[k]);
+        TEST_ASSERT_EQUAL(45, strip.px[8 + k][1]);
+    }
+    TEST_ASSERT_EQUAL(2, strip.shows);
+}
+
+void test_unchanged_state_does_not_reach_the_strip() {
+    Leds leds;
+    Strip strip;
+    strip.render(leds, 0);
+    uint32_t now = 0;
+    // Loop restating the same colours, as Reservoir::updateLeds does
+    for (int i = 0; i < 1000; i++) {
+        for (size_t g = 0; g < 4; g++) leds.setGroup(g, 90, 0, 0);
+        strip.render(leds, now += 5);
+    }
+    TEST_ASSERT_EQUAL(2, strip.shows);  // first frame, then the one change to red
+    TEST_ASSERT_EQUAL(2, leds.counters().frames);
+    TEST_ASSERT_EQUAL(999, leds.counters().avoided());
+    TEST_ASSERT_FALSE(leds.dirty());
+}
+
+void test_frame_rate_caps_and_coalesces_changes() {
+    Leds leds;
+    leds.setFrameRate(10);  // 100 ms frames
+    TEST_ASSERT_EQUAL(10, leds.frameRate());
+    Strip strip;
+    strip.render(leds, 0);
+
+    // A flash toggled every 10 ms for a second: at most one push per frame
+    uint32_t now = 0;
+    for (int i = 1; i <= 100; i++) {
+        leds.setGroup(0, 0, (i & 1) ? 128 : 45, 0);
+        strip.render(leds, now += 10);
+    }
+    TEST_ASSERT_TRUE(strip.shows <= 1 + 10);
+    TEST_ASSERT_TRUE(leds.counters().deferred >= 80);
+    // The last state always lands once the interval allows
+    leds.setGroup(0, 0, 45, 0);
+    while (leds.dirty()) strip.render(leds, now += 10);
+    TEST_ASSERT_EQUAL(45, strip.px[0][1]);
+
+    leds.setFrameRate(0);  // out of range: default
+    TEST_ASSERT_EQUAL(Leds::DEFAULT_FPS, leds.frameRate());
+}
+
+void test_invalidate_repaints_every_group() {
+    Leds leds;
+    Strip strip;
+    for (size_t g = 0; g < 4; g++) leds.setGroup(g, 0, 45, 0);
+    strip.render(leds, 0);
+    // Something else drew over the strip (StatusLed::pulse)
+    for (size_t i = 0; i < 16; i++) strip.px[i][0] = 180;
+    leds.invalidate();
+    TEST_ASSERT_TRUE(strip.render(leds, 100));
+    TEST_ASSERT_EQUAL(16, strip.written.size());
+    for (size_t i = 0; i < 16; i++) {
+        TEST_ASSERT_EQUAL(0, strip.px[i][0]);
+        TEST_ASSERT_EQUAL(45, strip.px[i][1]);
+    }
+    leds.setGroup(9, 1, 2, 3);  // past the last group: ignored
+    TEST_ASSERT_FALSE(leds.dirty());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_frame_paints_everything_then_only_changes);
+    RUN_TEST(test_unchanged_state_does_not_reach_the_strip);
+    RUN_TEST(test_frame_rate_caps_and_coalesces_changes);
+    RUN_TEST(test_invalidate_repaints_every_group);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
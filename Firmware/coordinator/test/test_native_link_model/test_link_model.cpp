@@ -0,0 +1,106 @@
+#ifdef UNIT_TEST
+
+// LinkModel, EspNow's per-peer link quality (pio test -e native -f test_native_link_model)
+//
+// Feeds synthetic receive times, RSSI readings, sequence gaps and send
+// results and checks that each estimate settles where it should.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+#include "../../src/comm/LinkModel.h"
+
+void test_rssi_is_smoothed_and_unknown_readings_skipped() {
+    LinkModel m;
+    TEST_ASSERT_EQUAL_FLOAT((float)LinkModel::RSSI_UNKNOWN, m.rssi());
+    m.onReceive(LinkModel::RSSI_UNKNOWN, 100);
+    TEST_ASSERT_FALSE(m.hasRssi);
+
+    m.onReceive(-60, 200);
+    TEST_ASSERT_EQUAL_FLOAT(-60.0f, m.rssi());
+    // A single outlier moves the average by an eighth of the difference
+    m.onReceive(-92, 300);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, -64.0f, m.rssi());
+    for (int i = 0; i < 100; i++) m.onReceive(-70, 400 + i * 100);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, -70.0f, m.rssi());
+}
+
+void test_loss_follows_sequence_gaps() {
+    LinkModel m;
+    for (int i = 0; i < 50; i++) m.onSequence(0);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, m.loss());
+
+    // One frame in ten missing
+    for (int i = 0; i < 200; i++) m.onSequence(i % 9 == 0 ? 1 : 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.06f, 0.1f, m.loss());
+
+    // A huge gap is capped, so one restart does not read as total loss forever
+    m.onSequence(5000);
+    for (int i = 0; i < 100; i++) m.onSequence(0);
+    TEST_ASSERT_TRUE(m.loss() < 0.01f);
+}
+
+void test_tx_failure_share() {
+    LinkModel m;
+    for (int i = 0; i < 400; i++) m.onTxAttempt(i % 4 != 0);  // every fourth attempt fails
+    TEST_ASSERT_FLOAT_WITHIN(0.08f, 0.25f, m.txFailure());
+    for (int i = 0; i < 200; i++) m.onTxAttempt(true);
+    TEST_ASSERT_TRUE(m.txFailure() < 0.01f);
+}
+
+void test_jitter_of_steady_and_uneven_arrivals() {
+    LinkModel steady;
+    for (uint32_t t = 1000; t < 60000; t += 1000) steady.onReceive(-60, t);
+    TEST_ASSERT_EQUAL(1000, steady.intervalMs());
+    TEST_ASSERT_EQUAL(0, steady.jitterMs());
+
+    // Alternating 800 / 1200 ms: mean near 1000, deviation near 200
+    LinkModel uneven;
+    uint32_t t = 1000;
+    for (int i = 0; i < 200; i++) {
+        t += (i % 2) ? 1200 : 800;
+        uneven.onReceive(-60, t);
+    }
+    TEST_ASSERT_UINT32_WITHIN(100, 1000, uneven.intervalMs());
+    TEST_ASSERT_UINT32_WITHIN(60, 200, uneven.jitterMs());
+}
+
+void test_snapshots_sort_worst_link_first() {
+    LinkModel good, retrying, lossy;
+    good.onReceive(-55, 100);
+    for (int i = 0; i < 100; i++) {
+        good.onTxAttempt(true);
+        retrying.onTxAttempt(i % 2 == 0);
+        lossy.onTxAttempt(true);
+        lossy.onSequence(i % 5 == 0 ? 1 : 0);
+    }
+    std::vector<LinkSnapshot> rows;
+    rows.push_back(LinkSnapshot::of(1, good, 1100));
+    rows.push_back(LinkSnapshot::of(2, lossy, 1100));
+    rows.push_back(LinkSnapshot::of(3, retrying, 1100));
+    std::sort(rows.begin(), rows.end(), LinkSnapshot::worse);
+
+    TEST_ASSERT_TRUE(rows[0].peer == 3);
+    TEST_ASSERT_TRUE(rows[1].peer == 2);
+    TEST_ASSERT_TRUE(rows[2].peer == 1);
+    TEST_ASSERT_EQUAL(-550, rows[2].rssiDeci);
+    TEST_ASSERT_EQUAL(1000, rows[2].ageMs);
+    TEST_ASSERT_EQUAL(LinkModel::RSSI_UNKNOWN * 10, rows[0].rssiDeci);
+    TEST_ASSERT_TRUE(rows[0].ageMs == UINT32_MAX);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rssi_is_smoothed_and_unknown_readings_skipped);
+    RUN_TEST(test_loss_follows_sequence_gaps);
+    RUN_TEST(test_tx_failure_share);
+    RUN_TEST(test_jitter_of_steady_and_uneven_arrivals);
+    RUN_TEST(test_snapshots_sort_worst_link_first);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
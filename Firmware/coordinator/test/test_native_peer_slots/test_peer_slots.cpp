@@ -0,0 +1,133 @@
+#ifdef UNIT_TEST
+
+// PeerSlots, EspNow's on-demand radio peer registration
+// (pio test -e native -f test_native_peer_slots)
+//
+// A mock radio holds at most 20 peers like ESP-NOW (one of them broadcast)
+// and refuses sends to peers it does not have. Covers a rack larger than the
+// radio, LRU eviction, peers with a frame in flight and release().
+
+#include <unity.h>
+#include <Arduino.h>
+#include <set>
+#include "../../src/comm/PeerSlots.h"
+
+struct MockRadio {
+    static const size_t LIMIT = 20;
+    std::set<MacKey> peers;
+    size_t highWater = 0;
+
+    MockRadio() { peers.insert(0xFFFFFFFFFFFFull); }  // broadcast, registered at boot
+
+    bool add(const uint8_t* mac) {
+        if (peers.size() >= LIMIT) return false;
+        peers.insert(macKey(mac));
+        if (peers.size() > highWater) highWater = peers.size();
+        return true;
+    }
+    bool del(const uint8_t* mac) { return peers.erase(macKey(mac)) == 1; }
+    bool send(MacKey peer) const { return peers.count(peer) == 1; }
+};
+
+static MacKey tower(uint8_t n) {
+    const uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0x00, 0x01, n };
+    return macKey(mac);
+}
+
+static bool acquire(PeerSlots& slots, MockRadio& radio, MacKey peer, const std::set<MacKey>& busy = std::set<MacKey>()) {
+    return slots.acquire(peer,
+        [&](const uint8_t* mac) { return radio.add(mac); },
+        [&](const uint8_t* mac) { return radio.del(mac); },
+        [&](MacKey p) { return busy.count(p) == 1; });
+}
+
+void test_rack_larger_than_the_radio() {
+    PeerSlots slots;
+    MockRadio radio;
+    const uint8_t TOWERS = 48;
+    uint32_t delivered = 0;
+    for (int round = 0; round < 10; round++) {
+        for (uint8_t t = 0; t < TOWERS; t++) {
+            TEST_ASSERT_TRUE(acquire(slots, radio, tower(t)));
+            if (radio.send(tower(t))) delivered++;
+        }
+    }
+    TEST_ASSERT_EQUAL(10 * TOWERS, delivered);
+    TEST_ASSERT_TRUE(radio.highWater <= MockRadio::LIMIT);
+    TEST_ASSERT_EQUAL(PeerSlots::SLOTS, slots.size());
+    TEST_ASSERT_EQUAL(PeerSlots::SLOTS + 1, radio.peers.size());
+    TEST_ASSERT_EQUAL(10 * TOWERS, slots.counters().misses);  // round robin over more than fits: all misses
+    TEST_ASSERT_EQUAL(0, slots.counters().failures);
+
+    // A working set that fits is all hits after the first touch
+    PeerSlots small;
+    MockRadio radio2;
+    for (int round = 0; round < 10; round++) {
+        for (uint8_t t = 0; t < 8; t++) acquire(small, radio2, tower(t));
+    }
+    TEST_ASSERT_EQUAL(8, small.counters().misses);
+    TEST_ASSERT_EQUAL(72, small.counters().hits);
+    TEST_ASSERT_EQUAL(0, small.counters().evictions);
+}
+
+void test_least_recently_used_peer_is_evicted() {
+    PeerSlots slots;
+    MockRadio radio;
+    for (uint8_t t = 0; t < PeerSlots::SLOTS; t++) acquire(slots, radio, tower(t));
+    acquire(slots, radio, tower(0));  // now the most recent
+
+    TEST_ASSERT_TRUE(acquire(slots, radio, tower(100)));
+    TEST_ASSERT_TRUE(slots.registered(tower(0)));
+    TEST_ASSERT_FALSE(slots.registered(tower(1)));
+    TEST_ASSERT_FALSE(radio.send(tower(1)));
+    TEST_ASSERT_EQUAL(1, slots.counters().evictions);
+}
+
+void test_peers_with_a_frame_in_flight_stay() {
+    PeerSlots slots;
+    MockRadio radio;
+    std::set<MacKey> busy;
+    for (uint8_t t = 0; t < PeerSlots::SLOTS; t++) acquire(slots, radio, tower(t));
+    busy.insert(tower(0));
+
+    TEST_ASSERT_TRUE(acquire(slots, radio, tower(100), busy));
+    TEST_ASSERT_TRUE(slots.registered(tower(0)));
+    TEST_ASSERT_FALSE(slots.registered(tower(1)));
+
+    // Every slot busy: nothing to evict, the caller retries later
+    slots.forEach([&](MacKey p) { busy.insert(p); });
+    TEST_ASSERT_FALSE(acquire(slots, radio, tower(101), busy));
+    TEST_ASSERT_EQUAL(1, slots.counters().failures);
+    TEST_ASSERT_EQUAL(PeerSlots::SLOTS, slots.size());
+}
+
+void test_release_and_forget() {
+    PeerSlots slots;
+    MockRadio radio;
+    acquire(slots, radio, tower(1));
+    acquire(slots, radio, tower(2));
+
+    TEST_ASSERT_TRUE(slots.release(tower(1), [&](const uint8_t* mac) { return radio.del(mac); }));
+    TEST_ASSERT_FALSE(slots.release(tower(1), [&](const uint8_t* mac) { return radio.del(mac); }));
+    TEST_ASSERT_FALSE(radio.send(tower(1)));
+
+    // The radio lost the peer on its own: the next acquire registers it again
+    radio.peers.erase(tower(2));
+    slots.forget(tower(2));
+    TEST_ASSERT_TRUE(acquire(slots, radio, tower(2)));
+    TEST_ASSERT_TRUE(radio.send(tower(2)));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rack_larger_than_the_radio);
+    RUN_TEST(test_least_recently_used_peer_is_evicted);
+    RUN_TEST(test_peers_with_a_frame_in_flight_stay);
+    RUN_TEST(test_release_and_forget);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,122 @@
+#ifdef UNIT_TEST
+
+// MacTable, EspNow's peer statistics table (pio test -e native -f test_native_peer_table)
+//
+// Fills the table with clustered MACs (same OUI, sequential device bytes, as
+// a batch of towers would have), erases in an order that exercises the probe
+// run shifting, and checks every remaining key against a reference map.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <map>
+#include "../../src/comm/PeerTable.h"
+
+typedef MacTable<uint32_t, 64> Table;
+
+static MacKey towerKey(uint32_t n) {
+    uint8_t mac[6] = { 0x24, 0x6F, 0x28, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n };
+    return macKey(mac);
+}
+
+static void checkAgainst(const Table& table, const std::map<MacKey, uint32_t>& ref) {
+    TEST_ASSERT_EQUAL(ref.size(), table.size());
+    for (const auto& kv : ref) {
+        const uint32_t* v = table.find(kv.first);
+        TEST_ASSERT_NOT_NULL(v);
+        TEST_ASSERT_EQUAL(kv.second, *v);
+    }
+}
+
+void test_mac_key_round_trip() {
+    const uint8_t mac[6] = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x01 };
+    MacKey key = macKey(mac);
+    TEST_ASSERT_TRUE(key == 0xAABBCCDDEE01ull);
+
+    MacKey parsed;
+    TEST_ASSERT_TRUE(macKeyFromString("AA:BB:CC:DD:EE:01", parsed));
+    TEST_ASSERT_TRUE(parsed == key);
+    TEST_ASSERT_TRUE(macKeyFromString("aa:bb:cc:dd:ee:01", parsed));
+    TEST_ASSERT_TRUE(parsed == key);
+    TEST_ASSERT_FALSE(macKeyFromString("AA:BB:CC:DD:EE", parsed));
+    TEST_ASSERT_FALSE(macKeyFromString("AA:BB:CC:DD:EE:01:02", parsed));
+    TEST_ASSERT_FALSE(macKeyFromString("AA-BB-CC-DD-EE-01", parsed));
+
+    uint8_t back[6];
+    macFromKey(key, back);
+    TEST_ASSERT_EQUAL_MEMORY(mac, back, 6);
+}
+
+void test_table_fills_to_capacity() {
+    Table table;
+    std::map<MacKey, uint32_t> ref;
+    for (uint32_t i = 0; i < Table::capacity(); i++) {
+        uint32_t* v = table.insert(towerKey(i));
+        TEST_ASSERT_NOT_NULL(v);
+        TEST_ASSERT_EQUAL(0, *v);
+        *v = i + 1;
+        ref[towerKey(i)] = i + 1;
+    }
+    TEST_ASSERT_TRUE(table.full());
+    TEST_ASSERT_NULL(table.insert(towerKey(1000)));
+    // Existing keys are still found when full
+    TEST_ASSERT_NOT_NULL(table.insert(towerKey(3)));
+    checkAgainst(table, ref);
+}
+
+void test_table_sizes_follow_the_fleet() {
+    TEST_ASSERT_EQUAL(4, macTableSlots(1));
+    TEST_ASSERT_EQUAL(4, macTableSlots(3));
+    TEST_ASSERT_EQUAL(8, macTableSlots(4));
+    TEST_ASSERT_EQUAL(128, macTableSlots(96));
+    TEST_ASSERT_EQUAL(256, macTableSlots(97));
+    // A table sized for the fleet takes every tower
+    MacTable<uint32_t, macTableSlots(MAX_FLEET_TOWERS)> fleet;
+    for (uint32_t i = 0; i < MAX_FLEET_TOWERS; i++) TEST_ASSERT_NOT_NULL(fleet.insert(towerKey(i)));
+}
+
+void test_erase_keeps_probe_runs_intact() {
+    Table table;
+    std::map<MacKey, uint32_t> ref;
+    uint32_t next = 0;
+    // Churn: insert up to capacity, erase every third key, refill, repeat
+    for (int round = 0; round < 50; round++) {
+        while (!table.full()) {
+            MacKey k = towerKey(next);
+            *table.insert(k) = next;
+            ref[k] = next;
+            next++;
+        }
+        int i = 0;
+        for (auto it = ref.begin(); it != ref.end();) {
+            if (i++ % 3 == round % 3) {
+                TEST_ASSERT_TRUE(table.erase(it->first));
+                it = ref.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        checkAgainst(table, ref);
+    }
+    TEST_ASSERT_FALSE(table.erase(towerKey(next + 1)));
+
+    size_t seen = 0;
+    table.forEach([&](MacKey k, uint32_t v) {
+        TEST_ASSERT_EQUAL(ref[k], v);
+        seen++;
+    });
+    TEST_ASSERT_EQUAL(ref.size(), seen);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mac_key_round_trip);
+    RUN_TEST(test_table_fills_to_capacity);
+    RUN_TEST(test_table_sizes_follow_the_fleet);
+    RUN_TEST(test_erase_keeps_probe_runs_intact);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,130 @@
+#ifdef UNIT_TEST
+
+// PingScheduler, EspNow's liveness pings (pio test -e native -f test_native_ping_scheduler)
+//
+// A simulated clock steps through poll() every few ms while the tests decide
+// when each peer was last heard. Covers skipping chatty peers, pinging more
+// often near the stale threshold, spreading pings over the interval and a
+// table that holds the whole fleet.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <vector>
+#include "../../src/comm/PingScheduler.h"
+
+static const uint32_t INTERVAL_MS = 2000;
+static const uint32_t STALE_MS = 6000;
+
+struct Fleet {
+    std::map<MacKey, uint32_t> lastSeen;
+    std::vector<MacKey> pinged;
+    std::vector<uint32_t> pingedAt;
+    uint32_t now = 1;
+
+    uint32_t seen(MacKey peer) { return lastSeen.count(peer) ? lastSeen[peer] : 0; }
+    void ping(MacKey peer) { pinged.push_back(peer); pingedAt.push_back(now); }
+
+    void run(PingScheduler& s, uint32_t untilMs, uint32_t stepMs = 5) {
+        for (; now < untilMs; now += stepMs) {
+            s.poll(now, [this](MacKey p) { return seen(p); }, [this](MacKey p) { ping(p); });
+        }
+    }
+    size_t pingsTo(MacKey peer) const {
+        size_t n = 0;
+        for (MacKey p : pinged) n += p == peer ? 1 : 0;
+        return n;
+    }
+};
+
+static MacKey peer(uint8_t n) {
+    const uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, n };
+    return macKey(mac);
+}
+
+void test_chatty_peer_is_never_pinged() {
+    PingScheduler s;
+    s.configure(INTERVAL_MS, STALE_MS);
+    Fleet f;
+    s.watch(peer(1), f.now);
+    // Telemetry every second for a minute
+    while (f.now < 60000) {
+        f.lastSeen[peer(1)] = f.now;
+        f.run(s, f.now + 1000);
+    }
+    TEST_ASSERT_EQUAL(0, f.pinged.size());
+    TEST_ASSERT_TRUE(s.counters().skipped > 0);
+}
+
+void test_quiet_peer_is_pinged_more_often_near_stale() {
+    PingScheduler s;
+    s.configure(INTERVAL_MS, STALE_MS);
+    Fleet f;
+    f.lastSeen[peer(1)] = f.now;
+    s.watch(peer(1), f.now);
+
+    // Nothing while it is fresh, then URGENT_PINGS between half and full stale
+    f.run(s, STALE_MS / 2);
+    TEST_ASSERT_EQUAL(0, f.pinged.size());
+    f.run(s, STALE_MS);
+    TEST_ASSERT_EQUAL(PingScheduler::URGENT_PINGS, f.pinged.size());
+
+    // Stale: slow probes, one per interval
+    f.run(s, STALE_MS + 10 * INTERVAL_MS);
+    TEST_ASSERT_EQUAL(PingScheduler::URGENT_PINGS + 10, f.pinged.size());
+
+    // Heard again: quiet until it ages once more
+    f.lastSeen[peer(1)] = f.now;
+    size_t before = f.pinged.size();
+    f.run(s, f.now + STALE_MS / 2 - 10);
+    TEST_ASSERT_EQUAL(before, f.pinged.size());
+}
+
+void test_pings_are_spread_over_the_interval() {
+    PingScheduler s;
+    s.configure(INTERVAL_MS, STALE_MS);
+    Fleet f;
+    const uint8_t PEERS = 20;
+    for (uint8_t i = 0; i < PEERS; i++) s.watch(peer(i), f.now);  // never heard: slow probes
+
+    f.run(s, 1 + 5 * INTERVAL_MS, 1);
+    TEST_ASSERT_EQUAL(5 * PEERS, f.pinged.size());
+    for (uint8_t i = 0; i < PEERS; i++) TEST_ASSERT_EQUAL(5, f.pingsTo(peer(i)));
+    uint32_t minGap = UINT32_MAX;
+    for (size_t i = 1; i < f.pingedAt.size(); i++) {
+        uint32_t gap = f.pingedAt[i] - f.pingedAt[i - 1];
+        if (gap < minGap) minGap = gap;
+    }
+    TEST_ASSERT_TRUE(minGap >= STALE_MS / 2 / PingScheduler::URGENT_PINGS / PEERS);
+
+    s.unwatch(peer(0));
+    TEST_ASSERT_FALSE(s.watching(peer(0)));
+    TEST_ASSERT_EQUAL(PEERS - 1, s.watched());
+}
+
+void test_whole_fleet_is_watched_and_pinged() {
+    PingScheduler s;
+    s.configure(INTERVAL_MS, STALE_MS);
+    Fleet f;
+    for (size_t i = 0; i < MAX_FLEET_TOWERS; i++) TEST_ASSERT_TRUE(s.watch(peer((uint8_t)i), f.now));
+    TEST_ASSERT_EQUAL(MAX_FLEET_TOWERS, s.watched());
+
+    // Never heard: every tower gets its probe within two intervals
+    f.run(s, 1 + 2 * INTERVAL_MS, 1);
+    for (size_t i = 0; i < MAX_FLEET_TOWERS; i++) TEST_ASSERT_TRUE(f.pingsTo(peer((uint8_t)i)) >= 1);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_chatty_peer_is_never_pinged);
+    RUN_TEST(test_quiet_peer_is_pinged_more_often_near_stale);
+    RUN_TEST(test_pings_are_spread_over_the_interval);
+    RUN_TEST(test_whole_fleet_is_watched_and_pinged);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,141 @@
+#ifdef UNIT_TEST
+
+// SpscRing between the ESP-NOW receive callback and EspNow::loop()
+// (pio test -e native -f test_native_rx_ring)
+//
+// A producer thread stands in for the WiFi task and pushes numbered frames
+// in bursts; the main thread drains them the way EspNow::drainReceived() does.
+// Below capacity nothing may be lost or reordered; past it, every frame is
+// either delivered in order or counted as dropped.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <thread>
+#include "../../src/comm/RxRing.h"
+
+typedef SpscRing<RxFrame, 16> Ring;
+
+static void fill(RxFrame& f, uint32_t seq) {
+    memset(f.mac, 0xAB, sizeof(f.mac));
+    f.rssi = -60;
+    f.rxMs = seq;
+    f.len = sizeof(seq);
+    memcpy(f.data, &seq, sizeof(seq));
+}
+
+static uint32_t seqOf(const RxFrame& f) {
+    uint32_t seq;
+    memcpy(&seq, f.data, sizeof(seq));
+    return seq;
+}
+
+static bool produce(Ring& ring, uint32_t seq) {
+    RxFrame* f = ring.claim();
+    if (!f) return false;
+    fill(*f, seq);
+    ring.publish();
+    return true;
+}
+
+void test_ring_fills_to_capacity_then_drops() {
+    Ring ring;
+    for (uint32_t i = 0; i < Ring::capacity(); i++) {
+        TEST_ASSERT_TRUE(produce(ring, i));
+    }
+    TEST_ASSERT_FALSE(produce(ring, 99));
+    TEST_ASSERT_EQUAL(1, ring.getDroppedCount());
+    TEST_ASSERT_EQUAL(Ring::capacity(), ring.getHighWater());
+
+    for (uint32_t i = 0; i < Ring::capacity(); i++) {
+        const RxFrame* f = ring.peek();
+        TEST_ASSERT_NOT_NULL(f);
+        TEST_ASSERT_EQUAL(i, seqOf(*f));
+        ring.pop();
+    }
+    TEST_ASSERT_NULL(ring.peek());
+    TEST_ASSERT_TRUE(produce(ring, 100));
+    TEST_ASSERT_EQUAL(Ring::capacity() + 1, ring.getPushedCount());
+}
+
+void test_bursts_below_capacity_arrive_complete_and_in_order() {
+    static Ring ring;
+    const uint32_t BURSTS = 2000;
+    const uint32_t BURST = Ring::capacity();
+
+    // Each burst waits for the consumer to catch up, so the ring never overflows
+    std::thread producer([&]() {
+        uint32_t seq = 0;
+        for (uint32_t b = 0; b < BURSTS; b++) {
+            while (ring.size() != 0) std::this_thread::yield();
+            for (uint32_t i = 0; i < BURST; i++) produce(ring, seq++);
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t misordered = 0;
+    while (expected < BURSTS * BURST) {
+        const RxFrame* f = ring.peek();
+        if (!f) { std::this_thread::yield(); continue; }
+        if (seqOf(*f) != expected) misordered++;
+        expected++;
+        ring.pop();
+    }
+    producer.join();
+
+    printf("  %u frames in bursts of %u, high water %u\n",
+           (unsigned)(BURSTS * BURST), (unsigned)BURST, (unsigned)ring.getHighWater());
+    TEST_ASSERT_EQUAL(0, misordered);
+    TEST_ASSERT_EQUAL(0, ring.getDroppedCount());
+    TEST_ASSERT_EQUAL(BURSTS * BURST, ring.getPushedCount());
+    TEST_ASSERT_NULL(ring.peek());
+}
+
+void test_overflow_is_counted_never_reordered() {
+    static Ring ring;
+    const uint32_t FRAMES = 200000;
+
+    // Free-running producer: whatever does not fit is dropped and counted
+    std::thread producer([&]() {
+        for (uint32_t seq = 0; seq < FRAMES; seq++) produce(ring, seq);
+    });
+
+    uint32_t delivered = 0;
+    uint32_t last = 0;
+    bool first = true;
+    uint32_t misordered = 0;
+    bool done = false;
+    while (!done) {
+        const RxFrame* f = ring.peek();
+        if (!f) {
+            done = ring.getPushedCount() + ring.getDroppedCount() == FRAMES && ring.size() == 0;
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t seq = seqOf(*f);
+        if (!first && seq <= last) misordered++;
+        last = seq;
+        first = false;
+        delivered++;
+        ring.pop();
+    }
+    producer.join();
+
+    printf("  %u frames free-running: %u delivered, %u dropped\n",
+           (unsigned)FRAMES, (unsigned)delivered, (unsigned)ring.getDroppedCount());
+    TEST_ASSERT_EQUAL(0, misordered);
+    TEST_ASSERT_EQUAL(FRAMES, delivered + ring.getDroppedCount());
+    TEST_ASSERT_EQUAL(delivered, ring.getPushedCount());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_fills_to_capacity_then_drops);
+    RUN_TEST(test_bursts_below_capacity_arrive_complete_and_in_order);
+    RUN_TEST(test_overflow_is_counted_never_reordered);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
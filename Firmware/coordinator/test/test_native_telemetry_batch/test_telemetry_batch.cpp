@@ -0,0 +1,109 @@
+#ifdef UNIT_TEST
+
+// TelemetryBatch, Mqtt's batched tower telemetry
+// (pio test -e native -f test_native_telemetry_batch)
+//
+// Covers the two ways a batch ends, its window passing and the next row not
+// fitting the packet, and checks the running size against the document that
+// is actually published.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../../src/comm/TelemetryBatch.h"
+
+static const uint32_t WINDOW_MS = 1000;
+
+static void header(JsonDocument& doc) {
+    doc["farm_id"] = "f1";
+    doc["coord_id"] = "c1";
+    JsonArray cols = doc.createNestedArray("cols");
+    cols.add("tower_id");
+    cols.add("ts");
+    cols.add("air_temp_c");
+}
+
+static TelemetryBatch::Add addRow(TelemetryBatch& batch, uint32_t now, int i) {
+    return batch.add(now, header, [i](JsonArray r) {
+        r.add(String("T") + String(i));
+        r.add(1700000000 + i);
+        r.add(20 + i % 7);
+    });
+}
+
+void test_batch_goes_out_when_its_window_passes() {
+    TelemetryBatch batch(2048, WINDOW_MS, 1024);
+    TEST_ASSERT_FALSE(batch.due(0));
+    TEST_ASSERT_TRUE(addRow(batch, 1000, 1) == TelemetryBatch::Add::ADDED);
+    TEST_ASSERT_TRUE(addRow(batch, 1400, 2) == TelemetryBatch::Add::ADDED);
+    // The window runs from the first row
+    TEST_ASSERT_FALSE(batch.due(1999));
+    TEST_ASSERT_TRUE(batch.due(2000));
+
+    String payload;
+    TEST_ASSERT_EQUAL(2, batch.serialize(payload));
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, payload));
+    TEST_ASSERT_EQUAL(2, doc["n"].as<int>());
+    TEST_ASSERT_EQUAL(2, doc["rows"].size());
+    TEST_ASSERT_TRUE(doc["rows"][1][0].as<String>() == "T2");
+    TEST_ASSERT_TRUE(doc["farm_id"].as<String>() == "f1");
+
+    // Empty again: nothing due, and the next row opens a new window
+    TEST_ASSERT_EQUAL(0, batch.size());
+    TEST_ASSERT_FALSE(batch.due(9000));
+    TEST_ASSERT_EQUAL(0, batch.serialize(payload));
+    addRow(batch, 5000, 3);
+    TEST_ASSERT_FALSE(batch.due(5999));
+    TEST_ASSERT_TRUE(batch.due(6000));
+}
+
+void test_running_size_matches_the_published_document() {
+    TelemetryBatch batch(8192, WINDOW_MS, 4096);
+    for (int rows = 1; rows <= 25; rows++) {
+        for (int i = 0; i < rows; i++) addRow(batch, 0, i * 37);
+        size_t expected = batch.bytes();
+        String payload;
+        TEST_ASSERT_EQUAL(rows, batch.serialize(payload));
+        TEST_ASSERT_EQUAL(expected, payload.length());
+    }
+}
+
+void test_row_that_does_not_fit_ends_the_batch() {
+    const size_t BUDGET = 300;
+    TelemetryBatch batch(2048, WINDOW_MS, BUDGET);
+    int i = 0;
+    while (addRow(batch, 0, i) == TelemetryBatch::Add::ADDED) i++;
+    TEST_ASSERT_TRUE(i > 1);
+    TEST_ASSERT_EQUAL(i, batch.size());  // the refused row left no trace
+    TEST_ASSERT_TRUE(batch.bytes() <= BUDGET);
+    TEST_ASSERT_FALSE(batch.due(0));     // full, not late: the caller publishes now
+
+    String payload;
+    batch.serialize(payload);
+    TEST_ASSERT_TRUE(payload.length() <= BUDGET);
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, payload));
+    TEST_ASSERT_EQUAL(i, doc["rows"].size());
+    // The refused row starts the next batch
+    TEST_ASSERT_TRUE(addRow(batch, 0, i) == TelemetryBatch::Add::ADDED);
+
+    // A row that could never fit is refused outright and leaves the batch empty
+    TelemetryBatch tiny(2048, WINDOW_MS, 40);
+    TEST_ASSERT_TRUE(addRow(tiny, 0, 1) == TelemetryBatch::Add::TOO_LARGE);
+    TEST_ASSERT_EQUAL(0, tiny.size());
+    TEST_ASSERT_EQUAL(0, tiny.bytes());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_goes_out_when_its_window_passes);
+    RUN_TEST(test_running_size_matches_the_published_document);
+    RUN_TEST(test_row_that_does_not_fit_ends_the_batch);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,144 @@
+#ifdef UNIT_TEST
+
+// TelemetryBatcher, the tower sender's batch mode
+// (pio test -e native -f test_native_telemetry_batcher)
+//
+// Drives the batcher the way TowerTelemetrySender::loop() does: a sample every
+// telemetry interval, one frame per n samples. Covers a failed send keeping
+// its samples, a full batch dropping its oldest sample, and the frame decoding
+// on the coordinator with the sample times intact.
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../../../shared/src/EspNowMessage.cpp"
+#include "../../../node/src/TelemetryFrames.h"
+
+static const uint32_t INTERVAL_MS = 30000;
+
+static TowerTelemetryMessage reading(uint32_t i) {
+    TowerTelemetryMessage m;
+    m.tower_id = "T0A1B2C";
+    m.ts = millis();
+    m.air_temp_c = 21.0f + i;
+    m.humidity_pct = 60.0f;
+    m.light_lux = 500.0f;
+    m.fw = "2.1.0";
+    m.uptime_s = i;
+    return m;
+}
+
+struct Radio {
+    bool up = true;
+    uint32_t attempts = 0;
+    uint8_t wire[WireConstants::MAX_PAYLOAD_LEN];
+    size_t len = 0;
+
+    bool send(const TowerTelemetryBatchMessage& batch) {
+        attempts++;
+        if (!up) return false;
+        len = batch.encode(wire, sizeof(wire));
+        return len > 0;
+    }
+};
+
+// TowerTelemetrySender::loop() in batch mode, called every second until
+// `samples` more samples have been taken
+static void run(TelemetryBatcher& batcher, Radio& radio, uint32_t samples, uint32_t& taken) {
+    for (uint32_t end = taken + samples; taken < end; hostAdvanceMillis(1000)) {
+        if (!batcher.due(millis(), INTERVAL_MS)) continue;
+        batcher.add(millis(), reading(taken++));
+        if (batcher.ready()) {
+            batcher.flush(millis(), [&radio](const TowerTelemetryBatchMessage& b) { return radio.send(b); });
+        }
+    }
+}
+
+void test_one_frame_per_n_samples() {
+    hostMillis() = 0;
+    TelemetryBatcher batcher;
+    batcher.setSize(5);
+    Radio radio;
+    uint32_t taken = 0;
+
+    // Ten minutes at a 30 s interval: 20 samples, 4 frames
+    run(batcher, radio, 20, taken);
+    TEST_ASSERT_EQUAL(20, taken);
+    TEST_ASSERT_EQUAL(4, radio.attempts);
+    TEST_ASSERT_EQUAL(0, batcher.pending());
+
+    // The coordinator gets all five samples back, 30 s apart
+    TowerTelemetryBatchMessage got;
+    TEST_ASSERT_TRUE(got.fromBinary(radio.wire, radio.len));
+    TEST_ASSERT_EQUAL(5, got.count);
+    for (uint8_t i = 0; i < got.count; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(21.0f + 15 + i, got.samples[i].air_temp_c);
+        if (i) TEST_ASSERT_EQUAL(INTERVAL_MS, got.samples[i].ts - got.samples[i - 1].ts);
+    }
+}
+
+void test_failed_send_keeps_samples() {
+    hostMillis() = 0;
+    TelemetryBatcher batcher;
+    batcher.setSize(3);
+    Radio radio;
+    radio.up = false;
+    uint32_t taken = 0;
+
+    run(batcher, radio, 3, taken);
+    TEST_ASSERT_EQUAL(1, radio.attempts);
+    TEST_ASSERT_EQUAL(3, batcher.pending());
+
+    // Every further sample retries; once the link is back all of them go out in one frame
+    run(batcher, radio, 1, taken);
+    TEST_ASSERT_EQUAL(2, radio.attempts);
+    radio.up = true;
+    run(batcher, radio, 1, taken);
+    TEST_ASSERT_EQUAL(0, batcher.pending());
+    TowerTelemetryBatchMessage got;
+    TEST_ASSERT_TRUE(got.fromBinary(radio.wire, radio.len));
+    TEST_ASSERT_EQUAL(5, got.count);
+    TEST_ASSERT_EQUAL_FLOAT(21.0f, got.samples[0].air_temp_c);
+}
+
+void test_full_batch_drops_oldest_sample() {
+    hostMillis() = 0;
+    TelemetryBatcher batcher;
+    batcher.setSize(200);  // clamped
+    TEST_ASSERT_EQUAL(TowerTelemetryBatchMessage::MAX_SAMPLES, batcher.size());
+    Radio radio;
+    radio.up = false;
+
+    for (uint32_t i = 0; i < TowerTelemetryBatchMessage::MAX_SAMPLES; i++) {
+        TEST_ASSERT_TRUE(batcher.add(millis(), reading(i)));
+    }
+    TEST_ASSERT_TRUE(batcher.ready());
+    TEST_ASSERT_FALSE(batcher.flush(millis(), [&radio](const TowerTelemetryBatchMessage& b) { return radio.send(b); }));
+    TEST_ASSERT_FALSE(batcher.add(millis(), reading(100)));
+    TEST_ASSERT_EQUAL(TowerTelemetryBatchMessage::MAX_SAMPLES, batcher.pending());
+
+    radio.up = true;
+    TEST_ASSERT_TRUE(batcher.flush(millis(), [&radio](const TowerTelemetryBatchMessage& b) { return radio.send(b); }));
+    TowerTelemetryBatchMessage got;
+    TEST_ASSERT_TRUE(got.fromBinary(radio.wire, radio.len));
+    TEST_ASSERT_EQUAL(TowerTelemetryBatchMessage::MAX_SAMPLES, got.count);
+    TEST_ASSERT_EQUAL_FLOAT(22.0f, got.samples[0].air_temp_c);   // reading 0 gave way
+    TEST_ASSERT_EQUAL_FLOAT(121.0f, got.samples[got.count - 1].air_temp_c);
+
+    // Nothing pending: flushing sends nothing
+    uint32_t attempts = radio.attempts;
+    TEST_ASSERT_TRUE(batcher.flush(millis(), [&radio](const TowerTelemetryBatchMessage& b) { return radio.send(b); }));
+    TEST_ASSERT_EQUAL(attempts, radio.attempts);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_frame_per_n_samples);
+    RUN_TEST(test_failed_send_keeps_samples);
+    RUN_TEST(test_full_batch_drops_oldest_sample);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,201 @@
+#ifdef UNIT_TEST
+
+// Delta tower telemetry end to end (pio test -e native -f test_native_telemetry_delta)
+//
+// The tower sender's own keyframe logic (TelemetryKeyframes) sends an hour of
+// 30 s telemetry through the wire format into TowerTelemetryAssembler.
+// Every rebuilt message must match what a full compact frame would have
+// carried, and the delta stream must take at most half the bytes.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <vector>
+#include "../../../shared/src/EspNowMessage.cpp"
+#include "../../src/towers/TowerTelemetryAssembler.cpp"
+#include "../../../node/src/TelemetryFrames.h"
+
+static const MacKey TOWER = 0xAABBCCDDEE01ULL;
+static const uint8_t KEYFRAME_INTERVAL = 10;
+
+// Tower side: the next frame as TowerTelemetrySender would put it on air
+static size_t towerSend(TelemetryKeyframes& tower, const TowerTelemetryMessage& m, uint8_t* buf, size_t cap) {
+    TowerTelemetryDeltaMessage frame;
+    tower.next(m, frame);
+    return frame.toBinary(buf, cap);
+}
+
+static TowerTelemetryMessage reading(uint32_t i) {
+    TowerTelemetryMessage m;
+    m.tower_id = "T0A1B2C";
+    m.air_temp_c = 22.0f + (i % 17) * 0.13f;
+    m.humidity_pct = 58.0f + (i % 11) * 0.4f;
+    m.light_lux = 800.0f + (i / 20) * 5.0f;   // steps every ten minutes
+    m.pump_on = (i / 40) % 2 == 0;
+    m.light_on = true;
+    m.light_brightness = 200;
+    m.status_mode = StatusMode::OPERATIONAL;
+    m.vbat_mv = 5000;
+    m.fw = "2.1.0";
+    m.uptime_s = 600 + i * 30;
+    return m;
+}
+
+// What the coordinator would have published from a full compact frame
+static TowerTelemetryMessage viaFullFrame(const TowerTelemetryMessage& m) {
+    uint8_t buf[TowerTelemetryMessage::BINARY_SIZE];
+    TowerTelemetryMessage out;
+    TEST_ASSERT_TRUE(out.fromBinary(buf, m.toBinary(buf, sizeof(buf))));
+    return out;
+}
+
+static void assertSameTelemetry(const TowerTelemetryMessage& a, const TowerTelemetryMessage& b) {
+    TEST_ASSERT_EQUAL_STRING(a.tower_id.c_str(), b.tower_id.c_str());
+    TEST_ASSERT_EQUAL_FLOAT(a.air_temp_c, b.air_temp_c);
+    TEST_ASSERT_EQUAL_FLOAT(a.humidity_pct, b.humidity_pct);
+    TEST_ASSERT_EQUAL_FLOAT(a.light_lux, b.light_lux);
+    TEST_ASSERT_EQUAL(a.pump_on, b.pump_on);
+    TEST_ASSERT_EQUAL(a.light_on, b.light_on);
+    TEST_ASSERT_EQUAL(a.light_brightness, b.light_brightness);
+    TEST_ASSERT_EQUAL(a.status_mode, b.status_mode);
+    TEST_ASSERT_EQUAL(a.vbat_mv, b.vbat_mv);
+    TEST_ASSERT_EQUAL_STRING(a.fw.c_str(), b.fw.c_str());
+    TEST_ASSERT_EQUAL(a.uptime_s, b.uptime_s);
+}
+
+// One frame tower -> coordinator and the sync reply back; returns bytes on air
+static size_t exchange(TelemetryKeyframes& tower, TowerTelemetryAssembler& coord, const TowerTelemetryMessage& m,
+                       TowerTelemetryAssembler::Result& result, TowerTelemetryMessage& rebuilt) {
+    uint8_t buf[WireConstants::MAX_FRAME_LEN];
+    size_t n = towerSend(tower, m, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(n > 0);
+
+    MessageSlot slot;
+    EspNowMessage* msg = MessageFactory::decode(buf, n, slot);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::TOWER_TELEMETRY_DELTA, msg->type);
+    const TowerTelemetryDeltaMessage& frame = *static_cast<TowerTelemetryDeltaMessage*>(msg);
+    result = coord.apply(TOWER, millis(), frame, rebuilt);
+
+    uint8_t reply[TowerTelemetrySyncMessage::BINARY_SIZE];
+    size_t r = TowerTelemetryAssembler::syncFor(frame, result).encode(reply, sizeof(reply));
+    TowerTelemetrySyncMessage sync;
+    TEST_ASSERT_TRUE(sync.fromBinary(reply, r));
+    tower.onSync(sync);
+    return n;
+}
+
+void test_delta_stream_rebuilds_full_telemetry() {
+    TelemetryKeyframes tower(KEYFRAME_INTERVAL);
+    TowerTelemetryAssembler coord;
+    size_t deltaBytes = 0;
+    size_t fullBytes = 0;
+
+    for (uint32_t i = 0; i < 120; i++) {
+        TowerTelemetryMessage m = reading(i);
+        TowerTelemetryAssembler::Result result;
+        TowerTelemetryMessage rebuilt;
+        deltaBytes += exchange(tower, coord, m, result, rebuilt);
+        fullBytes += TowerTelemetryMessage::BINARY_SIZE;
+
+        TEST_ASSERT_TRUE(result != TowerTelemetryAssembler::Result::NEED_KEYFRAME);
+        assertSameTelemetry(viaFullFrame(m), rebuilt);
+    }
+
+    printf("  120 frames: full %u B, delta %u B (%.0f%%), keyframes %u\n",
+           (unsigned)fullBytes, (unsigned)deltaBytes, 100.0f * deltaBytes / fullBytes,
+           (unsigned)coord.getKeyframeCount());
+    TEST_ASSERT_EQUAL(120 / KEYFRAME_INTERVAL, coord.getKeyframeCount());
+    TEST_ASSERT_EQUAL(0, coord.getResyncCount());
+    TEST_ASSERT_TRUE(deltaBytes * 2 <= fullBytes);
+}
+
+void test_unknown_baseline_requests_keyframe() {
+    TelemetryKeyframes tower(KEYFRAME_INTERVAL);
+    TowerTelemetryAssembler coord;
+    TowerTelemetryAssembler::Result result;
+    TowerTelemetryMessage rebuilt;
+
+    exchange(tower, coord, reading(0), result, rebuilt);
+    exchange(tower, coord, reading(1), result, rebuilt);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::DELTA, result);
+
+    // Coordinator restarts: the next delta has nothing to apply to
+    coord.forget(TOWER);
+    exchange(tower, coord, reading(2), result, rebuilt);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::NEED_KEYFRAME, result);
+    TEST_ASSERT_EQUAL(1, coord.getResyncCount());
+
+    // The request makes the tower send a keyframe straight away, and deltas resume after it
+    exchange(tower, coord, reading(3), result, rebuilt);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::KEYFRAME, result);
+    assertSameTelemetry(viaFullFrame(reading(3)), rebuilt);
+    exchange(tower, coord, reading(4), result, rebuilt);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::DELTA, result);
+    assertSameTelemetry(viaFullFrame(reading(4)), rebuilt);
+}
+
+void test_lost_keyframe_ack_keeps_sending_keyframes() {
+    TelemetryKeyframes tower(KEYFRAME_INTERVAL);
+    TowerTelemetryAssembler coord;
+    uint8_t buf[WireConstants::MAX_FRAME_LEN];
+
+    // Keyframe goes out but the ack never comes back
+    TEST_ASSERT_EQUAL(TowerTelemetryDeltaMessage::MAX_BINARY_SIZE, towerSend(tower, reading(0), buf, sizeof(buf)));
+    // Without an acked baseline the tower must not send a delta
+    TEST_ASSERT_EQUAL(TowerTelemetryDeltaMessage::MAX_BINARY_SIZE, towerSend(tower, reading(1), buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL(2, tower.keyId());
+    TEST_ASSERT_EQUAL(2, tower.keyframeCount());
+}
+
+void test_full_table_recycles_the_stalest_tower() {
+    TowerTelemetryAssembler coord;
+    TowerTelemetryMessage rebuilt;
+    const size_t fleet = MacTable<int, macTableSlots(MAX_FLEET_TOWERS)>::capacity();
+    TEST_ASSERT_TRUE(fleet >= MAX_FLEET_TOWERS);
+
+    // Every tower in the fleet holds a baseline; tower i last heard at i s
+    std::vector<TelemetryKeyframes> towers(fleet + 1);
+    TowerTelemetryDeltaMessage frames[2];
+    for (size_t i = 0; i < fleet; i++) {
+        towers[i].next(reading(i), frames[0]);
+        TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::KEYFRAME,
+                          coord.apply(TOWER + i, (uint32_t)i * 1000, frames[0], rebuilt));
+        towers[i].onSync(TowerTelemetryAssembler::syncFor(frames[0], TowerTelemetryAssembler::Result::KEYFRAME));
+    }
+    // Tower 0 is heard from again, so tower 1 is now the stalest
+    towers[0].next(reading(1), frames[1]);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::DELTA, coord.apply(TOWER, 500000, frames[1], rebuilt));
+    TEST_ASSERT_EQUAL(fleet, coord.getTowerCount());
+    TEST_ASSERT_EQUAL(0, coord.getRecycledCount());
+
+    // One more tower: it takes tower 1's slot
+    towers[fleet].next(reading(0), frames[0]);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::KEYFRAME,
+                      coord.apply(TOWER + fleet, 600000, frames[0], rebuilt));
+    TEST_ASSERT_EQUAL(fleet, coord.getTowerCount());
+    TEST_ASSERT_EQUAL(1, coord.getRecycledCount());
+
+    // Tower 1 recovers through a keyframe request; everyone else carries on
+    towers[1].next(reading(2), frames[1]);
+    TowerTelemetryAssembler::Result result = coord.apply(TOWER + 1, 610000, frames[1], rebuilt);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::NEED_KEYFRAME, result);
+    towers[1].onSync(TowerTelemetryAssembler::syncFor(frames[1], result));
+    towers[1].next(reading(3), frames[1]);
+    TEST_ASSERT_TRUE(frames[1].keyframe);
+    towers[2].next(reading(3), frames[1]);
+    TEST_ASSERT_EQUAL(TowerTelemetryAssembler::Result::DELTA, coord.apply(TOWER + 2, 620000, frames[1], rebuilt));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_delta_stream_rebuilds_full_telemetry);
+    RUN_TEST(test_unknown_baseline_requests_keyframe);
+    RUN_TEST(test_lost_keyframe_ack_keeps_sending_keyframes);
+    RUN_TEST(test_full_table_recycles_the_stalest_tower);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,107 @@
+#ifdef UNIT_TEST
+
+// TowerHistory, Reservoir's per-tower telemetry history
+// (pio test -e native -f test_native_tower_history)
+//
+// Covers quantization, missing readings, range queries across the ring's
+// wrap, recycling of the quietest tower and the reported memory cost.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "../../src/towers/TowerHistory.h"
+
+static TowerHistory history;  // ~20 KB: too large for the test's stack
+
+static TowerHistory::Sample sample(uint32_t t, float temp, float hum, float lux, uint8_t bits = 0) {
+    TowerHistory::Sample s;
+    s.timeS = t;
+    s.airTempC = temp;
+    s.humidityPct = hum;
+    s.lightLux = lux;
+    s.actuators = bits;
+    return s;
+}
+
+static std::vector<TowerHistory::Sample> range(const char* id, uint32_t from, uint32_t to) {
+    std::vector<TowerHistory::Sample> out;
+    history.query(id, from, to, [&out](const TowerHistory::Sample& s) { out.push_back(s); });
+    return out;
+}
+
+void test_fields_come_back_quantized() {
+    history.record("T1", sample(100, 23.46f, 61.3f, 1234.4f, TowerHistory::PUMP_ON));
+    history.record("T1", sample(130, -4.04f, 100.0f, 90000.0f, TowerHistory::LIGHT_ON));
+    history.record("T1", sample(160, NAN, NAN, NAN));
+
+    std::vector<TowerHistory::Sample> s = range("T1", 0, 1000);
+    TEST_ASSERT_EQUAL(3, s.size());
+    TEST_ASSERT_EQUAL(100, s[0].timeS);
+    TEST_ASSERT_FLOAT_WITHIN(0.051f, 23.46f, s[0].airTempC);
+    TEST_ASSERT_FLOAT_WITHIN(0.251f, 61.3f, s[0].humidityPct);
+    TEST_ASSERT_EQUAL_FLOAT(1234.0f, s[0].lightLux);
+    TEST_ASSERT_EQUAL(TowerHistory::PUMP_ON, s[0].actuators);
+    TEST_ASSERT_FLOAT_WITHIN(0.051f, -4.04f, s[1].airTempC);
+    TEST_ASSERT_EQUAL_FLOAT(65534.0f, s[1].lightLux);  // clamped
+    TEST_ASSERT_TRUE(isnan(s[2].airTempC));
+    TEST_ASSERT_TRUE(isnan(s[2].humidityPct));
+    TEST_ASSERT_TRUE(isnan(s[2].lightLux));
+}
+
+void test_range_query_across_the_wrap() {
+    // One sample every 30 s for twice the ring: only the newest SAMPLES remain
+    const uint32_t n = TowerHistory::SAMPLES * 2;
+    for (uint32_t i = 0; i < n; i++) history.record("T2", sample(1000 + i * 30, 20.0f + (i % 10) * 0.1f, 50.0f, 100.0f));
+    TEST_ASSERT_EQUAL(TowerHistory::SAMPLES, history.count("T2"));
+
+    uint32_t newest = 1000 + (n - 1) * 30;
+    std::vector<TowerHistory::Sample> last10 = range("T2", newest - 600, newest);
+    TEST_ASSERT_EQUAL(21, last10.size());  // 600 s at 30 s, both ends included
+    for (size_t i = 1; i < last10.size(); i++) TEST_ASSERT_EQUAL(30, last10[i].timeS - last10[i - 1].timeS);
+    TEST_ASSERT_EQUAL(newest, last10.back().timeS);
+
+    std::vector<TowerHistory::Sample> all = range("T2", 0, UINT32_MAX / 2);
+    TEST_ASSERT_EQUAL(TowerHistory::SAMPLES, all.size());
+    TEST_ASSERT_EQUAL(1000 + (n - TowerHistory::SAMPLES) * 30, all.front().timeS);
+
+    TEST_ASSERT_EQUAL(0, range("unknown", 0, UINT32_MAX / 2).size());
+}
+
+void test_quietest_tower_gives_its_ring_up() {
+    history.clear();
+    char id[8];
+    for (uint32_t t = 0; t < TowerHistory::TOWERS; t++) {
+        snprintf(id, sizeof(id), "T%u", (unsigned)t);
+        history.record(id, sample(500 + t, 20.0f, 50.0f, 10.0f));
+    }
+    history.record("T0", sample(900, 20.0f, 50.0f, 10.0f));  // T1 is now the quietest
+    history.record("new", sample(901, 20.0f, 50.0f, 10.0f));
+
+    TEST_ASSERT_EQUAL(TowerHistory::TOWERS, history.towerCount());
+    TEST_ASSERT_EQUAL(2, history.count("T0"));
+    TEST_ASSERT_EQUAL(0, history.count("T1"));
+    TEST_ASSERT_EQUAL(1, history.count("new"));
+}
+
+void test_memory_cost() {
+    TEST_ASSERT_EQUAL(10, TowerHistory::bytesPerSample());
+    TEST_ASSERT_TRUE(TowerHistory::bytesPerTower() <= TowerHistory::SAMPLES * 10 + 40);
+    TEST_ASSERT_EQUAL(TowerHistory::TOWERS * TowerHistory::bytesPerTower(), TowerHistory::totalBytes());
+    TEST_ASSERT_TRUE(sizeof(TowerHistory) == TowerHistory::totalBytes());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fields_come_back_quantized);
+    RUN_TEST(test_range_query_across_the_wrap);
+    RUN_TEST(test_quietest_tower_gives_its_ring_up);
+    RUN_TEST(test_memory_cost);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,80 @@
+#ifdef UNIT_TEST
+
+// DispatchTable and StageLatency, Reservoir's tower frame ingest
+// (pio test -e native -f test_native_tower_ingest)
+//
+// Covers dispatch by message type with member function handlers, like
+// Reservoir registers them, unhandled types, and the per-stage latency.
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/towers/TowerIngest.h"
+
+struct Sink {
+    int joins = 0;
+    int statuses = 0;
+    void onJoin(int& calls) { joins++; calls++; }
+    void onStatus(int& calls) { statuses++; calls++; }
+};
+typedef void (Sink::*SinkHandler)(int& calls);
+
+void test_frames_reach_the_handler_for_their_type() {
+    DispatchTable<SinkHandler> table;
+    Sink sink;
+    int calls = 0;
+    TEST_ASSERT_TRUE(table.on(MessageType::JOIN_REQUEST, "join", &Sink::onJoin));
+    TEST_ASSERT_TRUE(table.on(MessageType::NODE_STATUS, "status", &Sink::onStatus));
+
+    const MessageType stream[] = { MessageType::NODE_STATUS, MessageType::JOIN_REQUEST,
+                                   MessageType::NODE_STATUS, MessageType::OTA_COMPLETE };
+    for (size_t i = 0; i < sizeof(stream) / sizeof(stream[0]); i++) {
+        DispatchTable<SinkHandler>::Entry* e = table.find(stream[i]);
+        if (e) (sink.*e->handler)(calls);
+    }
+    TEST_ASSERT_EQUAL(1, sink.joins);
+    TEST_ASSERT_EQUAL(2, sink.statuses);
+    TEST_ASSERT_EQUAL(3, calls);
+    TEST_ASSERT_EQUAL(1, table.unhandledFrames());
+
+    int listed = 0;
+    uint32_t frames = 0;
+    table.forEach([&](MessageType, const DispatchTable<SinkHandler>::Entry& e) { listed++; frames += e.frames; });
+    TEST_ASSERT_EQUAL(2, listed);
+    TEST_ASSERT_EQUAL(3, frames);
+}
+
+void test_every_message_type_fits_the_table() {
+    DispatchTable<SinkHandler> table;
+    TEST_ASSERT_TRUE(table.on(MessageType::GROUP_COMMAND, "group", &Sink::onJoin));
+    TEST_ASSERT_NOT_NULL(table.find(MessageType::GROUP_COMMAND));
+    TEST_ASSERT_FALSE(table.on((MessageType)DispatchTable<SinkHandler>::SLOTS, "past the end", &Sink::onJoin));
+    TEST_ASSERT_NULL(table.find((MessageType)200));
+    // Re-registering a type replaces its handler
+    TEST_ASSERT_TRUE(table.on(MessageType::GROUP_COMMAND, "group2", &Sink::onStatus));
+    TEST_ASSERT_EQUAL_STRING("group2", table.find(MessageType::GROUP_COMMAND)->name);
+}
+
+void test_stage_latency() {
+    StageLatency s;
+    s.record(40);
+    TEST_ASSERT_EQUAL(40, s.avgUs());
+    for (int i = 0; i < 200; i++) s.record(100);
+    s.record(900);
+    TEST_ASSERT_EQUAL(900, s.maxUs);
+    TEST_ASSERT_EQUAL(900, s.lastUs);
+    TEST_ASSERT_EQUAL(202, s.count);
+    TEST_ASSERT_UINT32_WITHIN(60, 150, s.avgUs());  // one spike moves the average by 1/16
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_frames_reach_the_handler_for_their_type);
+    RUN_TEST(test_every_message_type_fits_the_table);
+    RUN_TEST(test_stage_latency);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
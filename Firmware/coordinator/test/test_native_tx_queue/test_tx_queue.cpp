@@ -0,0 +1,195 @@
+#ifdef UNIT_TEST
+
+// TxQueue, EspNow's transmit scheduler (pio test -e native -f test_native_tx_queue)
+//
+// A mock radio records what pump() hands it and the tests play the send
+// callback by calling complete(). Covers per-peer in-flight limits and FIFO
+// order, retry backoff, callback timeouts, deadlines, handle lifetime and
+// frames held through a channel change.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "../../src/comm/TxQueue.h"
+
+struct MockRadio {
+    std::vector<MacKey> sent;      // peer of every accepted attempt, in order
+    std::vector<uint8_t> firstByte;
+    TxQueue::Attempt answer = TxQueue::Attempt::SENT;
+
+    TxQueue::Attempt operator()(const uint8_t* mac, const uint8_t* data, size_t) {
+        if (answer == TxQueue::Attempt::SENT) {
+            sent.push_back(macKey(mac));
+            firstByte.push_back(data[0]);
+        }
+        return answer;
+    }
+};
+
+struct Finished {
+    std::vector<TxQueue::State> states;
+    void operator()(MacKey, TxQueue::State s, uint8_t) { states.push_back(s); }
+};
+
+static const uint8_t PEER_A[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x0A };
+static const uint8_t PEER_B[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x0B };
+static const uint8_t PEER_C[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x0C };
+
+static TxQueue::Handle enqueueTagged(TxQueue& q, const uint8_t* mac, uint8_t tag, uint32_t now,
+                                     uint32_t deadline = TxQueue::DEFAULT_DEADLINE_MS) {
+    uint8_t frame[8] = { tag };
+    return q.enqueue(mac, frame, sizeof(frame), now, deadline);
+}
+
+void test_one_in_flight_per_peer_fifo() {
+    static TxQueue q;
+    MockRadio radio;
+    Finished done;
+    const uint8_t* peers[3] = { PEER_A, PEER_B, PEER_C };
+    std::vector<TxQueue::Handle> handles;
+    for (uint8_t i = 0; i < 9; i++) handles.push_back(enqueueTagged(q, peers[i % 3], i, 0));
+
+    q.pump(0, std::ref(radio), std::ref(done));
+    TEST_ASSERT_EQUAL(3, radio.sent.size());   // one per peer, not nine
+    TEST_ASSERT_EQUAL(3, q.inFlight());
+
+    // Each completion frees its peer for that peer's next frame, in enqueue order
+    uint32_t now = 5;
+    while (q.pending() > 0) {
+        size_t before = radio.sent.size();
+        for (size_t i = 0; i < 3; i++) q.complete(macKey(peers[i]), true, now, std::ref(done));
+        q.pump(now, std::ref(radio), std::ref(done));
+        TEST_ASSERT_TRUE(radio.sent.size() > before || q.pending() == 0);
+        now += 5;
+    }
+    for (uint8_t i = 0; i < 9; i++) TEST_ASSERT_EQUAL(i, radio.firstByte[i]);
+    for (size_t i = 0; i < handles.size(); i++) {
+        TEST_ASSERT_TRUE(q.state(handles[i]) == TxQueue::State::DELIVERED);
+    }
+    TEST_ASSERT_EQUAL(9, q.counters().delivered);
+    TEST_ASSERT_EQUAL(9, done.states.size());
+}
+
+void test_failed_attempts_back_off_then_give_up() {
+    static TxQueue q;
+    MockRadio radio;
+    Finished done;
+    TxQueue::Handle h = enqueueTagged(q, PEER_A, 1, 0, 5000);
+
+    uint32_t now = 0;
+    uint32_t expectedGap = TxQueue::BACKOFF_BASE_MS;
+    q.pump(now, std::ref(radio), std::ref(done));
+    for (uint8_t attempt = 1; attempt < TxQueue::MAX_ATTEMPTS; attempt++) {
+        TEST_ASSERT_EQUAL(attempt, radio.sent.size());
+        q.complete(macKey(PEER_A), false, now, std::ref(done));
+        TEST_ASSERT_TRUE(q.state(h) == TxQueue::State::QUEUED);
+        // Not before the backoff has passed
+        q.pump(now + expectedGap - 1, std::ref(radio), std::ref(done));
+        TEST_ASSERT_EQUAL(attempt, radio.sent.size());
+        now += expectedGap;
+        q.pump(now, std::ref(radio), std::ref(done));
+        expectedGap *= 2;
+    }
+    TEST_ASSERT_EQUAL(TxQueue::MAX_ATTEMPTS, radio.sent.size());
+    q.complete(macKey(PEER_A), false, now, std::ref(done));
+    TEST_ASSERT_TRUE(q.state(h) == TxQueue::State::FAILED);
+    TEST_ASSERT_EQUAL(1, q.counters().failed);
+    TEST_ASSERT_EQUAL(TxQueue::MAX_ATTEMPTS - 1, q.counters().retries);
+}
+
+void test_missing_callback_times_out_into_a_retry() {
+    static TxQueue q;
+    MockRadio radio;
+    Finished done;
+    TxQueue::Handle h = enqueueTagged(q, PEER_B, 7, 0);
+    q.pump(0, std::ref(radio), std::ref(done));
+    TEST_ASSERT_TRUE(q.state(h) == TxQueue::State::IN_FLIGHT);
+
+    q.pump(TxQueue::CALLBACK_TIMEOUT_MS, std::ref(radio), std::ref(done));
+    TEST_ASSERT_TRUE(q.state(h) == TxQueue::State::QUEUED);
+    q.pump(TxQueue::CALLBACK_TIMEOUT_MS + TxQueue::BACKOFF_BASE_MS, std::ref(radio), std::ref(done));
+    TEST_ASSERT_EQUAL(2, radio.sent.size());
+    q.complete(macKey(PEER_B), true, TxQueue::CALLBACK_TIMEOUT_MS + 30, std::ref(done));
+    TEST_ASSERT_TRUE(q.state(h) == TxQueue::State::DELIVERED);
+}
+
+void test_deadline_drops_frames_the_radio_keeps_refusing() {
+    static TxQueue q;
+    MockRadio radio;
+    Finished done;
+    radio.answer = TxQueue::Attempt::RETRY;
+    TxQueue::Handle h = enqueueTagged(q, PEER_C, 3, 0, 50);
+    for (uint32_t now = 0; now <= 60; now += 10) q.pump(now, std::ref(radio), std::ref(done));
+    TEST_ASSERT_TRUE(q.state(h) == TxQueue::State::EXPIRED);
+    TEST_ASSERT_EQUAL(1, q.counters().expired);
+
+    // HOLD leaves frames queued and untouched until the radio is back
+    radio.answer = TxQueue::Attempt::HOLD;
+    TxQueue::Handle held = enqueueTagged(q, PEER_C, 4, 100);
+    q.pump(100, std::ref(radio), std::ref(done));
+    TEST_ASSERT_TRUE(q.state(held) == TxQueue::State::QUEUED);
+    radio.answer = TxQueue::Attempt::SENT;
+    q.pump(110, std::ref(radio), std::ref(done));
+    TEST_ASSERT_TRUE(q.state(held) == TxQueue::State::IN_FLIGHT);
+}
+
+void test_full_queue_rejects_and_old_handles_go_unknown() {
+    static TxQueue q;
+    MockRadio radio;
+    Finished done;
+    radio.answer = TxQueue::Attempt::HOLD;
+    std::vector<TxQueue::Handle> handles;
+    for (size_t i = 0; i < TxQueue::SLOTS; i++) handles.push_back(enqueueTagged(q, PEER_A, (uint8_t)i, 0));
+    TEST_ASSERT_EQUAL(TxQueue::NO_HANDLE, enqueueTagged(q, PEER_A, 99, 0));
+    TEST_ASSERT_EQUAL(1, q.counters().rejected);
+
+    // Let everything expire, then reuse every slot
+    q.pump(TxQueue::DEFAULT_DEADLINE_MS, std::ref(radio), std::ref(done));
+    TEST_ASSERT_TRUE(q.state(handles[0]) == TxQueue::State::EXPIRED);
+    for (size_t i = 0; i < TxQueue::SLOTS; i++) {
+        TEST_ASSERT_TRUE(enqueueTagged(q, PEER_B, (uint8_t)i, 2000) != TxQueue::NO_HANDLE);
+    }
+    TEST_ASSERT_TRUE(q.state(handles[0]) == TxQueue::State::UNKNOWN);
+    TEST_ASSERT_TRUE(q.state(TxQueue::NO_HANDLE) == TxQueue::State::UNKNOWN);
+}
+
+void test_frames_held_through_a_channel_change_are_flushed() {
+    static TxQueue q;
+    MockRadio radio;
+    Finished done;
+    // Queued during a 3 s blackout: nothing is pumped, deadlines pass meanwhile
+    std::vector<TxQueue::Handle> handles;
+    for (uint8_t i = 0; i < 4; i++) handles.push_back(enqueueTagged(q, PEER_A, i, i * 500));
+
+    uint32_t now = 3000;
+    TEST_ASSERT_EQUAL(4, q.resumeAfter(now, 3000));
+    q.pump(now, std::ref(radio), std::ref(done));
+    TEST_ASSERT_EQUAL(1, radio.sent.size());
+    while (q.pending() > 0) {
+        now += 5;
+        q.complete(macKey(PEER_A), true, now, std::ref(done));
+        q.pump(now, std::ref(radio), std::ref(done));
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(i, radio.firstByte[i]);
+        TEST_ASSERT_TRUE(q.state(handles[i]) == TxQueue::State::DELIVERED);
+    }
+    TEST_ASSERT_EQUAL(0, q.counters().expired);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_in_flight_per_peer_fifo);
+    RUN_TEST(test_failed_attempts_back_off_then_give_up);
+    RUN_TEST(test_missing_callback_times_out_into_a_retry);
+    RUN_TEST(test_deadline_drops_frames_the_radio_keeps_refusing);
+    RUN_TEST(test_full_queue_rejects_and_old_handles_go_unknown);
+    RUN_TEST(test_frames_held_through_a_channel_change_are_flushed);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST
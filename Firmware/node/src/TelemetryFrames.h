@@ -0,0 +1,175 @@
+/**
+ * @file TelemetryFrames.h
+ * @brief Frame decisions of the tower telemetry sender, without the radio
+ *
+ * TowerTelemetrySender owns the sensors and ESP-NOW; what goes into each
+ * frame is decided here so the host tests run the same code:
+ *
+ *   TelemetryKeyframes  keyframe or delta, and the coordinator's acks
+ *   TelemetryBatcher    samples collected per interval, sent n at a time
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "EspNowMessage.h"
+
+/**
+ * @brief Keyframe/ack bookkeeping for delta telemetry
+ *
+ * Deltas are only sent against a keyframe the coordinator has acknowledged.
+ * Until the ack arrives, after a keyframe request, and every interval frames,
+ * the next frame is a keyframe.
+ */
+class TelemetryKeyframes {
+public:
+    static constexpr uint8_t DEFAULT_INTERVAL = 10;
+
+    explicit TelemetryKeyframes(uint8_t interval = DEFAULT_INTERVAL)
+        : _interval(interval > 0 ? interval : 1)
+        , _keyId(0)
+        , _acked(false)
+        , _requested(false)
+        , _framesSinceKey(0)
+        , _keyframeCount(0) {}
+
+    /**
+     * @brief Set frames between keyframes, counting the keyframe itself
+     * @param interval 0 is treated as 1 (keyframes only)
+     */
+    void setInterval(uint8_t interval) { _interval = interval > 0 ? interval : 1; }
+
+    /**
+     * @brief Drop the acked baseline: the next frame is a keyframe
+     */
+    void invalidate() { _acked = false; }
+
+    /**
+     * @brief Start over after (re)start: next frame is a keyframe, counters cleared
+     */
+    void reset() {
+        _acked = false;
+        _keyframeCount = 0;
+    }
+
+    /**
+     * @brief Build the next keyframe or delta frame for msg
+     * @param msg Current full telemetry
+     * @param frame Frame to fill
+     * @return true if frame is a keyframe
+     */
+    bool next(const TowerTelemetryMessage& msg, TowerTelemetryDeltaMessage& frame) {
+        bool key = !_acked || _requested || _framesSinceKey >= _interval;
+        if (key) {
+            _keyId++;
+            _keyframe = msg;
+            _acked = false;
+            _requested = false;
+            _framesSinceKey = 0;
+            _keyframeCount++;
+            frame.capture(msg, nullptr, _keyId);
+        } else {
+            frame.capture(msg, &_keyframe, _keyId);
+        }
+        _framesSinceKey++;
+        return key;
+    }
+
+    /**
+     * @brief Handle a tower_telemetry_sync frame from the coordinator
+     * @param sync Decoded sync message
+     * @return true if the coordinator asked for a keyframe
+     */
+    bool onSync(const TowerTelemetrySyncMessage& sync) {
+        if (sync.keyframe_request) {
+            _requested = true;
+            return true;
+        }
+        if (sync.key_id == _keyId) _acked = true;
+        return false;
+    }
+
+    uint8_t keyId() const { return _keyId; }
+    bool isAcked() const { return _acked; }
+    uint32_t keyframeCount() const { return _keyframeCount; }
+
+private:
+    uint8_t _interval;
+    uint8_t _keyId;
+    bool _acked;
+    bool _requested;
+    uint8_t _framesSinceKey;
+    uint32_t _keyframeCount;
+    TowerTelemetryMessage _keyframe;
+};
+
+/**
+ * @brief Sample collection for batched telemetry
+ *
+ * One sample is taken every telemetry interval; once size() are pending they
+ * go out as one TowerTelemetryBatchMessage. A failed send keeps the samples
+ * for the next attempt, and a full batch drops its oldest sample.
+ */
+class TelemetryBatcher {
+public:
+    TelemetryBatcher() : _size(1), _lastSampleMs(0) {}
+
+    /**
+     * @brief Samples per frame; 1 disables batching
+     * @param samples Clamped to 1..TowerTelemetryBatchMessage::MAX_SAMPLES
+     */
+    void setSize(uint8_t samples) {
+        if (samples < 1) samples = 1;
+        if (samples > TowerTelemetryBatchMessage::MAX_SAMPLES) samples = TowerTelemetryBatchMessage::MAX_SAMPLES;
+        _size = samples;
+    }
+    uint8_t size() const { return _size; }
+    bool enabled() const { return _size > 1; }
+
+    /**
+     * @brief Drop pending samples and restart the sample clock
+     */
+    void reset() {
+        _batch.clear();
+        _lastSampleMs = 0;
+    }
+
+    /**
+     * @brief Check if the next sample is due
+     */
+    bool due(uint32_t now, uint32_t intervalMs) const { return now - _lastSampleMs >= intervalMs; }
+
+    /**
+     * @brief Take a reading into the batch
+     * @return false if the batch was full and its oldest sample was dropped
+     */
+    bool add(uint32_t now, const TowerTelemetryMessage& sample) {
+        _lastSampleMs = now;
+        return _batch.append(sample);
+    }
+
+    /**
+     * @brief Check if enough samples are pending for a frame
+     */
+    bool ready() const { return _batch.count >= _size; }
+    uint8_t pending() const { return _batch.count; }
+
+    /**
+     * @brief Hand the pending samples to send(const TowerTelemetryBatchMessage&)
+     * Sample ages are taken relative to now. On success the batch empties; on
+     * failure the samples stay pending.
+     * @return true if nothing was pending or send() succeeded
+     */
+    template <typename Send>
+    bool flush(uint32_t now, Send send) {
+        if (_batch.count == 0) return true;
+        _batch.ts = now;
+        if (!send(_batch)) return false;
+        _batch.clear();
+        return true;
+    }
+
+private:
+    uint8_t _size;
+    uint32_t _lastSampleMs;
+    TowerTelemetryBatchMessage _batch;
+};
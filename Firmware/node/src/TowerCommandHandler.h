@@ -233,10 +233,10 @@ inline bool TowerCommandHandler::begin() {
 }
 
 inline uint8_t TowerCommandHandler::processCommand(const TowerCommandMessage& cmd) {
-    _lastCmdId = cmd.cmd_id;
+    _lastCmdId = cmd.cmd_id.c_str();
     _cmdCount++;
 
-    log("INFO", String("Processing command: ") + cmd.command + " (id: " + cmd.cmd_id + ")");
+    log("INFO", String("Processing command: ") + cmd.command.c_str() + " (id: " + cmd.cmd_id.c_str() + ")");
 
     // Validate command
     uint8_t validationResult = validateCommand(cmd);
@@ -259,7 +259,7 @@ inline uint8_t TowerCommandHandler::processCommand(const TowerCommandMessage& cm
         result = handleOta(cmd);
     } else {
         result = CommandResult::INVALID_COMMAND;
-        log("WARN", String("Unknown command: ") + cmd.command);
+        log("WARN", String("Unknown command: ") + cmd.command.c_str());
     }
 
     _lastResult = result;
@@ -287,7 +287,7 @@ inline uint8_t TowerCommandHandler::validateCommand(const TowerCommandMessage& c
     // Check tower ID matches
     String myTowerId = _config.getTowerId();
     if (!myTowerId.isEmpty() && cmd.tower_id != myTowerId) {
-        log("WARN", String("Command for different tower: ") + cmd.tower_id);
+        log("WARN", String("Command for different tower: ") + cmd.tower_id.c_str());
         return CommandResult::INVALID_TOWER_ID;
     }
 
@@ -4,12 +4,27 @@
  * 
  * Sends TowerTelemetryMessage to coordinator via ESP-NOW at configurable
  * intervals. Non-blocking implementation using millis()-based timing.
+ *
+ * In delta mode the sender transmits TowerTelemetryDeltaMessage frames instead:
+ * a keyframe with every field, then only the fields that changed since the
+ * keyframe the coordinator acknowledged (via TowerTelemetrySyncMessage).
+ *
+ * In batch mode the sender still samples every interval but packs several
+ * timestamped samples into one TowerTelemetryBatchMessage frame, so the radio
+ * wakes once per batch. Batches carry full samples; delta mode only applies
+ * to single-sample sends.
+ *
+ * No node environment builds this header yet: node/src/main.cpp is the light
+ * node firmware. The frame decisions live in TelemetryFrames.h, which the
+ * coordinator's host tests run.
  */
 #pragma once
 
 #include <Arduino.h>
 #include <esp_now.h>
 #include "EspNowMessage.h"
+#include "FrameHeader.h"
+#include "TelemetryFrames.h"
 #include "config/TowerConfig.h"
 #include "actuators/IPumpController.h"
 #include "actuators/IGrowLightController.h"
@@ -28,6 +43,12 @@ class DHT;
  *   sender.begin();
  *   // In loop:
  *   sender.loop();  // Non-blocking, sends when interval elapsed
+ *   // Delta mode, once the coordinator accepts compact frames:
+ *   sender.setDeltaMode(true);
+ *   // On TOWER_TELEMETRY_SYNC from the coordinator:
+ *   sender.onSync(syncMsg);
+ *   // Or batch mode: one frame per 5 samples
+ *   sender.setBatchSize(5);
  */
 class TowerTelemetrySender {
 public:
@@ -59,10 +80,30 @@ public:
 
     /**
      * @brief Force immediate telemetry send (bypasses interval check)
+     * In batch mode the fresh sample is sent together with any pending ones.
      * @return true if message was sent successfully
      */
     bool sendNow();
 
+    /**
+     * @brief Pack several samples into each frame
+     * @param samples Samples per frame; 1 disables batching. Capped at
+     *        TowerTelemetryBatchMessage::MAX_SAMPLES.
+     */
+    void setBatchSize(uint8_t samples);
+
+    /**
+     * @brief Send pending batched samples now (e.g. before sleep or OTA)
+     * @return true if nothing was pending or the batch was sent
+     */
+    bool flushBatch();
+
+    /**
+     * @brief Get number of samples waiting for the next batch frame
+     * @return Pending sample count
+     */
+    uint8_t getPendingSamples() const { return _batcher.pending(); }
+
     /**
      * @brief Set the coordinator MAC address for ESP-NOW sends
      * @param mac 6-byte MAC address
@@ -89,9 +130,37 @@ public:
 
     /**
      * @brief Set node status mode
-     * @param mode Status string: "operational", "pairing", "ota", "error", "idle"
+     * @param mode StatusMode::OPERATIONAL, PAIRING, OTA, ERROR or IDLE
+     */
+    void setStatusMode(StatusMode mode);
+
+    /**
+     * @brief Switch between full telemetry and keyframe/delta frames
+     * @param enabled true once the coordinator accepts compact frames (wire_format >= 1)
+     * @param keyframeInterval Frames between keyframes, counting the keyframe itself
+     */
+    void setDeltaMode(bool enabled, uint8_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    /**
+     * @brief Handle a tower_telemetry_sync frame from the coordinator
+     * Acknowledges the current keyframe, or schedules a new one on request.
+     * @param sync Decoded sync message
      */
-    void setStatusMode(const String& mode);
+    void onSync(const TowerTelemetrySyncMessage& sync);
+
+    /**
+     * @brief Check if delta mode is enabled
+     * @return true if sending keyframe/delta frames
+     */
+    bool isDeltaMode() const { return _deltaMode; }
+
+    /**
+     * @brief Get count of keyframes sent in delta mode
+     * @return Keyframe count
+     */
+    uint32_t getKeyframeCount() const { return _keyframes.keyframeCount(); }
+
+    static constexpr uint8_t DEFAULT_KEYFRAME_INTERVAL = TelemetryKeyframes::DEFAULT_INTERVAL;
 
     /**
      * @brief Get count of telemetry messages sent since begin()
@@ -137,6 +206,7 @@ private:
 
     uint8_t _coordMac[6];
     bool _coordMacSet;
+    uint16_t _txSeq;            // FrameHeader sequence towards the coordinator
 
     // Timing
     uint32_t _lastSendTime;
@@ -147,23 +217,35 @@ private:
     // External sensor values (set by caller)
     float _ambientLux;
     uint16_t _batteryMv;
-    String _statusMode;
+    StatusMode _statusMode;
 
     // Startup time for uptime calculation
     uint32_t _startTime;
 
+    // Delta mode: keyframe/ack state lives in _keyframes
+    bool _deltaMode;
+    TelemetryKeyframes _keyframes;
+
+    // Batch mode: samples collect in _batcher until its size is pending
+    TelemetryBatcher _batcher;
+
     /**
      * @brief Build telemetry message from current sensor/actuator states
      * @return Populated TowerTelemetryMessage
      */
     TowerTelemetryMessage buildMessage() const;
 
+    /**
+     * @brief Take a sample into the pending batch
+     */
+    void appendSample();
+
     /**
      * @brief Send message via ESP-NOW to coordinator
-     * @param msg Message to send
+     * @param msg Message to send (full telemetry or delta frame)
      * @return true if send was successful
      */
-    bool sendMessage(const TowerTelemetryMessage& msg);
+    bool sendMessage(const EspNowMessage& msg);
 
     /**
      * @brief Read temperature from DHT sensor
@@ -199,14 +281,16 @@ inline TowerTelemetrySender::TowerTelemetrySender(
     , _light(light)
     , _dht(nullptr)
     , _coordMacSet(false)
+    , _txSeq(0)
     , _lastSendTime(0)
     , _sendCount(0)
     , _failCount(0)
     , _paused(false)
     , _ambientLux(0.0f)
     , _batteryMv(0)
-    , _statusMode("idle")
+    , _statusMode(StatusMode::IDLE)
     , _startTime(0)
+    , _deltaMode(false)
 {
     memset(_coordMac, 0, 6);
 }
@@ -217,6 +301,8 @@ inline bool TowerTelemetrySender::begin() {
     _sendCount = 0;
     _failCount = 0;
     _paused = false;
+    _keyframes.reset();  // first frame after (re)start is always a keyframe
+    _batcher.reset();
 
     // Try to load coordinator MAC from config
     if (_config.getCoordMac(_coordMac)) {
@@ -235,7 +321,12 @@ inline void TowerTelemetrySender::loop() {
     }
 
     if (isDue()) {
-        sendNow();
+        if (_batcher.enabled()) {
+            appendSample();
+            if (_batcher.ready()) flushBatch();
+        } else {
+            sendNow();
+        }
     }
 }
 
@@ -245,8 +336,20 @@ inline bool TowerTelemetrySender::sendNow() {
         return false;
     }
 
+    if (_batcher.enabled()) {
+        appendSample();
+        return flushBatch();
+    }
+
     TowerTelemetryMessage msg = buildMessage();
-    bool success = sendMessage(msg);
+    bool success;
+    if (_deltaMode) {
+        TowerTelemetryDeltaMessage frame;
+        _keyframes.next(msg, frame);
+        success = sendMessage(frame);
+    } else {
+        success = sendMessage(msg);
+    }
 
     if (success) {
         _lastSendTime = millis();
@@ -260,6 +363,41 @@ inline bool TowerTelemetrySender::sendNow() {
     return success;
 }
 
+inline void TowerTelemetrySender::setBatchSize(uint8_t samples) {
+    _batcher.setSize(samples);
+}
+
+inline bool TowerTelemetrySender::flushBatch() {
+    uint8_t pending = _batcher.pending();
+    if (pending == 0) return true;
+    if (!_coordMacSet) {
+        log("WARN", "Cannot send telemetry: coordinator MAC not set");
+        return false;
+    }
+
+    bool success = _batcher.flush(millis(), [this](const TowerTelemetryBatchMessage& batch) {
+        return sendMessage(batch);
+    });
+
+    if (success) {
+        _lastSendTime = millis();
+        _sendCount++;
+        log("INFO", String("Telemetry batch sent #") + String(_sendCount) + " (" + String(pending) + " samples)");
+    } else {
+        _failCount++;
+        log("ERROR", String("Telemetry batch send failed, keeping ") + String(pending) +
+            " samples, total failures: " + String(_failCount));
+    }
+
+    return success;
+}
+
+inline void TowerTelemetrySender::appendSample() {
+    if (!_batcher.add(millis(), buildMessage())) {
+        log("WARN", "Telemetry batch full, dropped oldest sample");
+    }
+}
+
 inline void TowerTelemetrySender::setCoordinatorMac(const uint8_t mac[6]) {
     memcpy(_coordMac, mac, 6);
     _coordMacSet = true;
@@ -278,10 +416,22 @@ inline void TowerTelemetrySender::setBatteryVoltage(uint16_t millivolts) {
     _batteryMv = millivolts;
 }
 
-inline void TowerTelemetrySender::setStatusMode(const String& mode) {
+inline void TowerTelemetrySender::setStatusMode(StatusMode mode) {
     _statusMode = mode;
 }
 
+inline void TowerTelemetrySender::setDeltaMode(bool enabled, uint8_t keyframeInterval) {
+    _deltaMode = enabled;
+    _keyframes.setInterval(keyframeInterval);
+    _keyframes.invalidate();
+}
+
+inline void TowerTelemetrySender::onSync(const TowerTelemetrySyncMessage& sync) {
+    if (_keyframes.onSync(sync)) {
+        log("INFO", "Coordinator requested a telemetry keyframe");
+    }
+}
+
 inline uint32_t TowerTelemetrySender::getTimeSinceLastSend() const {
     if (_lastSendTime == 0) return UINT32_MAX;
     return millis() - _lastSendTime;
@@ -289,6 +439,7 @@ inline uint32_t TowerTelemetrySender::getTimeSinceLastSend() const {
 
 inline bool TowerTelemetrySender::isDue() const {
     uint32_t interval = _config.getTelemetryIntervalMs();
+    if (_batcher.enabled()) return _batcher.due(millis(), interval);
     return (millis() - _lastSendTime) >= interval;
 }
 
@@ -331,8 +482,17 @@ inline TowerTelemetryMessage TowerTelemetrySender::buildMessage() const {
     return msg;
 }
 
-inline bool TowerTelemetrySender::sendMessage(const TowerTelemetryMessage& msg) {
-    String json = msg.toJson();
+inline bool TowerTelemetrySender::sendMessage(const EspNowMessage& msg) {
+    // Encode straight behind the frame header; JSON keeps the trailing NUL this sender has always sent
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    uint8_t* payload = frame + FrameHeader::SIZE;
+    size_t len = msg.encode(payload, WireConstants::MAX_PAYLOAD_LEN - 1);
+    if (len == 0) {
+        log("ERROR", "Telemetry does not fit in one ESP-NOW frame");
+        return false;
+    }
+    if (payload[0] == '{') payload[len++] = '\0';
+    len = FrameHeader::wrapNext(frame, len, msg.type, _txSeq);
 
     // Check if we have the coordinator as a peer
     esp_now_peer_info_t peerInfo;
@@ -360,7 +520,7 @@ inline bool TowerTelemetrySender::sendMessage(const TowerTelemetryMessage& msg)
     }
 
     // Send the message
-    esp_err_t result = esp_now_send(_coordMac, (uint8_t*)json.c_str(), json.length() + 1);
+    esp_err_t result = esp_now_send(_coordMac, frame, len);
     return (result == ESP_OK);
 }
 
@@ -193,8 +193,10 @@ void loop() { app.loop(); }
 #include <esp_now.h>
 #include <esp_sleep.h>
 #include <esp_random.h>
+#include <algorithm>
 
 #include "EspNowMessage.h"
+#include "FrameHeader.h"
 #include "ConfigManager.h"
 #include "utils/SafeTimer.h"
 // RGBW LED + button
@@ -212,6 +214,18 @@ static SmartTileNode* gNodeInstance = nullptr;
 static void espnowRecv(const esp_now_recv_info_t* recv_info, const uint8_t* data, int len);
 static void espnowSent(const uint8_t* mac, esp_now_send_status_t status);
 
+// The coordinator's 2-byte binary ping, or its older JSON keep-alives, found without copying the frame
+static bool isHealthPing(const uint8_t* data, size_t len) {
+    if (len == WireConstants::PING_LEN && data[0] == WireConstants::PING_MARKER) return true;
+    if (len == 0 || data[0] != '{') return false;
+    static const char* const markers[] = { "\"ping\"", "\"pairing_ping\"" };
+    for (const char* marker : markers) {
+        const uint8_t* m = (const uint8_t*)marker;
+        if (std::search(data, data + len, m, m + strlen(marker)) != data + len) return true;
+    }
+    return false;
+}
+
 class SmartTileNode {
 private:
     NodeState currentState;
@@ -231,6 +245,15 @@ private:
     bool statusOverrideActive = false;
     Deadline statusOverrideDl;
     
+    // Group commands: our bit in their bitmaps, the last one applied, and the
+    // light waiting for this member's turn (then held for hold_ms)
+    uint8_t memberIndex = GroupConstants::NO_MEMBER;
+    int16_t lastGroupSeq = -1;
+    SetLightMessage groupLight;
+    Deadline groupApplyDl;
+    Deadline groupHoldDl;
+    uint16_t groupHoldMs = 0;
+    
     // Temperature sensor (Adafruit TMP117)
     Adafruit_TMP117 tempSensor;
     bool tempSensorAvailable = false;
@@ -242,6 +265,15 @@ private:
     uint32_t lastTelemetry;
     uint16_t telemetryInterval;
     
+    // Coordinator advertised compact binary support in JOIN_ACCEPT
+    bool compactWire = false;
+    // Received frames are decoded here instead of on the heap
+    MessageSlot rxSlot;
+    // FrameHeader sequence numbers: ours to the coordinator, our broadcasts, and the coordinator's to us
+    uint16_t txSeq = 0;
+    uint16_t broadcastSeq = 0;
+    SequenceWindow coordRxSeq;
+    
     // Channel management
     bool channelLocked = false; // Set to true once we find coordinator
     uint8_t lockedChannel = 0;  // The channel we locked to
@@ -283,12 +315,18 @@ public:
     void onDataSent(const uint8_t* mac, esp_now_send_status_t status);
 private:
     bool sendMessage(const EspNowMessage& message, const uint8_t* destMac = nullptr);
-    void processReceivedMessage(const String& json);
+    bool sendFrame(const uint8_t* data, size_t len, const uint8_t* destMac = nullptr);
+    // Sends frame[FrameHeader::SIZE..+payloadLen) after filling in the header in front of it
+    bool sendFramed(uint8_t* frame, size_t payloadLen, MessageType type, const uint8_t* destMac);
+    void processReceivedMessage(const uint8_t* data, size_t len);
     bool ensureEncryptedPeer(const uint8_t mac[6], const String& lmkHex);
     static bool parseHex16(const String& hex, uint8_t out[16]);
     
     // LED control
     void applyColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint16_t fadeMs);
+    void applySetLight(const SetLightMessage& setLight);
+    void handleGroupCommand(const GroupCommandMessage& group);
+    void runGroupCommand();
     
     // Temperature sensing removed
     
@@ -424,6 +462,7 @@ bool SmartTileNode::begin() {
 
 void SmartTileNode::loop() {
     handleButton();
+    runGroupCommand();
     leds.update();
     
     switch (currentState) {
@@ -523,7 +562,7 @@ void SmartTileNode::handlePairing() {
         String payload = joinReq.toJson();
         
         // ✓ Checklist: Message Size check
-        if (payload.length() > 250) {
+        if (payload.length() > WireConstants::MAX_PAYLOAD_LEN) {
             logMessage("ERROR", "JOIN_REQUEST too large!");
             return;
         }
@@ -548,7 +587,11 @@ void SmartTileNode::handlePairing() {
             esp_now_add_peer(&peerInfo);
         }
         
-        esp_err_t result = esp_now_send(broadcastMac, (uint8_t*)payload.c_str(), payload.length());
+        uint8_t frame[WireConstants::MAX_FRAME_LEN];
+        memcpy(frame + FrameHeader::SIZE, payload.c_str(), payload.length());
+        size_t n = FrameHeader::wrapNext(frame, payload.length(), MessageType::JOIN_REQUEST, broadcastSeq,
+                                         FrameHeader::FLAG_BROADCAST);
+        esp_err_t result = esp_now_send(broadcastMac, frame, n);
         
         lastJoinRequest = millis();
         if (result == ESP_OK) {
@@ -692,8 +735,25 @@ void SmartTileNode::onDataRecv(const uint8_t* mac, const uint8_t* data, int len)
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
     logMessage("DEBUG", String("RX ") + String(len) + "B from " + String(macStr));
     
-    String message = String((char*)data, len);
-    logMessage("DEBUG", String("RX data: ") + message);
+    // Drop corrupt frames and coordinator retransmissions before touching any state
+    if (FrameHeader::isFramed(data, len)) {
+        FrameHeader hdr;
+        if (!FrameHeader::parse(data, len, hdr)) {
+            logMessage("DEBUG", "Corrupt frame dropped");
+            return;
+        }
+        if (mac && memcmp(mac, coordinatorMac, 6) == 0 &&
+            coordRxSeq.check(hdr.seq, hdr.flags) == SequenceWindow::DUPLICATE) {
+            logMessage("DEBUG", String("Duplicate seq ") + String(hdr.seq) + " dropped");
+            return;
+        }
+        data = hdr.payload;
+        len = (int)hdr.payloadLen;
+        if (len <= 0) return;
+    }
+    if (!MessageFactory::isCompactBinary(data, len)) {
+        logMessage("DEBUG", String("RX data: ") + String((const char*)data, len));
+    }
     
     // Get the channel we received this message on - this is the coordinator's channel!
     uint8_t rxChannel = 0;
@@ -748,7 +808,7 @@ void SmartTileNode::onDataRecv(const uint8_t* mac, const uint8_t* data, int len)
     lastCoordinatorResponse = millis();
     telemetrySentCount = 0; // Reset counter on any response
     
-    processReceivedMessage(message);
+    processReceivedMessage(data, len);
 }
 
 void SmartTileNode::onDataSent(const uint8_t* mac, esp_now_send_status_t status) {
@@ -759,14 +819,14 @@ void SmartTileNode::onDataSent(const uint8_t* mac, esp_now_send_status_t status)
     }
 }
 
-void SmartTileNode::processReceivedMessage(const String& json) {
+void SmartTileNode::processReceivedMessage(const uint8_t* data, size_t len) {
     // Ignore health check pings from coordinator (not part of ESP-NOW message protocol)
-    if (json.indexOf("\"ping\"") >= 0 || json.indexOf("\"pairing_ping\"") >= 0) {
+    if (isHealthPing(data, len)) {
         // Silently ignore - these are just keep-alive messages
         return;
     }
-    
-    EspNowMessage* message = MessageFactory::createMessage(json);
+    // Single parse for JSON, none for compact binary; decoded into rxSlot, never deleted
+    EspNowMessage* message = MessageFactory::decode(data, len, rxSlot);
     if (!message) {
         logMessage("ERROR", "Failed to parse message");
         return;
@@ -775,12 +835,15 @@ void SmartTileNode::processReceivedMessage(const String& json) {
     switch (message->type) {
         case MessageType::JOIN_ACCEPT: {
             JoinAcceptMessage* accept = static_cast<JoinAcceptMessage*>(message);
-            nodeId = accept->node_id;
-            lightId = accept->light_id;
+            nodeId = accept->node_id.c_str();
+            lightId = accept->light_id.c_str();
+            compactWire = (accept->wire_format == WireConstants::FORMAT_VERSION);
+            memberIndex = accept->member_index;
             
             config.setString(ConfigKeys::NODE_ID, nodeId);
             config.setString(ConfigKeys::LIGHT_ID, lightId);
-            config.setString(ConfigKeys::LMK, accept->lmk);
+            config.setString(ConfigKeys::LMK, accept->lmk.c_str());
+            config.setInt(ConfigKeys::MEMBER_INDEX, memberIndex);
             
             // Update configuration from coordinator
             config.setInt(ConfigKeys::RX_WINDOW_MS, accept->cfg.rx_window_ms);
@@ -819,7 +882,7 @@ void SmartTileNode::processReceivedMessage(const String& json) {
                 logMessage("INFO", String("All peers updated to channel ") + String(accept->wifi_channel));
             } else {
                 // No channel switch needed, just ensure coordinator peer exists
-                ensureEncryptedPeer(coordinatorMac, accept->lmk);
+                ensureEncryptedPeer(coordinatorMac, accept->lmk.c_str());
             }
             
             saveConfiguration();
@@ -850,35 +913,15 @@ void SmartTileNode::processReceivedMessage(const String& json) {
                 } else if (currentState == NodeState::PAIRING && lightId.isEmpty()) {
                     // Ignore commands if we don't have a lightId yet - wait for JOIN_ACCEPT
                     logMessage("WARN", "Ignoring set_light - no lightId yet, waiting for JOIN_ACCEPT");
-                    delete message;
                     return;
                 }
                 
-                // Always clear status animation when receiving manual commands
-                leds.setStatus(LedController::StatusMode::None);
-                statusOverrideActive = true;
-                statusOverrideDl.set(setLight->ttl_ms > 0 ? setLight->ttl_ms : 10000);
-
-                uint8_t r = setLight->r, g = setLight->g, b = setLight->b, w = setLight->w;
-                if (r == 0 && g == 0 && b == 0 && w == 0) {
-                    // fallback: map value to white channel
-                    w = setLight->value;
-                }
-                
-                // Check if this is a per-pixel command or all pixels
-                if (setLight->pixel >= 0 && setLight->pixel < leds.numPixels()) {
-                    // Per-pixel control
-                    leds.setPixelColor(setLight->pixel, r, g, b, w);
-                    leds.show();
-                    // Update current color tracking (use this pixel's color for telemetry)
-                    curR = r; curG = g; curB = b; curW = w;
-                    logMessage("INFO", String("Set pixel ") + String(setLight->pixel) + " to RGBW(" + String(r) + "," + String(g) + "," + String(b) + "," + String(w) + ")");
-                } else {
-                    // All pixels
-                    applyColor(r, g, b, w, setLight->fade_ms);
-                }
+                // A direct command overrides any group command still waiting
+                groupApplyDl.clear();
+                groupHoldDl.clear();
+                applySetLight(*setLight);
                 
-                lastCmdId = setLight->cmd_id;
+                lastCmdId = setLight->cmd_id.c_str();
                 lastCommandTime = millis();
                 
                 // Send acknowledgment
@@ -890,19 +933,24 @@ void SmartTileNode::processReceivedMessage(const String& json) {
             }
             break;
         }
+        case MessageType::GROUP_COMMAND: {
+            handleGroupCommand(*static_cast<GroupCommandMessage*>(message));
+            break;
+        }
         case MessageType::ACK: {
-            // Coordinator acknowledged our telemetry - reset connection timeout
+            // Coordinator acknowledged our telemetry - reset connection timeout.
+            // One cumulative ACK covers every frame up to ack_seq.
+            const AckMessage* ack = static_cast<AckMessage*>(message);
             lastCoordinatorResponse = millis();
             telemetrySentCount = 0;
-            logMessage("DEBUG", "Received ACK from coordinator");
+            logMessage("DEBUG", String("Received ACK from coordinator (") + String(ack->ack_count) +
+                       " frames up to seq " + String(ack->ack_seq) + ")");
             break;
         }
         default:
             logMessage("WARN", "Unknown message type received");
             break;
     }
-    
-    delete message;
 }
 
 void SmartTileNode::applyColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint16_t fadeMs) {
@@ -910,6 +958,64 @@ void SmartTileNode::applyColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint1
     leds.setColor(r, g, b, w, fadeMs);
 }
 
+void SmartTileNode::applySetLight(const SetLightMessage& setLight) {
+    // Always clear status animation when receiving manual commands
+    leds.setStatus(LedController::StatusMode::None);
+    statusOverrideActive = true;
+    statusOverrideDl.set(setLight.ttl_ms > 0 ? setLight.ttl_ms : 10000);
+
+    uint8_t r = setLight.r, g = setLight.g, b = setLight.b, w = setLight.w;
+    if (r == 0 && g == 0 && b == 0 && w == 0) {
+        // fallback: map value to white channel
+        w = setLight.value;
+    }
+    
+    // Check if this is a per-pixel command or all pixels
+    if (setLight.pixel >= 0 && setLight.pixel < leds.numPixels()) {
+        // Per-pixel control
+        leds.setPixelColor(setLight.pixel, r, g, b, w);
+        leds.show();
+        // Update current color tracking (use this pixel's color for telemetry)
+        curR = r; curG = g; curB = b; curW = w;
+        logMessage("INFO", String("Set pixel ") + String(setLight.pixel) + " to RGBW(" + String(r) + "," + String(g) + "," + String(b) + "," + String(w) + ")");
+    } else {
+        // All pixels
+        applyColor(r, g, b, w, setLight.fade_ms);
+    }
+}
+
+void SmartTileNode::handleGroupCommand(const GroupCommandMessage& group) {
+    // Broadcast reaches unpaired nodes too; they have no place in any group
+    if (lightId.isEmpty() || currentState != NodeState::OPERATIONAL) return;
+    // The coordinator repeats each command since broadcasts are never acknowledged
+    if (group.cmd_seq == lastGroupSeq) return;
+    lastGroupSeq = group.cmd_seq;
+    if (!group.isMember(memberIndex)) return;
+
+    // Nobody acks a broadcast: a zone answering at once would swamp the
+    // coordinator. Status telemetry reports the resulting light state.
+    group.toSetLight(groupLight);
+    groupHoldMs = group.hold_ms;
+    groupHoldDl.clear();
+    uint32_t delayMs = group.applyDelayFor(memberIndex);
+    groupApplyDl.set(delayMs);
+    if (delayMs == 0) runGroupCommand();
+    logMessage("DEBUG", String("Group ") + String(group.group_id) + " command in " + String(delayMs) + "ms");
+}
+
+void SmartTileNode::runGroupCommand() {
+    if (groupApplyDl.expired()) {
+        groupApplyDl.clear();
+        applySetLight(groupLight);
+        lastCommandTime = millis();
+        if (groupHoldMs > 0) groupHoldDl.set(groupHoldMs);
+    }
+    if (groupHoldDl.expired()) {
+        groupHoldDl.clear();
+        applyColor(0, 0, 0, 0, groupLight.fade_ms);
+    }
+}
+
 // Thermal derating function removed
 
 // Temperature sensor functions removed
@@ -962,8 +1068,8 @@ void SmartTileNode::sendTelemetry() {
     status.node_id = nodeId;
     status.light_id = nodeId; // Use node_id as light_id for compatibility
     status.avg_r = curR; status.avg_g = curG; status.avg_b = curB; status.avg_w = curW;
-    status.status_mode = (currentState == NodeState::PAIRING) ? "pairing"
-                        : (statusOverrideActive ? "override" : "operational");
+    status.status_mode = (currentState == NodeState::PAIRING) ? StatusMode::PAIRING
+                        : (statusOverrideActive ? StatusMode::OVERRIDE : StatusMode::OPERATIONAL);
     status.fw = firmwareVersion;
     status.vbat_mv = readBatteryVoltage();
     
@@ -978,6 +1084,14 @@ void SmartTileNode::sendTelemetry() {
         logMessage("WARN", "TMP117 not available - reporting 0.0C");
     }
     
+    if (compactWire) {
+        uint8_t frame[NodeStatusMessage::BINARY_SIZE];
+        size_t n = status.toBinary(frame, sizeof(frame));
+        if (n > 0) {
+            sendFrame(frame, n);
+            return;
+        }
+    }
     sendMessage(status);
 }
 
@@ -990,6 +1104,7 @@ uint16_t SmartTileNode::readBatteryVoltage() {
 void SmartTileNode::loadConfiguration() {
     nodeId = config.getString(ConfigKeys::NODE_ID);
     lightId = config.getString(ConfigKeys::LIGHT_ID);
+    memberIndex = (uint8_t)config.getInt(ConfigKeys::MEMBER_INDEX, GroupConstants::NO_MEMBER);
     
     telemetryInterval = config.getInt(ConfigKeys::TELEMETRY_INTERVAL_S, Defaults::TELEMETRY_INTERVAL_S);
     rxWindowMs = config.getInt(ConfigKeys::RX_WINDOW_MS, Defaults::RX_WINDOW_MS);
@@ -1018,14 +1133,30 @@ String SmartTileNode::getMacAddress() {
 }
 
 bool SmartTileNode::sendMessage(const EspNowMessage& message, const uint8_t* destMac) {
-    String json = message.toJson();
-    
+    // Encode behind the header's bytes so framing needs no copy
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    size_t len = message.encode(frame + FrameHeader::SIZE, WireConstants::MAX_PAYLOAD_LEN);
+    if (len == 0) {
+        logMessage("ERROR", String("Message too large: ") + message.msg);
+        return false;
+    }
+    return sendFramed(frame, len, message.type, destMac);
+}
+
+bool SmartTileNode::sendFrame(const uint8_t* data, size_t len, const uint8_t* destMac) {
     // ✓ Checklist: Message Size - Check before sending
-    if (json.length() > 250) {
-        logMessage("ERROR", String("Message too large: ") + String(json.length()) + " bytes");
+    if (len > WireConstants::MAX_PAYLOAD_LEN) {
+        logMessage("ERROR", String("Message too large: ") + String((int)len) + " bytes");
         return false;
     }
-    
+    MessageType type;
+    if (!MessageFactory::peekMessageType(data, len, type)) type = FrameHeader::UNTYPED;
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    memcpy(frame + FrameHeader::SIZE, data, len);
+    return sendFramed(frame, len, type, destMac);
+}
+
+bool SmartTileNode::sendFramed(uint8_t* frame, size_t payloadLen, MessageType type, const uint8_t* destMac) {
     const uint8_t* target = destMac;
     uint8_t broadcast[6] = {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF};
     if (!target) {
@@ -1051,8 +1182,13 @@ bool SmartTileNode::sendMessage(const EspNowMessage& message, const uint8_t* des
         logMessage("INFO", String("Added peer on channel 0"));
     }
     
+    // Broadcasts sit outside the coordinator link's sequence
+    size_t len = memcmp(target, broadcast, 6) == 0
+        ? FrameHeader::wrapNext(frame, payloadLen, type, broadcastSeq, FrameHeader::FLAG_BROADCAST)
+        : FrameHeader::wrapNext(frame, payloadLen, type, txSeq);
+    
     // ✓ Checklist: Use native ESP-NOW v2 API
-    esp_err_t res = esp_now_send(target, (uint8_t*)json.c_str(), json.length());
+    esp_err_t res = esp_now_send(target, frame, len);
     if (res != ESP_OK) {
         logMessage("WARN", String("esp_now_send failed: ") + String((int)res));
         return false;
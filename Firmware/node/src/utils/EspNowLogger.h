@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "EspNowMessage.h"
 
 /**
  * EspNowLogger - Detailed ESP-NOW communication logging for nodes
@@ -54,15 +55,23 @@ inline Stats& getStats() {
     return stats;
 }
 
-// Helper to get message type from JSON
+// Helper to get message type from a raw frame (shared lookup table, no parse)
+inline MessageType getMessageType(const uint8_t* data, size_t len) {
+    ::MessageType t;
+    if (!MessageFactory::peekMessageType(data, len, t)) return UNKNOWN;
+    switch (t) {
+        case ::MessageType::JOIN_REQUEST: return JOIN_REQUEST;
+        case ::MessageType::JOIN_ACCEPT: return JOIN_ACCEPT;
+        case ::MessageType::SET_LIGHT: return SET_LIGHT;
+        case ::MessageType::NODE_STATUS: return NODE_STATUS;
+        case ::MessageType::ACK: return ACK;
+        case ::MessageType::ERROR: return ERROR_MSG;
+        default: return UNKNOWN;
+    }
+}
+
 inline MessageType getMessageType(const String& json) {
-    if (json.indexOf("\"msg\":\"join_request\"") >= 0) return JOIN_REQUEST;
-    if (json.indexOf("\"msg\":\"join_accept\"") >= 0) return JOIN_ACCEPT;
-    if (json.indexOf("\"msg\":\"set_light\"") >= 0) return SET_LIGHT;
-    if (json.indexOf("\"msg\":\"node_status\"") >= 0) return NODE_STATUS;
-    if (json.indexOf("\"msg\":\"ack\"") >= 0) return ACK;
-    if (json.indexOf("\"msg\":\"error\"") >= 0) return ERROR_MSG;
-    return UNKNOWN;
+    return getMessageType((const uint8_t*)json.c_str(), json.length());
 }
 
 // Helper to get message type name
@@ -132,14 +141,13 @@ inline void logReceive(const uint8_t* srcMac, const uint8_t* data, uint16_t len,
     stats.lastReceiveMs = millis();
     stats.lastLinkActivityMs = millis();
     
-    // Try to parse as string for message type detection
+    // Classify straight from the bytes; the String is only for the printed payload
+    MessageType type = getMessageType(data, len);
     String json;
-    if (len > 0 && len < 512) {
+    if (len > 0 && len < 512 && data[0] == '{') {
         json = String((char*)data, len);
     }
     
-    MessageType type = getMessageType(json);
-    
     // Update type-specific counters
     if (type == JOIN_ACCEPT) {
         stats.joinAcceptsReceived++;
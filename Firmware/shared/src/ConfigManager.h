@@ -16,6 +16,7 @@ namespace ConfigKeys {
     static const char* const NODE_ID             = "node_id";
     static const char* const LIGHT_ID            = "light_id";
     static const char* const LMK                 = "lmk"; // ESP-NOW LMK key
+    static const char* const MEMBER_INDEX        = "member_index"; // bit in group command bitmaps
     static const char* const PWM_FREQ_HZ         = "pwm_freq_hz";
     static const char* const PWM_RESOLUTION_BITS = "pwm_res_bits";
     static const char* const TELEMETRY_INTERVAL_S= "telemetry_s";
@@ -1,224 +1,324 @@
 #include "EspNowMessage.h"
+#include <algorithm>
+#include <utility>
+
+// --- Compact wire helpers ---
+namespace {
+
+using schema::putFixedString;
+using schema::getFixedString;
+using schema::toCenti;
+using schema::toCentiUnsigned;
+
+// Indexed by StatusMode; the index doubles as the compact wire code
+const char* const STATUS_MODES[] = { "", "operational", "pairing", "ota", "error", "idle", "override", "maintenance" };
+constexpr uint8_t STATUS_MODE_COUNT = sizeof(STATUS_MODES) / sizeof(STATUS_MODES[0]);
+
+// tower_command 'command' values that fit the compact frame ("ota" needs a URL)
+const char* const TOWER_COMMANDS[] = { "", "set_pump", "set_light", "reboot" };
+constexpr uint8_t TOWER_COMMAND_COUNT = sizeof(TOWER_COMMANDS) / sizeof(TOWER_COMMANDS[0]);
+
+template <size_t N>
+uint8_t towerCommandToCode(const FixedString<N>& command) {
+	for (uint8_t i = 0; i < TOWER_COMMAND_COUNT; i++) {
+		if (command == TOWER_COMMANDS[i]) return i;
+	}
+	return 0xFF;
+}
+
+uint8_t actuatorFlags(const TowerTelemetryMessage& m) {
+	return (m.pump_on ? 0x01 : 0x00) | (m.light_on ? 0x02 : 0x00);
+}
+
+// tower_telemetry_delta field widths on the wire, indexed by Field bit
+const uint8_t DELTA_FIELD_WIDTHS[] = { 2, 2, 4, 1, 1, 1, 2, WireConstants::FW_FIELD_LEN, 4 };
+constexpr uint8_t DELTA_FIELD_COUNT = sizeof(DELTA_FIELD_WIDTHS) / sizeof(DELTA_FIELD_WIDTHS[0]);
+static_assert(TowerTelemetryDeltaMessage::ALL_FIELDS == (1u << DELTA_FIELD_COUNT) - 1,
+              "DELTA_FIELD_WIDTHS must cover every delta field");
+
+// JSON output goes through a StaticJsonDocument of the message's JSON_CAPACITY.
+// fillJson() adds strings as const char*, which ArduinoJson stores by pointer,
+// so the capacity only has to cover the object slots.
+template <size_t Capacity, typename M>
+size_t encodeJson(const M& m, uint8_t* out, size_t cap) {
+	StaticJsonDocument<Capacity> doc;
+	m.fillJson(doc);
+	if (doc.overflowed()) return 0;
+	size_t n = measureJson(doc);
+	if (n > cap) return 0;
+	serializeJson(doc, reinterpret_cast<char*>(out), cap);
+	return n;
+}
+
+template <size_t Capacity, typename M>
+String jsonString(const M& m) {
+	StaticJsonDocument<Capacity> doc;
+	m.fillJson(doc);
+	String out; serializeJson(doc, out); return out;
+}
+
+bool isCompactHeader(const uint8_t* buffer, size_t len, uint8_t marker, size_t size) {
+	return len >= size && buffer[0] == marker && buffer[1] == WireConstants::FORMAT_VERSION;
+}
+
+// FNV-1a over the "msg" value. The constexpr form hashes the case labels in
+// lookupType(); the loop form hashes received bytes. Both must stay identical.
+constexpr uint32_t FNV_OFFSET = 2166136261u;
+constexpr uint32_t FNV_PRIME = 16777619u;
+
+constexpr uint32_t fnv1a(const char* s, size_t n, uint32_t h) {
+	return n == 0 ? h : fnv1a(s + 1, n - 1, (h ^ static_cast<uint8_t>(*s)) * FNV_PRIME);
+}
+
+template <size_t N>
+constexpr uint32_t nameHash(const char (&name)[N]) {
+	return fnv1a(name, N - 1, FNV_OFFSET);
+}
+
+uint32_t hashName(const char* s, size_t n) {
+	uint32_t h = FNV_OFFSET;
+	for (size_t i = 0; i < n; i++) h = (h ^ static_cast<uint8_t>(s[i])) * FNV_PRIME;
+	return h;
+}
+
+// Every JSON parse in this file goes through here so the count stays honest
+uint32_t jsonParses = 0;
+
+template <typename... Args>
+DeserializationError parseJson(JsonDocument& doc, Args&&... args) {
+	jsonParses++;
+	return deserializeJson(doc, std::forward<Args>(args)...);
+}
+
+// Where a decoded message is built: on the heap, or in a caller's MessageSlot
+struct HeapMaker {
+	template <typename T> EspNowMessage* make() const { return new T(); }
+	void discard(EspNowMessage* m) const { delete m; }
+};
+
+struct SlotMaker {
+	MessageSlot& slot;
+	explicit SlotMaker(MessageSlot& s) : slot(s) {}
+	template <typename T> EspNowMessage* make() const { return slot.emplace<T>(); }
+	void discard(EspNowMessage*) const { slot.reset(); }
+};
+
+template <typename Maker>
+EspNowMessage* makeMessage(MessageType t, const Maker& maker) {
+	switch (t) {
+		case MessageType::JOIN_REQUEST: return maker.template make<JoinRequestMessage>();
+		case MessageType::JOIN_ACCEPT:  return maker.template make<JoinAcceptMessage>();
+		case MessageType::SET_LIGHT:    return maker.template make<SetLightMessage>();
+		case MessageType::NODE_STATUS:  return maker.template make<NodeStatusMessage>();
+		case MessageType::ERROR:        return maker.template make<ErrorMessage>();
+		case MessageType::ACK:          return maker.template make<AckMessage>();
+		// Hydroponic system messages
+		case MessageType::TOWER_JOIN_REQUEST:  return maker.template make<TowerJoinRequestMessage>();
+		case MessageType::TOWER_JOIN_ACCEPT:   return maker.template make<TowerJoinAcceptMessage>();
+		case MessageType::TOWER_TELEMETRY:     return maker.template make<TowerTelemetryMessage>();
+		case MessageType::TOWER_COMMAND:       return maker.template make<TowerCommandMessage>();
+		case MessageType::RESERVOIR_TELEMETRY: return maker.template make<ReservoirTelemetryMessage>();
+		case MessageType::TOWER_TELEMETRY_DELTA: return maker.template make<TowerTelemetryDeltaMessage>();
+		case MessageType::TOWER_TELEMETRY_SYNC:  return maker.template make<TowerTelemetrySyncMessage>();
+		case MessageType::TOWER_TELEMETRY_BATCH: return maker.template make<TowerTelemetryBatchMessage>();
+		// V2 Pairing messages
+		case MessageType::PAIRING_ADVERTISEMENT: return maker.template make<PairingAdvertisementMessage>();
+		case MessageType::PAIRING_OFFER:         return maker.template make<PairingOfferMessage>();
+		case MessageType::PAIRING_ACCEPT:        return maker.template make<PairingAcceptMessage>();
+		case MessageType::PAIRING_CONFIRM:       return maker.template make<PairingConfirmMessage>();
+		case MessageType::PAIRING_REJECT:        return maker.template make<PairingRejectMessage>();
+		case MessageType::PAIRING_ABORT:         return maker.template make<PairingAbortMessage>();
+		// OTA messages
+		case MessageType::OTA_BEGIN:       return maker.template make<OtaBeginMessage>();
+		case MessageType::OTA_CHUNK:       return maker.template make<OtaChunkMessage>();
+		case MessageType::OTA_CHUNK_ACK:   return maker.template make<OtaChunkAckMessage>();
+		case MessageType::OTA_ABORT:       return maker.template make<OtaAbortMessage>();
+		case MessageType::OTA_COMPLETE:    return maker.template make<OtaCompleteMessage>();
+		case MessageType::GROUP_COMMAND:   return maker.template make<GroupCommandMessage>();
+		default: return nullptr;
+	}
+}
+
+// One parse: the "msg" field picks the type, the same document fills the fields.
+// Unknown "msg" values decode as ErrorMessage, matching createMessage() so far.
+template <typename Maker>
+EspNowMessage* decodeJson(JsonDocument& doc, const char* json, size_t len, const Maker& maker) {
+	DeserializationError err = parseJson(doc, json, len);
+	if (err) {
+		Serial.printf("MessageFactory: Failed to parse message: %s\n", err.c_str());
+		return nullptr;
+	}
+	JsonObjectConst obj = doc.as<JsonObjectConst>();
+	EspNowMessage* m = makeMessage(MessageFactory::typeFromName(obj["msg"] | ""), maker);
+	if (m && !m->fromJsonObject(obj)) { maker.discard(m); return nullptr; }
+	return m;
+}
+
+template <typename Maker>
+EspNowMessage* decodeBinary(const uint8_t* buffer, size_t len, const Maker& maker) {
+	MessageType t = MessageFactory::getMessageTypeFromBinary(buffer, len);
+	if (t == MessageType::ERROR) return nullptr;
+	EspNowMessage* m = makeMessage(t, maker);
+	if (!m) {
+		Serial.printf("MessageFactory: Cannot create message from binary, type: %d\n", static_cast<int>(t));
+		return nullptr;
+	}
+	if (!m->fromBinary(buffer, len)) {
+		Serial.printf("MessageFactory: Failed to parse binary message of type %d\n", static_cast<int>(t));
+		maker.discard(m);
+		return nullptr;
+	}
+	return m;
+}
+
+} // namespace
+
+const char* statusModeName(StatusMode mode) {
+	uint8_t code = static_cast<uint8_t>(mode);
+	return code < STATUS_MODE_COUNT ? STATUS_MODES[code] : "";
+}
+
+StatusMode statusModeFromName(const char* name) {
+	if (name == nullptr || name[0] == '\0') return StatusMode::UNSET;
+	for (uint8_t i = 1; i < STATUS_MODE_COUNT; i++) {
+		if (strcmp(name, STATUS_MODES[i]) == 0) return static_cast<StatusMode>(i);
+	}
+	return StatusMode::UNSET;
+}
+
+StatusMode statusModeFromCode(uint8_t code) {
+	return code < STATUS_MODE_COUNT ? static_cast<StatusMode>(code) : StatusMode::UNSET;
+}
+
+int16_t schema::toCenti(float v) {
+	float scaled = v * 100.0f;
+	if (scaled > 32767.0f) return 32767;
+	if (scaled < -32768.0f) return -32768;
+	return static_cast<int16_t>(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+}
+
+uint16_t schema::toCentiUnsigned(float v) {
+	float scaled = v * 100.0f;
+	if (scaled > 65535.0f) return 65535;
+	if (scaled < 0.0f) return 0;
+	return static_cast<uint16_t>(scaled + 0.5f);
+}
+
+// --- Schema-driven codecs ---
+// Each message below declares its fields once (the *_FIELDS lists in
+// EspNowMessage.h); these expand a list into constructor defaults, the JSON
+// codec and, for messages with a compact frame, the binary codec.
+
+#define SCHEMA_DEFAULT_F(parent, member, key, Codec, def) member = def;
+#define SCHEMA_TO_JSON_F(parent, member, key, Codec, def) Codec::toJson(schema::objectFor(root, parent), key, member, def);
+#define SCHEMA_FROM_JSON_F(parent, member, key, Codec, def) Codec::fromJson(schema::objectIn(doc, parent), key, member, def);
+#define SCHEMA_PUT_F(parent, member, key, Codec, def) if (!Codec::put(p, member)) return 0; p += Codec::WIRE;
+#define SCHEMA_GET_F(parent, member, key, Codec, def) Codec::get(p, member, def); p += Codec::WIRE;
+
+// A parsed document holds the object slots plus copies of the frame's strings,
+// which together can never be longer than the frame itself.
+#define SCHEMA_JSON_CODEC(M, LIST) \
+	void M::fillJson(JsonDocument& doc) const { \
+		doc["msg"] = msg; \
+		JsonObject root = doc.as<JsonObject>(); \
+		LIST(SCHEMA_TO_JSON_F) \
+	} \
+	String M::toJson() const { return jsonString<JSON_CAPACITY>(*this); } \
+	size_t M::encode(uint8_t* out, size_t cap) const { return encodeJson<JSON_CAPACITY>(*this, out, cap); } \
+	bool M::fromJson(const String& json) { \
+		StaticJsonDocument<JSON_CAPACITY + WireConstants::MAX_FRAME_LEN> doc; \
+		DeserializationError err = parseJson(doc, json); \
+		if (err) return false; \
+		return fromJsonObject(doc.as<JsonObjectConst>()); \
+	} \
+	bool M::fromJsonObject(JsonObjectConst doc) { \
+		LIST(SCHEMA_FROM_JSON_F) \
+		return true; \
+	}
+
+// JSON-only fields are left out of the frame and reset to their defaults
+#define SCHEMA_BINARY_CODEC(M, LIST, MARKER) \
+	size_t M::toBinary(uint8_t* buffer, size_t maxLen) const { \
+		if (maxLen < BINARY_SIZE) return 0; \
+		uint8_t* p = buffer; \
+		*p++ = MARKER; \
+		*p++ = WireConstants::FORMAT_VERSION; \
+		LIST(SCHEMA_PUT_F) \
+		return p - buffer; \
+	} \
+	bool M::fromBinary(const uint8_t* buffer, size_t len) { \
+		if (!isCompactHeader(buffer, len, MARKER, BINARY_SIZE)) return false; \
+		const uint8_t* p = buffer + 2; \
+		LIST(SCHEMA_GET_F) \
+		ts = millis(); \
+		return true; \
+	}
 
 // --- JoinRequest ---
 JoinRequestMessage::JoinRequestMessage() {
 	type = MessageType::JOIN_REQUEST;
 	msg = "join_request";
 	ts = millis();
+	JOIN_REQUEST_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String JoinRequestMessage::toJson() const {
-	DynamicJsonDocument doc(512);
-	doc["msg"] = msg;
-	doc["mac"] = mac;
-	doc["fw"] = fw;
-	doc["caps"]["rgbw"] = caps.rgbw;
-	doc["caps"]["led_count"] = caps.led_count;
-	doc["caps"]["temp_i2c"] = caps.temp_i2c;
-	doc["caps"]["deep_sleep"] = caps.deep_sleep;
-	doc["caps"]["button"] = caps.button;
-	doc["token"] = token;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool JoinRequestMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(512);
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) return false;
-	msg = doc["msg"].as<String>();
-	mac = doc["mac"].as<String>();
-	fw = doc["fw"].as<String>();
-	caps.rgbw = doc["caps"]["rgbw"].as<bool>();
-	caps.led_count = doc["caps"]["led_count"].as<uint8_t>();
-	caps.temp_i2c = doc["caps"]["temp_i2c"] | false;
-	caps.deep_sleep = doc["caps"]["deep_sleep"].as<bool>();
-	caps.button = doc["caps"]["button"] | false;
-	token = doc["token"].as<String>();
-	return true;
-}
+SCHEMA_JSON_CODEC(JoinRequestMessage, JOIN_REQUEST_FIELDS)
 
 // --- JoinAccept ---
 JoinAcceptMessage::JoinAcceptMessage() {
 	type = MessageType::JOIN_ACCEPT;
 	msg = "join_accept";
 	ts = millis();
-	wifi_channel = 1; // Default to channel 1
-	// Initialize config struct with defaults
-	cfg.pwm_freq = 0;
-	cfg.rx_window_ms = 20;
-	cfg.rx_period_ms = 100;
+	JOIN_ACCEPT_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String JoinAcceptMessage::toJson() const {
-	DynamicJsonDocument doc(256);
-	doc["msg"] = msg;
-	doc["node_id"] = node_id;
-	doc["light_id"] = light_id;
-	doc["lmk"] = lmk;
-	doc["wifi_channel"] = wifi_channel;
-	doc["cfg"]["pwm_freq"] = cfg.pwm_freq;
-	doc["cfg"]["rx_window_ms"] = cfg.rx_window_ms;
-	doc["cfg"]["rx_period_ms"] = cfg.rx_period_ms;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool JoinAcceptMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(768); // Increased to handle full join_accept with nested config
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) {
-		Serial.printf("JoinAccept parse error: %s (buffer may be too small)\n", err.c_str());
-		Serial.printf("  Message length: %d bytes\n", json.length());
-		return false;
-	}
-	msg = doc["msg"].as<String>();
-	node_id = doc["node_id"].as<String>();
-	light_id = doc["light_id"].as<String>();
-	lmk = doc["lmk"].as<String>();
-	wifi_channel = doc["wifi_channel"] | 1; // Default to 1 if missing
-	cfg.pwm_freq = doc["cfg"]["pwm_freq"].as<int>();
-	cfg.rx_window_ms = doc["cfg"]["rx_window_ms"].as<int>();
-	cfg.rx_period_ms = doc["cfg"]["rx_period_ms"].as<int>();
-	return true;
-}
+SCHEMA_JSON_CODEC(JoinAcceptMessage, JOIN_ACCEPT_FIELDS)
 
 // --- SetLight ---
 SetLightMessage::SetLightMessage() {
 	type = MessageType::SET_LIGHT;
 	msg = "set_light";
 	ts = millis();
+	SET_LIGHT_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String SetLightMessage::toJson() const {
-	DynamicJsonDocument doc(384);
-	doc["msg"] = msg;
-	doc["cmd_id"] = cmd_id;
-	doc["light_id"] = light_id;
-	doc["r"] = r; doc["g"] = g; doc["b"] = b; doc["w"] = w;
-	doc["value"] = value;
-	doc["fade_ms"] = fade_ms;
-	doc["override_status"] = override_status;
-	doc["ttl_ms"] = ttl_ms;
-	doc["pixel"] = pixel; // -1 = all pixels, 0-3 = specific pixel
-	if (reason.length()) doc["reason"] = reason;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool SetLightMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(384);
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) return false;
-	msg = doc["msg"].as<String>();
-	cmd_id = doc["cmd_id"].as<String>();
-	light_id = doc["light_id"].as<String>();
-	// Fix: Use ternary operator or explicit checks instead of logical OR for default values
-	r = doc.containsKey("r") ? doc["r"].as<uint8_t>() : 0;
-	g = doc.containsKey("g") ? doc["g"].as<uint8_t>() : 0;
-	b = doc.containsKey("b") ? doc["b"].as<uint8_t>() : 0;
-	w = doc.containsKey("w") ? doc["w"].as<uint8_t>() : 0;
-	value = doc.containsKey("value") ? doc["value"].as<uint8_t>() : 0;
-	fade_ms = doc.containsKey("fade_ms") ? doc["fade_ms"].as<uint16_t>() : 0;
-	override_status = doc["override_status"] | false;
-	ttl_ms = doc.containsKey("ttl_ms") ? doc["ttl_ms"].as<uint16_t>() : 1500;
-	reason = doc["reason"].as<String>();
-	pixel = doc.containsKey("pixel") ? doc["pixel"].as<int8_t>() : -1;
-	return true;
-}
+SCHEMA_JSON_CODEC(SetLightMessage, SET_LIGHT_FIELDS)
+SCHEMA_BINARY_CODEC(SetLightMessage, SET_LIGHT_FIELDS, 0x40)
+static_assert(SetLightMessage::BINARY_SIZE == 49, "set_light compact layout changed");
 
 // --- NodeStatus ---
 NodeStatusMessage::NodeStatusMessage() {
 	type = MessageType::NODE_STATUS;
 	msg = "node_status";
 	ts = millis();
+	NODE_STATUS_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String NodeStatusMessage::toJson() const {
-	DynamicJsonDocument doc(384);
-	doc["msg"] = msg;
-	doc["node_id"] = node_id;
-	doc["light_id"] = light_id;
-	doc["avg_r"] = avg_r;
-	doc["avg_g"] = avg_g;
-	doc["avg_b"] = avg_b;
-	doc["avg_w"] = avg_w;
-	doc["status_mode"] = status_mode;
-	doc["vbat_mv"] = vbat_mv;
-	doc["temperature"] = temperature;
-	doc["button_pressed"] = button_pressed;
-	doc["fw"] = fw;
-	doc["ts"] = ts;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool NodeStatusMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(384); // Increased from 256 to handle 220-byte payload + overhead
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) return false;
-	msg = doc["msg"].as<String>();
-	node_id = doc["node_id"].as<String>();
-	light_id = doc["light_id"].as<String>();
-	// Fix: Use proper default value checks
-	avg_r = doc.containsKey("avg_r") ? doc["avg_r"].as<uint8_t>() : 0;
-	avg_g = doc.containsKey("avg_g") ? doc["avg_g"].as<uint8_t>() : 0;
-	avg_b = doc.containsKey("avg_b") ? doc["avg_b"].as<uint8_t>() : 0;
-	avg_w = doc.containsKey("avg_w") ? doc["avg_w"].as<uint8_t>() : 0;
-	status_mode = doc["status_mode"].as<String>();
-	vbat_mv = doc.containsKey("vbat_mv") ? doc["vbat_mv"].as<uint16_t>() : 0;
-	temperature = doc.containsKey("temperature") ? doc["temperature"].as<float>() : 0.0f;
-	button_pressed = doc.containsKey("button_pressed") ? doc["button_pressed"].as<bool>() : false;
-	fw = doc["fw"].as<String>();
-	ts = doc.containsKey("ts") ? doc["ts"].as<uint32_t>() : millis();
-	return true;
-}
+SCHEMA_JSON_CODEC(NodeStatusMessage, NODE_STATUS_FIELDS)
+SCHEMA_BINARY_CODEC(NodeStatusMessage, NODE_STATUS_FIELDS, 0x41)
+static_assert(NodeStatusMessage::BINARY_SIZE == 64, "node_status compact layout changed");
 
 // --- Error ---
 ErrorMessage::ErrorMessage() {
 	type = MessageType::ERROR;
 	msg = "error";
 	ts = millis();
+	ERROR_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String ErrorMessage::toJson() const {
-	DynamicJsonDocument doc(192);
-	doc["msg"] = msg;
-	doc["node_id"] = node_id;
-	doc["code"] = code;
-	doc["info"] = info;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool ErrorMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(192);
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) return false;
-	msg = doc["msg"].as<String>();
-	node_id = doc["node_id"].as<String>();
-	code = doc["code"].as<String>();
-	info = doc["info"].as<String>();
-	return true;
-}
+SCHEMA_JSON_CODEC(ErrorMessage, ERROR_FIELDS)
 
 // --- Ack ---
 AckMessage::AckMessage() {
 	type = MessageType::ACK;
 	msg = "ack";
 	ts = millis();
+	ACK_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String AckMessage::toJson() const {
-	DynamicJsonDocument doc(96);
-	doc["msg"] = msg;
-	doc["cmd_id"] = cmd_id;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool AckMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(96);
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) return false;
-	msg = doc["msg"].as<String>();
-	cmd_id = doc["cmd_id"].as<String>();
-	return true;
-}
+SCHEMA_JSON_CODEC(AckMessage, ACK_FIELDS)
+SCHEMA_BINARY_CODEC(AckMessage, ACK_FIELDS, 0x48)
+static_assert(AckMessage::BINARY_SIZE == 5, "ack compact layout changed");
 
 // ============================================================================
 // HYDROPONIC SYSTEM MESSAGE IMPLEMENTATIONS
@@ -228,142 +328,30 @@ bool AckMessage::fromJson(const String& json) {
 TowerJoinRequestMessage::TowerJoinRequestMessage() {
 	type = MessageType::TOWER_JOIN_REQUEST;
 	msg = "tower_join_request";
-	ts = millis();
-	caps.dht_sensor = false;
-	caps.light_sensor = false;
-	caps.pump_relay = false;
-	caps.grow_light = false;
-	caps.slot_count = 6;
+	TOWER_JOIN_REQUEST_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String TowerJoinRequestMessage::toJson() const {
-	DynamicJsonDocument doc(384);
-	doc["msg"] = msg;
-	doc["mac"] = mac;
-	doc["fw"] = fw;
-	doc["caps"]["dht_sensor"] = caps.dht_sensor;
-	doc["caps"]["light_sensor"] = caps.light_sensor;
-	doc["caps"]["pump_relay"] = caps.pump_relay;
-	doc["caps"]["grow_light"] = caps.grow_light;
-	doc["caps"]["slot_count"] = caps.slot_count;
-	doc["token"] = token;
-	doc["ts"] = ts;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool TowerJoinRequestMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(384);
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) return false;
-	msg = doc["msg"].as<String>();
-	mac = doc["mac"].as<String>();
-	fw = doc["fw"].as<String>();
-	caps.dht_sensor = doc["caps"]["dht_sensor"] | false;
-	caps.light_sensor = doc["caps"]["light_sensor"] | false;
-	caps.pump_relay = doc["caps"]["pump_relay"] | false;
-	caps.grow_light = doc["caps"]["grow_light"] | false;
-	caps.slot_count = doc["caps"]["slot_count"] | 6;
-	token = doc["token"].as<String>();
-	ts = doc["ts"] | millis();
-	return true;
-}
+SCHEMA_JSON_CODEC(TowerJoinRequestMessage, TOWER_JOIN_REQUEST_FIELDS)
 
 // --- TowerJoinAccept ---
 TowerJoinAcceptMessage::TowerJoinAcceptMessage() {
 	type = MessageType::TOWER_JOIN_ACCEPT;
 	msg = "tower_join_accept";
-	ts = millis();
-	wifi_channel = 1;
-	cfg.telemetry_interval_ms = 30000;  // 30 seconds default
-	cfg.pump_max_duration_s = 300;      // 5 minutes max pump time
+	TOWER_JOIN_ACCEPT_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String TowerJoinAcceptMessage::toJson() const {
-	DynamicJsonDocument doc(384);
-	doc["msg"] = msg;
-	doc["tower_id"] = tower_id;
-	doc["coord_id"] = coord_id;
-	doc["farm_id"] = farm_id;
-	doc["lmk"] = lmk;
-	doc["wifi_channel"] = wifi_channel;
-	doc["cfg"]["telemetry_interval_ms"] = cfg.telemetry_interval_ms;
-	doc["cfg"]["pump_max_duration_s"] = cfg.pump_max_duration_s;
-	doc["ts"] = ts;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool TowerJoinAcceptMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(512);
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) {
-		Serial.printf("TowerJoinAccept parse error: %s\n", err.c_str());
-		return false;
-	}
-	msg = doc["msg"].as<String>();
-	tower_id = doc["tower_id"].as<String>();
-	coord_id = doc["coord_id"].as<String>();
-	farm_id = doc["farm_id"].as<String>();
-	lmk = doc["lmk"].as<String>();
-	wifi_channel = doc["wifi_channel"] | 1;
-	cfg.telemetry_interval_ms = doc["cfg"]["telemetry_interval_ms"] | 30000;
-	cfg.pump_max_duration_s = doc["cfg"]["pump_max_duration_s"] | 300;
-	ts = doc["ts"] | millis();
-	return true;
-}
+SCHEMA_JSON_CODEC(TowerJoinAcceptMessage, TOWER_JOIN_ACCEPT_FIELDS)
 
 // --- TowerTelemetry ---
 TowerTelemetryMessage::TowerTelemetryMessage() {
 	type = MessageType::TOWER_TELEMETRY;
 	msg = "tower_telemetry";
-	ts = millis();
-	air_temp_c = 0.0f;
-	humidity_pct = 0.0f;
-	light_lux = 0.0f;
-	pump_on = false;
-	light_on = false;
-	light_brightness = 0;
-	status_mode = "operational";
-	vbat_mv = 0;
-	uptime_s = 0;
+	TOWER_TELEMETRY_FIELDS(SCHEMA_DEFAULT_F)
 }
 
-String TowerTelemetryMessage::toJson() const {
-	DynamicJsonDocument doc(512);
-	doc["msg"] = msg;
-	doc["tower_id"] = tower_id;
-	doc["air_temp_c"] = air_temp_c;
-	doc["humidity_pct"] = humidity_pct;
-	doc["light_lux"] = light_lux;
-	doc["pump_on"] = pump_on;
-	doc["light_on"] = light_on;
-	doc["light_brightness"] = light_brightness;
-	doc["status_mode"] = status_mode;
-	doc["vbat_mv"] = vbat_mv;
-	doc["fw"] = fw;
-	doc["uptime_s"] = uptime_s;
-	doc["ts"] = ts;
-	String out; serializeJson(doc, out); return out;
-}
-
-bool TowerTelemetryMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(512);
-	DeserializationError err = deserializeJson(doc, json);
-	if (err) return false;
-	msg = doc["msg"].as<String>();
-	tower_id = doc["tower_id"].as<String>();
-	air_temp_c = doc["air_temp_c"] | 0.0f;
-	humidity_pct = doc["humidity_pct"] | 0.0f;
-	light_lux = doc["light_lux"] | 0.0f;
-	pump_on = doc["pump_on"] | false;
-	light_on = doc["light_on"] | false;
-	light_brightness = doc["light_brightness"] | 0;
-	status_mode = doc["status_mode"].as<String>();
-	vbat_mv = doc["vbat_mv"] | 0;
-	fw = doc["fw"].as<String>();
-	uptime_s = doc["uptime_s"] | 0;
-	ts = doc["ts"] | millis();
-	return true;
-}
+SCHEMA_JSON_CODEC(TowerTelemetryMessage, TOWER_TELEMETRY_FIELDS)
+SCHEMA_BINARY_CODEC(TowerTelemetryMessage, TOWER_TELEMETRY_FIELDS, 0x42)
+static_assert(TowerTelemetryMessage::BINARY_SIZE == 53, "tower_telemetry compact layout changed");
 
 // --- TowerCommand ---
 TowerCommandMessage::TowerCommandMessage() {
@@ -378,12 +366,11 @@ TowerCommandMessage::TowerCommandMessage() {
 	ttl_ms = 5000;  // 5 second default TTL
 }
 
-String TowerCommandMessage::toJson() const {
-	DynamicJsonDocument doc(512);
+void TowerCommandMessage::fillJson(JsonDocument& doc) const {
 	doc["msg"] = msg;
-	doc["cmd_id"] = cmd_id;
-	doc["tower_id"] = tower_id;
-	doc["command"] = command;
+	doc["cmd_id"] = cmd_id.c_str();
+	doc["tower_id"] = tower_id.c_str();
+	doc["command"] = command.c_str();
 	
 	// Pump control fields
 	if (command == "set_pump") {
@@ -400,23 +387,33 @@ String TowerCommandMessage::toJson() const {
 	
 	// OTA fields
 	if (command == "ota") {
-		doc["ota_url"] = ota_url;
-		doc["ota_checksum"] = ota_checksum;
+		doc["ota_url"] = ota_url.c_str();
+		doc["ota_checksum"] = ota_checksum.c_str();
 	}
 	
 	doc["ttl_ms"] = ttl_ms;
 	doc["ts"] = ts;
-	String out; serializeJson(doc, out); return out;
+}
+
+String TowerCommandMessage::toJson() const {
+	return jsonString<JSON_CAPACITY>(*this);
+}
+
+size_t TowerCommandMessage::encode(uint8_t* out, size_t cap) const {
+	return encodeJson<JSON_CAPACITY>(*this, out, cap);
 }
 
 bool TowerCommandMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(512);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
-	cmd_id = doc["cmd_id"].as<String>();
-	tower_id = doc["tower_id"].as<String>();
-	command = doc["command"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool TowerCommandMessage::fromJsonObject(JsonObjectConst doc) {
+	cmd_id = doc["cmd_id"] | "";
+	tower_id = doc["tower_id"] | "";
+	command = doc["command"] | "";
 	
 	// Pump control
 	pump_on = doc["pump_on"] | false;
@@ -436,69 +433,536 @@ bool TowerCommandMessage::fromJson(const String& json) {
 	return true;
 }
 
-// --- ReservoirTelemetry ---
-ReservoirTelemetryMessage::ReservoirTelemetryMessage() {
-	type = MessageType::RESERVOIR_TELEMETRY;
-	msg = "reservoir_telemetry";
+size_t TowerCommandMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
+	if (maxLen < BINARY_SIZE) return 0;
+	uint8_t code = towerCommandToCode(command);
+	if (code == 0xFF) return 0; // "ota" and unknown commands go as JSON
+	size_t pos = 0;
+	buffer[pos++] = 0x43; // TOWER_COMMAND compact marker
+	buffer[pos++] = WireConstants::FORMAT_VERSION;
+	if (!putFixedString(&buffer[pos], cmd_id, WireConstants::ID_FIELD_LEN)) return 0;
+	pos += WireConstants::ID_FIELD_LEN;
+	if (!putFixedString(&buffer[pos], tower_id, WireConstants::ID_FIELD_LEN)) return 0;
+	pos += WireConstants::ID_FIELD_LEN;
+	buffer[pos++] = code;
+	buffer[pos++] = (pump_on ? 0x01 : 0x00) | (light_on ? 0x02 : 0x00);
+	memcpy(&buffer[pos], &pump_duration_s, 2); pos += 2;
+	buffer[pos++] = light_brightness;
+	memcpy(&buffer[pos], &light_duration_m, 2); pos += 2;
+	memcpy(&buffer[pos], &ttl_ms, 2); pos += 2;
+	return pos; // 47 bytes total
+}
+
+bool TowerCommandMessage::fromBinary(const uint8_t* buffer, size_t len) {
+	if (!isCompactHeader(buffer, len, 0x43, BINARY_SIZE)) return false;
+	size_t pos = 2;
+	getFixedString(cmd_id, &buffer[pos], WireConstants::ID_FIELD_LEN); pos += WireConstants::ID_FIELD_LEN;
+	getFixedString(tower_id, &buffer[pos], WireConstants::ID_FIELD_LEN); pos += WireConstants::ID_FIELD_LEN;
+	uint8_t code = buffer[pos++];
+	if (code >= TOWER_COMMAND_COUNT) return false;
+	command = TOWER_COMMANDS[code];
+	uint8_t flags = buffer[pos++];
+	pump_on = (flags & 0x01) != 0;
+	light_on = (flags & 0x02) != 0;
+	memcpy(&pump_duration_s, &buffer[pos], 2); pos += 2;
+	light_brightness = buffer[pos++];
+	memcpy(&light_duration_m, &buffer[pos], 2); pos += 2;
+	memcpy(&ttl_ms, &buffer[pos], 2); pos += 2;
+	ota_url = "";
+	ota_checksum = "";
 	ts = millis();
-	ph = 0.0f;
-	ec_ms_cm = 0.0f;
-	tds_ppm = 0.0f;
-	water_temp_c = 0.0f;
-	water_level_pct = 0.0f;
-	water_level_cm = 0.0f;
-	low_water_alert = false;
-	main_pump_on = false;
-	dosing_pump_ph_on = false;
-	dosing_pump_nutrient_on = false;
-	status_mode = "operational";
-	uptime_s = 0;
-}
-
-String ReservoirTelemetryMessage::toJson() const {
-	DynamicJsonDocument doc(512);
+	return true;
+}
+
+// --- TowerTelemetryDelta (0x44) ---
+TowerTelemetryDeltaMessage::TowerTelemetryDeltaMessage() {
+	type = MessageType::TOWER_TELEMETRY_DELTA;
+	msg = "tower_telemetry_delta";
+	ts = millis();
+	key_id = 0;
+	keyframe = false;
+	present = 0;
+}
+
+uint16_t TowerTelemetryDeltaMessage::changedFields(const TowerTelemetryMessage& a, const TowerTelemetryMessage& b) {
+	uint16_t bits = 0;
+	if (toCenti(a.air_temp_c) != toCenti(b.air_temp_c)) bits |= AIR_TEMP;
+	if (toCentiUnsigned(a.humidity_pct) != toCentiUnsigned(b.humidity_pct)) bits |= HUMIDITY;
+	if (memcmp(&a.light_lux, &b.light_lux, sizeof(float)) != 0) bits |= LIGHT_LUX;
+	if (actuatorFlags(a) != actuatorFlags(b)) bits |= ACTUATORS;
+	if (a.light_brightness != b.light_brightness) bits |= LIGHT_BRIGHTNESS;
+	if (a.status_mode != b.status_mode) bits |= STATUS_MODE;
+	if (a.vbat_mv != b.vbat_mv) bits |= VBAT;
+	if (a.fw != b.fw) bits |= FW;
+	if (a.uptime_s != b.uptime_s) bits |= UPTIME;
+	return bits;
+}
+
+void TowerTelemetryDeltaMessage::capture(const TowerTelemetryMessage& current, const TowerTelemetryMessage* base, uint8_t keyId) {
+	values = current;
+	key_id = keyId;
+	keyframe = (base == nullptr);
+	present = keyframe ? static_cast<uint16_t>(ALL_FIELDS) : changedFields(current, *base);
+	ts = current.ts;
+}
+
+void TowerTelemetryDeltaMessage::applyTo(TowerTelemetryMessage& state) const {
+	if (keyframe) state.tower_id = values.tower_id;
+	if (present & AIR_TEMP) state.air_temp_c = values.air_temp_c;
+	if (present & HUMIDITY) state.humidity_pct = values.humidity_pct;
+	if (present & LIGHT_LUX) state.light_lux = values.light_lux;
+	if (present & ACTUATORS) {
+		state.pump_on = values.pump_on;
+		state.light_on = values.light_on;
+	}
+	if (present & LIGHT_BRIGHTNESS) state.light_brightness = values.light_brightness;
+	if (present & STATUS_MODE) state.status_mode = values.status_mode;
+	if (present & VBAT) state.vbat_mv = values.vbat_mv;
+	if (present & FW) state.fw = values.fw;
+	if (present & UPTIME) state.uptime_s = values.uptime_s;
+	state.ts = ts;
+}
+
+String TowerTelemetryDeltaMessage::toJson() const {
+	DynamicJsonDocument doc(256);
 	doc["msg"] = msg;
-	doc["coord_id"] = coord_id;
-	doc["farm_id"] = farm_id;
-	doc["ph"] = ph;
-	doc["ec_ms_cm"] = ec_ms_cm;
-	doc["tds_ppm"] = tds_ppm;
-	doc["water_temp_c"] = water_temp_c;
-	doc["water_level_pct"] = water_level_pct;
-	doc["water_level_cm"] = water_level_cm;
-	doc["low_water_alert"] = low_water_alert;
-	doc["main_pump_on"] = main_pump_on;
-	doc["dosing_pump_ph_on"] = dosing_pump_ph_on;
-	doc["dosing_pump_nutrient_on"] = dosing_pump_nutrient_on;
-	doc["status_mode"] = status_mode;
-	doc["uptime_s"] = uptime_s;
+	doc["key_id"] = key_id;
+	doc["keyframe"] = keyframe;
+	doc["present"] = present;
 	doc["ts"] = ts;
 	String out; serializeJson(doc, out); return out;
 }
 
-bool ReservoirTelemetryMessage::fromJson(const String& json) {
-	DynamicJsonDocument doc(512);
-	DeserializationError err = deserializeJson(doc, json);
+bool TowerTelemetryDeltaMessage::fromJson(const String& json) {
+	(void)json;
+	return false;
+}
+
+bool TowerTelemetryDeltaMessage::fromJsonObject(JsonObjectConst doc) {
+	// Field values only travel in the binary layout
+	(void)doc;
+	return false;
+}
+
+size_t TowerTelemetryDeltaMessage::binarySize() const {
+	size_t size = HEADER_SIZE + (keyframe ? WireConstants::ID_FIELD_LEN : 0);
+	for (uint8_t i = 0; i < DELTA_FIELD_COUNT; i++) {
+		if (present & (1u << i)) size += DELTA_FIELD_WIDTHS[i];
+	}
+	return size;
+}
+
+size_t TowerTelemetryDeltaMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
+	// A keyframe must be complete to serve as a baseline
+	if ((present & ~ALL_FIELDS) != 0 || (keyframe && present != ALL_FIELDS)) return 0;
+	if (maxLen < binarySize()) return 0;
+	size_t pos = 0;
+	buffer[pos++] = 0x44; // TOWER_TELEMETRY_DELTA compact marker
+	buffer[pos++] = WireConstants::FORMAT_VERSION;
+	buffer[pos++] = keyframe ? 0x01 : 0x00;
+	buffer[pos++] = key_id;
+	memcpy(&buffer[pos], &present, 2); pos += 2;
+	if (keyframe) {
+		if (!putFixedString(&buffer[pos], values.tower_id, WireConstants::ID_FIELD_LEN)) return 0;
+		pos += WireConstants::ID_FIELD_LEN;
+	}
+	if (present & AIR_TEMP) {
+		int16_t airCenti = toCenti(values.air_temp_c);
+		memcpy(&buffer[pos], &airCenti, 2); pos += 2;
+	}
+	if (present & HUMIDITY) {
+		uint16_t humidityCenti = toCentiUnsigned(values.humidity_pct);
+		memcpy(&buffer[pos], &humidityCenti, 2); pos += 2;
+	}
+	if (present & LIGHT_LUX) { memcpy(&buffer[pos], &values.light_lux, 4); pos += 4; }
+	if (present & ACTUATORS) buffer[pos++] = actuatorFlags(values);
+	if (present & LIGHT_BRIGHTNESS) buffer[pos++] = values.light_brightness;
+	if (present & STATUS_MODE) buffer[pos++] = static_cast<uint8_t>(values.status_mode);
+	if (present & VBAT) { memcpy(&buffer[pos], &values.vbat_mv, 2); pos += 2; }
+	if (present & FW) {
+		if (!putFixedString(&buffer[pos], values.fw, WireConstants::FW_FIELD_LEN)) return 0;
+		pos += WireConstants::FW_FIELD_LEN;
+	}
+	if (present & UPTIME) { memcpy(&buffer[pos], &values.uptime_s, 4); pos += 4; }
+	return pos;
+}
+
+size_t TowerTelemetryDeltaMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
+bool TowerTelemetryDeltaMessage::fromBinary(const uint8_t* buffer, size_t len) {
+	if (!isCompactHeader(buffer, len, 0x44, HEADER_SIZE)) return false;
+	keyframe = (buffer[2] & 0x01) != 0;
+	key_id = buffer[3];
+	memcpy(&present, &buffer[4], 2);
+	if ((present & ~ALL_FIELDS) != 0 || (keyframe && present != ALL_FIELDS)) return false;
+	if (len < binarySize()) return false;
+	values = TowerTelemetryMessage();
+	size_t pos = HEADER_SIZE;
+	if (keyframe) {
+		getFixedString(values.tower_id, &buffer[pos], WireConstants::ID_FIELD_LEN);
+		pos += WireConstants::ID_FIELD_LEN;
+	}
+	if (present & AIR_TEMP) {
+		int16_t airCenti;
+		memcpy(&airCenti, &buffer[pos], 2); pos += 2;
+		values.air_temp_c = airCenti / 100.0f;
+	}
+	if (present & HUMIDITY) {
+		uint16_t humidityCenti;
+		memcpy(&humidityCenti, &buffer[pos], 2); pos += 2;
+		values.humidity_pct = humidityCenti / 100.0f;
+	}
+	if (present & LIGHT_LUX) { memcpy(&values.light_lux, &buffer[pos], 4); pos += 4; }
+	if (present & ACTUATORS) {
+		uint8_t flags = buffer[pos++];
+		values.pump_on = (flags & 0x01) != 0;
+		values.light_on = (flags & 0x02) != 0;
+	}
+	if (present & LIGHT_BRIGHTNESS) values.light_brightness = buffer[pos++];
+	if (present & STATUS_MODE) values.status_mode = statusModeFromCode(buffer[pos++]);
+	if (present & VBAT) { memcpy(&values.vbat_mv, &buffer[pos], 2); pos += 2; }
+	if (present & FW) {
+		getFixedString(values.fw, &buffer[pos], WireConstants::FW_FIELD_LEN);
+		pos += WireConstants::FW_FIELD_LEN;
+	}
+	if (present & UPTIME) { memcpy(&values.uptime_s, &buffer[pos], 4); pos += 4; }
+	ts = millis();
+	values.ts = ts;
+	return true;
+}
+
+// --- TowerTelemetrySync (0x45) ---
+TowerTelemetrySyncMessage::TowerTelemetrySyncMessage() {
+	type = MessageType::TOWER_TELEMETRY_SYNC;
+	msg = "tower_telemetry_sync";
+	ts = millis();
+	key_id = 0;
+	keyframe_request = false;
+}
+
+String TowerTelemetrySyncMessage::toJson() const {
+	DynamicJsonDocument doc(128);
+	doc["msg"] = msg;
+	doc["key_id"] = key_id;
+	doc["keyframe_request"] = keyframe_request;
+	doc["ts"] = ts;
+	String out; serializeJson(doc, out); return out;
+}
+
+bool TowerTelemetrySyncMessage::fromJson(const String& json) {
+	DynamicJsonDocument doc(128);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
-	coord_id = doc["coord_id"].as<String>();
-	farm_id = doc["farm_id"].as<String>();
-	ph = doc["ph"] | 0.0f;
-	ec_ms_cm = doc["ec_ms_cm"] | 0.0f;
-	tds_ppm = doc["tds_ppm"] | 0.0f;
-	water_temp_c = doc["water_temp_c"] | 0.0f;
-	water_level_pct = doc["water_level_pct"] | 0.0f;
-	water_level_cm = doc["water_level_cm"] | 0.0f;
-	low_water_alert = doc["low_water_alert"] | false;
-	main_pump_on = doc["main_pump_on"] | false;
-	dosing_pump_ph_on = doc["dosing_pump_ph_on"] | false;
-	dosing_pump_nutrient_on = doc["dosing_pump_nutrient_on"] | false;
-	status_mode = doc["status_mode"].as<String>();
-	uptime_s = doc["uptime_s"] | 0;
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool TowerTelemetrySyncMessage::fromJsonObject(JsonObjectConst doc) {
+	key_id = doc["key_id"] | 0;
+	keyframe_request = doc["keyframe_request"] | false;
 	ts = doc["ts"] | millis();
 	return true;
 }
 
+size_t TowerTelemetrySyncMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
+	if (maxLen < BINARY_SIZE) return 0;
+	size_t pos = 0;
+	buffer[pos++] = 0x45; // TOWER_TELEMETRY_SYNC compact marker
+	buffer[pos++] = WireConstants::FORMAT_VERSION;
+	buffer[pos++] = key_id;
+	buffer[pos++] = keyframe_request ? 0x01 : 0x00;
+	return pos; // 4 bytes total
+}
+
+size_t TowerTelemetrySyncMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
+bool TowerTelemetrySyncMessage::fromBinary(const uint8_t* buffer, size_t len) {
+	if (!isCompactHeader(buffer, len, 0x45, BINARY_SIZE)) return false;
+	key_id = buffer[2];
+	keyframe_request = (buffer[3] & 0x01) != 0;
+	ts = millis();
+	return true;
+}
+
+// --- TowerTelemetryBatch (0x46) ---
+TowerTelemetryBatchMessage::TowerTelemetryBatchMessage() {
+	type = MessageType::TOWER_TELEMETRY_BATCH;
+	msg = "tower_telemetry_batch";
+	ts = millis();
+	count = 0;
+}
+
+bool TowerTelemetryBatchMessage::append(const TowerTelemetryMessage& m) {
+	bool kept = !isFull();
+	if (!kept) {
+		memmove(&samples[0], &samples[1], (MAX_SAMPLES - 1) * sizeof(Sample));
+		count = MAX_SAMPLES - 1;
+	}
+	tower_id = m.tower_id;
+	fw = m.fw;
+	Sample& s = samples[count++];
+	s.ts = m.ts;
+	s.air_temp_c = m.air_temp_c;
+	s.humidity_pct = m.humidity_pct;
+	s.light_lux = m.light_lux;
+	s.pump_on = m.pump_on;
+	s.light_on = m.light_on;
+	s.light_brightness = m.light_brightness;
+	s.status_mode = m.status_mode;
+	s.vbat_mv = m.vbat_mv;
+	s.uptime_s = m.uptime_s;
+	return kept;
+}
+
+void TowerTelemetryBatchMessage::sample(uint8_t i, TowerTelemetryMessage& out) const {
+	const Sample& s = samples[i < count ? i : 0];
+	out.tower_id = tower_id;
+	out.fw = fw;
+	out.ts = s.ts;
+	out.air_temp_c = s.air_temp_c;
+	out.humidity_pct = s.humidity_pct;
+	out.light_lux = s.light_lux;
+	out.pump_on = s.pump_on;
+	out.light_on = s.light_on;
+	out.light_brightness = s.light_brightness;
+	out.status_mode = s.status_mode;
+	out.vbat_mv = s.vbat_mv;
+	out.uptime_s = s.uptime_s;
+}
+
+String TowerTelemetryBatchMessage::toJson() const {
+	DynamicJsonDocument doc(256);
+	doc["msg"] = msg;
+	doc["tower_id"] = tower_id.c_str();
+	doc["count"] = count;
+	doc["ts"] = ts;
+	String out; serializeJson(doc, out); return out;
+}
+
+bool TowerTelemetryBatchMessage::fromJson(const String& json) {
+	(void)json;
+	return false;
+}
+
+bool TowerTelemetryBatchMessage::fromJsonObject(JsonObjectConst doc) {
+	// Samples only travel in the binary layout
+	(void)doc;
+	return false;
+}
+
+size_t TowerTelemetryBatchMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
+	if (count == 0 || count > MAX_SAMPLES || maxLen < binarySize()) return 0;
+	size_t pos = 0;
+	buffer[pos++] = 0x46; // TOWER_TELEMETRY_BATCH compact marker
+	buffer[pos++] = WireConstants::FORMAT_VERSION;
+	buffer[pos++] = count;
+	if (!putFixedString(&buffer[pos], tower_id, WireConstants::ID_FIELD_LEN)) return 0;
+	pos += WireConstants::ID_FIELD_LEN;
+	if (!putFixedString(&buffer[pos], fw, WireConstants::FW_FIELD_LEN)) return 0;
+	pos += WireConstants::FW_FIELD_LEN;
+	for (uint8_t i = 0; i < count; i++) {
+		const Sample& s = samples[i];
+		uint32_t age = ts - s.ts;
+		int16_t airCenti = toCenti(s.air_temp_c);
+		uint16_t humidityCenti = toCentiUnsigned(s.humidity_pct);
+		memcpy(&buffer[pos], &age, 4); pos += 4;
+		memcpy(&buffer[pos], &airCenti, 2); pos += 2;
+		memcpy(&buffer[pos], &humidityCenti, 2); pos += 2;
+		memcpy(&buffer[pos], &s.light_lux, 4); pos += 4;
+		buffer[pos++] = (s.pump_on ? 0x01 : 0x00) | (s.light_on ? 0x02 : 0x00);
+		buffer[pos++] = s.light_brightness;
+		buffer[pos++] = static_cast<uint8_t>(s.status_mode);
+		memcpy(&buffer[pos], &s.vbat_mv, 2); pos += 2;
+		memcpy(&buffer[pos], &s.uptime_s, 4); pos += 4;
+	}
+	return pos;
+}
+
+size_t TowerTelemetryBatchMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
+bool TowerTelemetryBatchMessage::fromBinary(const uint8_t* buffer, size_t len) {
+	if (!isCompactHeader(buffer, len, 0x46, HEADER_SIZE)) return false;
+	uint8_t n = buffer[2];
+	if (n == 0 || n > MAX_SAMPLES || len < HEADER_SIZE + n * SAMPLE_SIZE) return false;
+	count = n;
+	size_t pos = 3;
+	getFixedString(tower_id, &buffer[pos], WireConstants::ID_FIELD_LEN); pos += WireConstants::ID_FIELD_LEN;
+	getFixedString(fw, &buffer[pos], WireConstants::FW_FIELD_LEN); pos += WireConstants::FW_FIELD_LEN;
+	ts = millis();
+	for (uint8_t i = 0; i < count; i++) {
+		Sample& s = samples[i];
+		uint32_t age;
+		int16_t airCenti;
+		uint16_t humidityCenti;
+		memcpy(&age, &buffer[pos], 4); pos += 4;
+		memcpy(&airCenti, &buffer[pos], 2); pos += 2;
+		memcpy(&humidityCenti, &buffer[pos], 2); pos += 2;
+		s.ts = ts - age;
+		s.air_temp_c = airCenti / 100.0f;
+		s.humidity_pct = humidityCenti / 100.0f;
+		memcpy(&s.light_lux, &buffer[pos], 4); pos += 4;
+		uint8_t flags = buffer[pos++];
+		s.pump_on = (flags & 0x01) != 0;
+		s.light_on = (flags & 0x02) != 0;
+		s.light_brightness = buffer[pos++];
+		s.status_mode = statusModeFromCode(buffer[pos++]);
+		memcpy(&s.vbat_mv, &buffer[pos], 2); pos += 2;
+		memcpy(&s.uptime_s, &buffer[pos], 4); pos += 4;
+	}
+	return true;
+}
+
+// --- GroupCommand (0x47) ---
+GroupCommandMessage::GroupCommandMessage() {
+	type = MessageType::GROUP_COMMAND;
+	msg = "group_command";
+	ts = millis();
+	cmd_seq = 0;
+	group_id = GroupConstants::GROUP_ALL;
+	member_bytes = 0;
+	memset(members, 0, sizeof(members));
+	r = g = b = w = 0;
+	value = 0;
+	fade_ms = 0;
+	ttl_ms = 1500;
+	pixel = -1;
+	override_status = false;
+	delay_ms = 0;
+	stagger_ms = 0;
+	hold_ms = 0;
+}
+
+bool GroupCommandMessage::addMember(uint8_t index) {
+	if (index >= GroupConstants::MAX_MEMBERS) return false;
+	uint8_t byte = index / 8;
+	if (byte >= member_bytes) {
+		memset(&members[member_bytes], 0, byte + 1 - member_bytes);
+		member_bytes = byte + 1;
+	}
+	members[byte] |= (uint8_t)(1u << (index % 8));
+	return true;
+}
+
+bool GroupCommandMessage::isMember(uint8_t index) const {
+	if (member_bytes == 0) return true;
+	if (index >= GroupConstants::MAX_MEMBERS || index / 8 >= member_bytes) return false;
+	return (members[index / 8] & (1u << (index % 8))) != 0;
+}
+
+uint8_t GroupCommandMessage::rankOf(uint8_t index) const {
+	if (member_bytes == 0) return index == GroupConstants::NO_MEMBER ? 0 : index;
+	if (index / 8 >= member_bytes) return 0;
+	uint8_t rank = 0;
+	for (uint8_t i = 0; i < index / 8; i++) {
+		for (uint8_t bits = members[i]; bits; bits &= bits - 1) rank++;
+	}
+	for (uint8_t bits = members[index / 8] & ((1u << (index % 8)) - 1); bits; bits &= bits - 1) rank++;
+	return rank;
+}
+
+void GroupCommandMessage::toSetLight(SetLightMessage& out) const {
+	out.cmd_id = "";
+	out.light_id = "";
+	out.r = r; out.g = g; out.b = b; out.w = w;
+	out.value = value;
+	out.fade_ms = fade_ms;
+	out.ttl_ms = ttl_ms;
+	out.pixel = pixel;
+	out.override_status = override_status;
+}
+
+String GroupCommandMessage::toJson() const {
+	DynamicJsonDocument doc(256);
+	doc["msg"] = msg;
+	doc["cmd_seq"] = cmd_seq;
+	doc["group_id"] = group_id;
+	doc["member_bytes"] = member_bytes;
+	doc["r"] = r; doc["g"] = g; doc["b"] = b; doc["w"] = w;
+	doc["delay_ms"] = delay_ms;
+	doc["stagger_ms"] = stagger_ms;
+	doc["hold_ms"] = hold_ms;
+	String out; serializeJson(doc, out); return out;
+}
+
+bool GroupCommandMessage::fromJson(const String& json) {
+	(void)json;
+	return false;
+}
+
+bool GroupCommandMessage::fromJsonObject(JsonObjectConst doc) {
+	// Broadcast to every node: only the binary layout is defined
+	(void)doc;
+	return false;
+}
+
+size_t GroupCommandMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
+	if (member_bytes > GroupConstants::BITMAP_BYTES || maxLen < binarySize()) return 0;
+	size_t pos = 0;
+	buffer[pos++] = 0x47; // GROUP_COMMAND compact marker
+	buffer[pos++] = WireConstants::FORMAT_VERSION;
+	buffer[pos++] = cmd_seq;
+	buffer[pos++] = group_id;
+	buffer[pos++] = member_bytes;
+	buffer[pos++] = r;
+	buffer[pos++] = g;
+	buffer[pos++] = b;
+	buffer[pos++] = w;
+	buffer[pos++] = value;
+	memcpy(&buffer[pos], &fade_ms, 2); pos += 2;
+	memcpy(&buffer[pos], &ttl_ms, 2); pos += 2;
+	buffer[pos++] = (uint8_t)pixel;
+	buffer[pos++] = override_status ? 0x01 : 0x00;
+	memcpy(&buffer[pos], &delay_ms, 2); pos += 2;
+	memcpy(&buffer[pos], &stagger_ms, 2); pos += 2;
+	memcpy(&buffer[pos], &hold_ms, 2); pos += 2;
+	memcpy(&buffer[pos], members, member_bytes); pos += member_bytes;
+	return pos;
+}
+
+size_t GroupCommandMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
+bool GroupCommandMessage::fromBinary(const uint8_t* buffer, size_t len) {
+	if (!isCompactHeader(buffer, len, 0x47, HEADER_SIZE)) return false;
+	uint8_t n = buffer[4];
+	if (n > GroupConstants::BITMAP_BYTES || len < HEADER_SIZE + n) return false;
+	size_t pos = 2;
+	cmd_seq = buffer[pos++];
+	group_id = buffer[pos++];
+	member_bytes = buffer[pos++];
+	r = buffer[pos++];
+	g = buffer[pos++];
+	b = buffer[pos++];
+	w = buffer[pos++];
+	value = buffer[pos++];
+	memcpy(&fade_ms, &buffer[pos], 2); pos += 2;
+	memcpy(&ttl_ms, &buffer[pos], 2); pos += 2;
+	pixel = (int8_t)buffer[pos++];
+	override_status = (buffer[pos++] & 0x01) != 0;
+	memcpy(&delay_ms, &buffer[pos], 2); pos += 2;
+	memcpy(&stagger_ms, &buffer[pos], 2); pos += 2;
+	memcpy(&hold_ms, &buffer[pos], 2); pos += 2;
+	memset(members, 0, sizeof(members));
+	memcpy(members, &buffer[pos], member_bytes);
+	ts = millis();
+	return true;
+}
+
+// --- ReservoirTelemetry ---
+ReservoirTelemetryMessage::ReservoirTelemetryMessage() {
+	type = MessageType::RESERVOIR_TELEMETRY;
+	msg = "reservoir_telemetry";
+	RESERVOIR_TELEMETRY_FIELDS(SCHEMA_DEFAULT_F)
+}
+
+SCHEMA_JSON_CODEC(ReservoirTelemetryMessage, RESERVOIR_TELEMETRY_FIELDS)
+
 // ============================================================================
 // V2 PAIRING PROTOCOL MESSAGE IMPLEMENTATIONS
 // ============================================================================
@@ -556,9 +1020,12 @@ String PairingAdvertisementMessage::toJson() const {
 
 bool PairingAdvertisementMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(384);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool PairingAdvertisementMessage::fromJsonObject(JsonObjectConst doc) {
 	protocol_version = doc["protocol_version"] | PairingConstants::PROTOCOL_VERSION;
 	String macStr = doc["node_mac"].as<String>();
 	stringToMac(macStr, node_mac);
@@ -587,6 +1054,10 @@ size_t PairingAdvertisementMessage::toBinary(uint8_t* buffer, size_t maxLen) con
 	return pos;
 }
 
+size_t PairingAdvertisementMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool PairingAdvertisementMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x20) return false;
 	size_t pos = 1;
@@ -646,9 +1117,12 @@ String PairingOfferMessage::toJson() const {
 
 bool PairingOfferMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(384);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool PairingOfferMessage::fromJsonObject(JsonObjectConst doc) {
 	protocol_version = doc["protocol_version"] | PairingConstants::PROTOCOL_VERSION;
 	String macStr = doc["coord_mac"].as<String>();
 	stringToMac(macStr, coord_mac);
@@ -677,6 +1151,10 @@ size_t PairingOfferMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos;
 }
 
+size_t PairingOfferMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool PairingOfferMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x21) return false;
 	size_t pos = 1;
@@ -714,9 +1192,12 @@ String PairingAcceptMessage::toJson() const {
 
 bool PairingAcceptMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(256);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool PairingAcceptMessage::fromJsonObject(JsonObjectConst doc) {
 	String macStr = doc["node_mac"].as<String>();
 	stringToMac(macStr, node_mac);
 	offer_token = doc["offer_token"] | 0;
@@ -735,6 +1216,10 @@ size_t PairingAcceptMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos;
 }
 
+size_t PairingAcceptMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool PairingAcceptMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x22) return false;
 	size_t pos = 1;
@@ -774,9 +1259,12 @@ String PairingConfirmMessage::toJson() const {
 
 bool PairingConfirmMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(512);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool PairingConfirmMessage::fromJsonObject(JsonObjectConst doc) {
 	String macStr = doc["coord_mac"].as<String>();
 	stringToMac(macStr, coord_mac);
 	tower_id = doc["tower_id"] | 0;
@@ -805,6 +1293,10 @@ size_t PairingConfirmMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos;
 }
 
+size_t PairingConfirmMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool PairingConfirmMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x23) return false;
 	size_t pos = 1;
@@ -838,9 +1330,12 @@ String PairingRejectMessage::toJson() const {
 
 bool PairingRejectMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(256);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool PairingRejectMessage::fromJsonObject(JsonObjectConst doc) {
 	String macStr = doc["sender_mac"].as<String>();
 	stringToMac(macStr, sender_mac);
 	reason_code = static_cast<PairingRejectReason>(doc["reason_code"] | 0);
@@ -859,6 +1354,10 @@ size_t PairingRejectMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos;
 }
 
+size_t PairingRejectMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool PairingRejectMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x24) return false;
 	size_t pos = 1;
@@ -891,9 +1390,12 @@ String PairingAbortMessage::toJson() const {
 
 bool PairingAbortMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(256);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool PairingAbortMessage::fromJsonObject(JsonObjectConst doc) {
 	String macStr = doc["sender_mac"].as<String>();
 	stringToMac(macStr, sender_mac);
 	reason_code = static_cast<PairingRejectReason>(doc["reason_code"] | 8);
@@ -912,6 +1414,10 @@ size_t PairingAbortMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos;
 }
 
+size_t PairingAbortMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool PairingAbortMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x25) return false;
 	size_t pos = 1;
@@ -963,9 +1469,12 @@ String OtaBeginMessage::toJson() const {
 
 bool OtaBeginMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(512);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool OtaBeginMessage::fromJsonObject(JsonObjectConst doc) {
 	firmware_size = doc["firmware_size"] | 0;
 	chunk_count = doc["chunk_count"] | 0;
 	chunk_size = doc["chunk_size"] | OtaConstants::MAX_CHUNK_SIZE;
@@ -997,6 +1506,10 @@ size_t OtaBeginMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos; // 45 bytes total
 }
 
+size_t OtaBeginMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool OtaBeginMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x30) return false;
 	size_t pos = 1;
@@ -1039,9 +1552,12 @@ String OtaChunkMessage::toJson() const {
 
 bool OtaChunkMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(1024);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool OtaChunkMessage::fromJsonObject(JsonObjectConst doc) {
 	chunk_index = doc["chunk_index"] | 0;
 	data_len = doc["data_len"] | 0;
 	if (data_len > OtaConstants::MAX_CHUNK_SIZE) data_len = OtaConstants::MAX_CHUNK_SIZE;
@@ -1067,6 +1583,10 @@ size_t OtaChunkMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos;
 }
 
+size_t OtaChunkMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool OtaChunkMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_HEADER_SIZE || buffer[0] != 0x31) return false;
 	size_t pos = 1;
@@ -1100,9 +1620,12 @@ String OtaChunkAckMessage::toJson() const {
 
 bool OtaChunkAckMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(256);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool OtaChunkAckMessage::fromJsonObject(JsonObjectConst doc) {
 	chunk_index = doc["chunk_index"] | 0;
 	status = doc["status"] | 0;
 	next_expected = doc["next_expected"] | 0;
@@ -1120,6 +1643,10 @@ size_t OtaChunkAckMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos; // 5 bytes total
 }
 
+size_t OtaChunkAckMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool OtaChunkAckMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x32) return false;
 	size_t pos = 1;
@@ -1149,9 +1676,12 @@ String OtaAbortMessage::toJson() const {
 
 bool OtaAbortMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(256);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool OtaAbortMessage::fromJsonObject(JsonObjectConst doc) {
 	reason = static_cast<OtaAbortReason>(doc["reason"] | 0);
 	last_chunk = doc["last_chunk"] | 0;
 	ts = doc["ts"] | millis();
@@ -1167,6 +1697,10 @@ size_t OtaAbortMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos; // 4 bytes total
 }
 
+size_t OtaAbortMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool OtaAbortMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x33) return false;
 	size_t pos = 1;
@@ -1195,9 +1729,12 @@ String OtaCompleteMessage::toJson() const {
 
 bool OtaCompleteMessage::fromJson(const String& json) {
 	DynamicJsonDocument doc(256);
-	DeserializationError err = deserializeJson(doc, json);
+	DeserializationError err = parseJson(doc, json);
 	if (err) return false;
-	msg = doc["msg"].as<String>();
+	return fromJsonObject(doc.as<JsonObjectConst>());
+}
+
+bool OtaCompleteMessage::fromJsonObject(JsonObjectConst doc) {
 	status = doc["status"] | 0;
 	will_reboot = doc["will_reboot"] | 1;
 	ts = doc["ts"] | millis();
@@ -1213,6 +1750,10 @@ size_t OtaCompleteMessage::toBinary(uint8_t* buffer, size_t maxLen) const {
 	return pos; // 3 bytes total
 }
 
+size_t OtaCompleteMessage::encode(uint8_t* out, size_t cap) const {
+	return toBinary(out, cap);
+}
+
 bool OtaCompleteMessage::fromBinary(const uint8_t* buffer, size_t len) {
 	if (len < BINARY_SIZE || buffer[0] != 0x34) return false;
 	size_t pos = 1;
@@ -1228,38 +1769,28 @@ bool OtaCompleteMessage::fromBinary(const uint8_t* buffer, size_t len) {
 
 // --- Factory ---
 EspNowMessage* MessageFactory::createMessage(const String& json) {
-	MessageType t = getMessageType(json);
-	EspNowMessage* m = nullptr;
-	switch (t) {
-		case MessageType::JOIN_REQUEST: m = new JoinRequestMessage(); break;
-		case MessageType::JOIN_ACCEPT:  m = new JoinAcceptMessage(); break;
-		case MessageType::SET_LIGHT:    m = new SetLightMessage(); break;
-		case MessageType::NODE_STATUS:  m = new NodeStatusMessage(); break;
-		case MessageType::ERROR:        m = new ErrorMessage(); break;
-		case MessageType::ACK:          m = new AckMessage(); break;
-		// Hydroponic system messages
-		case MessageType::TOWER_JOIN_REQUEST:  m = new TowerJoinRequestMessage(); break;
-		case MessageType::TOWER_JOIN_ACCEPT:   m = new TowerJoinAcceptMessage(); break;
-		case MessageType::TOWER_TELEMETRY:     m = new TowerTelemetryMessage(); break;
-		case MessageType::TOWER_COMMAND:       m = new TowerCommandMessage(); break;
-		case MessageType::RESERVOIR_TELEMETRY: m = new ReservoirTelemetryMessage(); break;
-		// V2 Pairing messages
-		case MessageType::PAIRING_ADVERTISEMENT: m = new PairingAdvertisementMessage(); break;
-		case MessageType::PAIRING_OFFER:         m = new PairingOfferMessage(); break;
-		case MessageType::PAIRING_ACCEPT:        m = new PairingAcceptMessage(); break;
-		case MessageType::PAIRING_CONFIRM:       m = new PairingConfirmMessage(); break;
-		case MessageType::PAIRING_REJECT:        m = new PairingRejectMessage(); break;
-		case MessageType::PAIRING_ABORT:         m = new PairingAbortMessage(); break;
-		// OTA messages
-		case MessageType::OTA_BEGIN:       m = new OtaBeginMessage(); break;
-		case MessageType::OTA_CHUNK:       m = new OtaChunkMessage(); break;
-		case MessageType::OTA_CHUNK_ACK:   m = new OtaChunkAckMessage(); break;
-		case MessageType::OTA_ABORT:       m = new OtaAbortMessage(); break;
-		case MessageType::OTA_COMPLETE:    m = new OtaCompleteMessage(); break;
-		default: return nullptr;
+	DynamicJsonDocument doc(JSON_DECODE_CAPACITY);
+	return decodeJson(doc, json.c_str(), json.length(), HeapMaker());
+}
+
+EspNowMessage* MessageFactory::decode(const uint8_t* data, size_t len) {
+	if (data == nullptr || len == 0) return nullptr;
+	if (data[0] == '{') {
+		DynamicJsonDocument doc(JSON_DECODE_CAPACITY);
+		return decodeJson(doc, (const char*)data, len, HeapMaker());
 	}
-	if (m && !m->fromJson(json)) { delete m; return nullptr; }
-	return m;
+	return decodeBinary(data, len, HeapMaker());
+}
+
+EspNowMessage* MessageFactory::decode(const uint8_t* data, size_t len, MessageSlot& slot) {
+	slot.reset();
+	if (data == nullptr || len == 0) return nullptr;
+	if (data[0] == '{') return decodeJson(slot.document(), (const char*)data, len, SlotMaker(slot));
+	return decodeBinary(data, len, SlotMaker(slot));
+}
+
+uint32_t MessageFactory::jsonParseCount() {
+	return jsonParses;
 }
 
 MessageType MessageFactory::getMessageType(const String& json) {
@@ -1268,38 +1799,83 @@ MessageType MessageFactory::getMessageType(const String& json) {
 	filter["msg"] = true;
 	
 	DynamicJsonDocument doc(256);
-	DeserializationError err = deserializeJson(doc, json, DeserializationOption::Filter(filter));
+	DeserializationError err = parseJson(doc, json, DeserializationOption::Filter(filter));
 	if (err) {
 		Serial.printf("MessageFactory: Failed to parse message type: %s\n", err.c_str());
 		return MessageType::ERROR;
 	}
 	
-	String m = doc["msg"].as<String>();
-	if (m == "join_request") return MessageType::JOIN_REQUEST;
-	if (m == "join_accept") return MessageType::JOIN_ACCEPT;
-	if (m == "set_light") return MessageType::SET_LIGHT;
-	if (m == "node_status") return MessageType::NODE_STATUS;
-	if (m == "ack") return MessageType::ACK;
-	// Hydroponic system messages
-	if (m == "tower_join_request") return MessageType::TOWER_JOIN_REQUEST;
-	if (m == "tower_join_accept") return MessageType::TOWER_JOIN_ACCEPT;
-	if (m == "tower_telemetry") return MessageType::TOWER_TELEMETRY;
-	if (m == "tower_command") return MessageType::TOWER_COMMAND;
-	if (m == "reservoir_telemetry") return MessageType::RESERVOIR_TELEMETRY;
-	// V2 Pairing messages
-	if (m == "pairing_advertisement") return MessageType::PAIRING_ADVERTISEMENT;
-	if (m == "pairing_offer") return MessageType::PAIRING_OFFER;
-	if (m == "pairing_accept") return MessageType::PAIRING_ACCEPT;
-	if (m == "pairing_confirm") return MessageType::PAIRING_CONFIRM;
-	if (m == "pairing_reject") return MessageType::PAIRING_REJECT;
-	if (m == "pairing_abort") return MessageType::PAIRING_ABORT;
-	// OTA messages
-	if (m == "ota_begin") return MessageType::OTA_BEGIN;
-	if (m == "ota_chunk") return MessageType::OTA_CHUNK;
-	if (m == "ota_chunk_ack") return MessageType::OTA_CHUNK_ACK;
-	if (m == "ota_abort") return MessageType::OTA_ABORT;
-	if (m == "ota_complete") return MessageType::OTA_COMPLETE;
-	return MessageType::ERROR;
+	return typeFromName(doc["msg"] | "");
+}
+
+MessageType MessageFactory::typeFromName(const char* name) {
+	MessageType t;
+	if (name == nullptr || !lookupType(name, strlen(name), t)) return MessageType::ERROR;
+	return t;
+}
+
+bool MessageFactory::lookupType(const char* name, size_t len, MessageType& out) {
+	if (name == nullptr) return false;
+	// Case labels are hashed at compile time, so two names colliding would not build.
+	// A hash hit is confirmed with one compare against the expected name.
+#define MSG_TYPE_CASE(str, value) \
+	case nameHash(str): \
+		if (len != sizeof(str) - 1 || memcmp(name, str, len) != 0) return false; \
+		out = MessageType::value; \
+		return true
+	switch (hashName(name, len)) {
+		MSG_TYPE_CASE("join_request", JOIN_REQUEST);
+		MSG_TYPE_CASE("join_accept", JOIN_ACCEPT);
+		MSG_TYPE_CASE("set_light", SET_LIGHT);
+		MSG_TYPE_CASE("node_status", NODE_STATUS);
+		MSG_TYPE_CASE("error", ERROR);
+		MSG_TYPE_CASE("ack", ACK);
+		// Hydroponic system messages
+		MSG_TYPE_CASE("tower_join_request", TOWER_JOIN_REQUEST);
+		MSG_TYPE_CASE("tower_join_accept", TOWER_JOIN_ACCEPT);
+		MSG_TYPE_CASE("tower_telemetry", TOWER_TELEMETRY);
+		MSG_TYPE_CASE("tower_command", TOWER_COMMAND);
+		MSG_TYPE_CASE("reservoir_telemetry", RESERVOIR_TELEMETRY);
+		MSG_TYPE_CASE("tower_telemetry_delta", TOWER_TELEMETRY_DELTA);
+		MSG_TYPE_CASE("tower_telemetry_sync", TOWER_TELEMETRY_SYNC);
+		MSG_TYPE_CASE("tower_telemetry_batch", TOWER_TELEMETRY_BATCH);
+		// V2 Pairing messages
+		MSG_TYPE_CASE("pairing_advertisement", PAIRING_ADVERTISEMENT);
+		MSG_TYPE_CASE("pairing_offer", PAIRING_OFFER);
+		MSG_TYPE_CASE("pairing_accept", PAIRING_ACCEPT);
+		MSG_TYPE_CASE("pairing_confirm", PAIRING_CONFIRM);
+		MSG_TYPE_CASE("pairing_reject", PAIRING_REJECT);
+		MSG_TYPE_CASE("pairing_abort", PAIRING_ABORT);
+		// OTA messages
+		MSG_TYPE_CASE("ota_begin", OTA_BEGIN);
+		MSG_TYPE_CASE("ota_chunk", OTA_CHUNK);
+		MSG_TYPE_CASE("ota_chunk_ack", OTA_CHUNK_ACK);
+		MSG_TYPE_CASE("ota_abort", OTA_ABORT);
+		MSG_TYPE_CASE("ota_complete", OTA_COMPLETE);
+		MSG_TYPE_CASE("group_command", GROUP_COMMAND);
+		default: return false;
+	}
+#undef MSG_TYPE_CASE
+}
+
+bool MessageFactory::peekMessageType(const uint8_t* data, size_t len, MessageType& out) {
+	if (data == nullptr || len == 0) return false;
+	if (data[0] != '{') {
+		out = getMessageTypeFromBinary(data, len);
+		return out != MessageType::ERROR;
+	}
+	// Our encoders emit "msg":"<name>" verbatim; find it and look the name up in place
+	static const char KEY[] = "\"msg\"";
+	const uint8_t* end = data + len;
+	const uint8_t* p = std::search(data, end, KEY, KEY + sizeof(KEY) - 1);
+	if (p == end) return false;
+	p += sizeof(KEY) - 1;
+	while (p < end && (*p == ' ' || *p == ':')) p++;
+	if (p == end || *p != '"') return false;
+	const uint8_t* name = ++p;
+	while (p < end && *p != '"') p++;
+	if (p == end) return false;
+	return lookupType((const char*)name, p - name, out);
 }
 
 // --- Binary Factory Methods ---
@@ -1322,6 +1898,16 @@ MessageType MessageFactory::getMessageTypeFromBinary(const uint8_t* buffer, size
 		case 0x32: return MessageType::OTA_CHUNK_ACK;
 		case 0x33: return MessageType::OTA_ABORT;
 		case 0x34: return MessageType::OTA_COMPLETE;
+		// Compact hot-path message type markers (0x40-0x48)
+		case 0x40: return MessageType::SET_LIGHT;
+		case 0x41: return MessageType::NODE_STATUS;
+		case 0x42: return MessageType::TOWER_TELEMETRY;
+		case 0x43: return MessageType::TOWER_COMMAND;
+		case 0x44: return MessageType::TOWER_TELEMETRY_DELTA;
+		case 0x45: return MessageType::TOWER_TELEMETRY_SYNC;
+		case 0x46: return MessageType::TOWER_TELEMETRY_BATCH;
+		case 0x47: return MessageType::GROUP_COMMAND;
+		case 0x48: return MessageType::ACK;
 		default:
 			Serial.printf("MessageFactory: Unknown binary message type marker: 0x%02X\n", typeMarker);
 			return MessageType::ERROR;
@@ -1330,79 +1916,9 @@ MessageType MessageFactory::getMessageTypeFromBinary(const uint8_t* buffer, size
 
 EspNowMessage* MessageFactory::createFromBinary(const uint8_t* buffer, size_t len) {
 	if (buffer == nullptr || len < 1) return nullptr;
-	
-	MessageType t = getMessageTypeFromBinary(buffer, len);
-	EspNowMessage* m = nullptr;
-	
-	switch (t) {
-		// V2 Pairing messages (binary format)
-		case MessageType::PAIRING_ADVERTISEMENT: m = new PairingAdvertisementMessage(); break;
-		case MessageType::PAIRING_OFFER:         m = new PairingOfferMessage(); break;
-		case MessageType::PAIRING_ACCEPT:        m = new PairingAcceptMessage(); break;
-		case MessageType::PAIRING_CONFIRM:       m = new PairingConfirmMessage(); break;
-		case MessageType::PAIRING_REJECT:        m = new PairingRejectMessage(); break;
-		case MessageType::PAIRING_ABORT:         m = new PairingAbortMessage(); break;
-		// OTA messages (binary format)
-		case MessageType::OTA_BEGIN:             m = new OtaBeginMessage(); break;
-		case MessageType::OTA_CHUNK:             m = new OtaChunkMessage(); break;
-		case MessageType::OTA_CHUNK_ACK:         m = new OtaChunkAckMessage(); break;
-		case MessageType::OTA_ABORT:             m = new OtaAbortMessage(); break;
-		case MessageType::OTA_COMPLETE:          m = new OtaCompleteMessage(); break;
-		default:
-			Serial.printf("MessageFactory: Cannot create message from binary, type: %d\n", static_cast<int>(t));
-			return nullptr;
-	}
-	
-	if (m) {
-		// Call the appropriate fromBinary method based on message type
-		bool success = false;
-		switch (t) {
-			case MessageType::PAIRING_ADVERTISEMENT:
-				success = static_cast<PairingAdvertisementMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::PAIRING_OFFER:
-				success = static_cast<PairingOfferMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::PAIRING_ACCEPT:
-				success = static_cast<PairingAcceptMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::PAIRING_CONFIRM:
-				success = static_cast<PairingConfirmMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::PAIRING_REJECT:
-				success = static_cast<PairingRejectMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::PAIRING_ABORT:
-				success = static_cast<PairingAbortMessage*>(m)->fromBinary(buffer, len);
-				break;
-			// OTA messages
-			case MessageType::OTA_BEGIN:
-				success = static_cast<OtaBeginMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::OTA_CHUNK:
-				success = static_cast<OtaChunkMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::OTA_CHUNK_ACK:
-				success = static_cast<OtaChunkAckMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::OTA_ABORT:
-				success = static_cast<OtaAbortMessage*>(m)->fromBinary(buffer, len);
-				break;
-			case MessageType::OTA_COMPLETE:
-				success = static_cast<OtaCompleteMessage*>(m)->fromBinary(buffer, len);
-				break;
-			default:
-				break;
-		}
-		
-		if (!success) {
-			Serial.printf("MessageFactory: Failed to parse binary message of type %d\n", static_cast<int>(t));
-			delete m;
-			return nullptr;
-		}
-	}
-	
-	return m;
+	return decodeBinary(buffer, len, HeapMaker());
 }
 
-
+bool MessageFactory::isCompactBinary(const uint8_t* buffer, size_t len) {
+	return buffer != nullptr && len >= 2 && buffer[0] >= 0x40 && buffer[0] <= 0x48;
+}
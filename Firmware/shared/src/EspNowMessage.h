@@ -3,6 +3,10 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <new>
+#include <type_traits>
+#include "utils/FixedString.h"
+#include "MessageSchema.h"
 
 // Message types signaled via the 'msg' string field in JSON
 enum class MessageType {
@@ -18,6 +22,9 @@ enum class MessageType {
 	TOWER_TELEMETRY,       // Tower -> Coordinator: air temp, humidity, light
 	TOWER_COMMAND,         // Coordinator -> Tower: pump/light control
 	RESERVOIR_TELEMETRY,   // Coordinator internal: pH, EC, water temp, level
+	TOWER_TELEMETRY_DELTA, // Tower -> Coordinator: changed fields since the acked keyframe
+	TOWER_TELEMETRY_SYNC,  // Coordinator -> Tower: keyframe ack / keyframe request
+	TOWER_TELEMETRY_BATCH, // Tower -> Coordinator: several timestamped samples in one frame
 	
 	// V2 Pairing Protocol (Zigbee-like permit-join model)
 	PAIRING_ADVERTISEMENT, // Node -> Broadcast: announces availability for pairing
@@ -33,7 +40,10 @@ enum class MessageType {
 	OTA_CHUNK,             // Coordinator -> Tower: One chunk of firmware data (~200 bytes)
 	OTA_CHUNK_ACK,         // Tower -> Coordinator: Acknowledge chunk received
 	OTA_ABORT,             // Either direction: Cancel OTA transfer
-	OTA_COMPLETE           // Tower -> Coordinator: OTA finished successfully
+	OTA_COMPLETE,          // Tower -> Coordinator: OTA finished successfully
+
+	// Appended so the values above, which travel in FrameHeader, keep their numbers
+	GROUP_COMMAND          // Coordinator -> Broadcast: light command for a set of member towers
 };
 
 // Device types for pairing
@@ -75,22 +85,106 @@ enum class PairingRejectReason : uint8_t {
 	ALREADY_PAIRED = 10
 };
 
+// Compact binary wire format for the high-rate messages (set_light, node_status,
+// tower_telemetry, tower_command, tower_telemetry_delta/sync/batch,
+// group_command, ack). Binary message type markers: 0x40-0x48.
+// JSON stays accepted from older firmware; receivers tell the formats apart by
+// the first byte ('{' vs marker). Byte 1 of every compact frame is FORMAT_VERSION.
+namespace WireConstants {
+	constexpr uint8_t FORMAT_VERSION = 0x01;         // Bump on any layout change
+	constexpr size_t ID_FIELD_LEN = 18;              // NUL-padded, fits "AA:BB:CC:DD:EE:FF"
+	constexpr size_t FW_FIELD_LEN = 16;              // NUL-padded firmware version string
+	constexpr size_t MAX_FRAME_LEN = 250;            // ESP-NOW payload limit
+	constexpr size_t FRAME_HEADER_LEN = 8;           // FrameHeader in front of every payload
+	constexpr size_t MAX_PAYLOAD_LEN = MAX_FRAME_LEN - FRAME_HEADER_LEN;  // what one message may encode to
+	// Coordinator liveness ping: PING_MARKER, FORMAT_VERSION. Not a message;
+	// the marker sits outside the message range so nothing tries to decode it.
+	constexpr uint8_t PING_MARKER = 0x50;
+	constexpr size_t PING_LEN = 2;
+}
+
+// Group addressing. The coordinator gives every tower a member index in
+// join_accept; a group command names its members as a bitmap of those indexes.
+namespace GroupConstants {
+	constexpr uint8_t GROUP_ALL = 0;        // group_id of fleet-wide commands
+	constexpr uint8_t NO_MEMBER = 0xFF;     // member index of a node that has none yet
+	constexpr size_t MAX_MEMBERS = 255;     // member indexes 0..254
+	constexpr size_t BITMAP_BYTES = 32;
+}
+
+// Inline string fields, sized for what the protocol actually carries.
+// Longer input is truncated when a message is filled.
+typedef FixedString<WireConstants::ID_FIELD_LEN> IdString;   // MAC-derived node/tower/light IDs
+typedef FixedString<WireConstants::FW_FIELD_LEN> FwString;   // firmware version
+typedef FixedString<24> CmdIdString;                         // command/ack ids ("tower_telemetry_ack")
+typedef FixedString<36> SiteIdString;                        // coord_id / farm_id, up to a UUID
+
+// status_mode values. The number is the compact wire code; JSON carries the name.
+enum class StatusMode : uint8_t {
+	UNSET = 0,
+	OPERATIONAL = 1,
+	PAIRING = 2,
+	OTA = 3,
+	ERROR = 4,
+	IDLE = 5,
+	OVERRIDE = 6,
+	MAINTENANCE = 7
+};
+
+// JSON edge mapping: "" for UNSET; unknown or missing names map to UNSET
+const char* statusModeName(StatusMode mode);
+StatusMode statusModeFromName(const char* name);
+StatusMode statusModeFromCode(uint8_t code);
+
+namespace schema {
+// StatusMode: its name in JSON, its code on the wire. Missing or unknown
+// values decode as UNSET whatever the field's default.
+struct Mode {
+	static constexpr size_t WIRE = 1;
+	template <typename D>
+	static void toJson(JsonObject o, const char* k, StatusMode x, const D&) { o[k] = statusModeName(x); }
+	template <typename D>
+	static void fromJson(JsonObjectConst o, const char* k, StatusMode& x, const D&) { x = statusModeFromName(o[k] | ""); }
+	static bool put(uint8_t* p, StatusMode x) { p[0] = static_cast<uint8_t>(x); return true; }
+	template <typename D>
+	static void get(const uint8_t* p, StatusMode& x, const D&) { x = statusModeFromCode(p[0]); }
+};
+} // namespace schema
+
 // Base message with common helpers
 struct EspNowMessage {
 	MessageType type;
-	String msg;         // e.g. "join_request", "set_light"
-	String cmd_id;      // for idempotency/acks (where applicable)
+	const char* msg;    // e.g. "join_request", "set_light" (set by each constructor)
+	CmdIdString cmd_id; // for idempotency/acks (where applicable)
 	uint32_t ts;        // timestamp (ms)
 
 	virtual ~EspNowMessage() = default;
 	virtual String toJson() const = 0;
+	// Serialize into a caller-provided frame without allocating: JSON for the
+	// JSON protocol messages, the binary layout for pairing/OTA. Returns bytes
+	// written, or 0 if the message does not fit in cap.
+	virtual size_t encode(uint8_t* out, size_t cap) const = 0;
 	virtual bool fromJson(const String& json) = 0;
+	// Fill fields from an already-parsed document (see MessageFactory::decode)
+	virtual bool fromJsonObject(JsonObjectConst doc) = 0;
+	// Binary frame decoding, for the types that have one
+	virtual bool fromBinary(const uint8_t*, size_t) { return false; }
 };
 
 // Join request message with capability reporting (PRD v0.5)
+#define JOIN_REQUEST_FIELDS(F) \
+	F(nullptr, mac,             "mac",        schema::Text,              "") \
+	F(nullptr, fw,              "fw",         schema::Text,              "") \
+	F("caps",  caps.rgbw,       "rgbw",       schema::JsonNum<bool>,     false) \
+	F("caps",  caps.led_count,  "led_count",  schema::JsonNum<uint8_t>,  0) \
+	F("caps",  caps.temp_i2c,   "temp_i2c",   schema::JsonNum<bool>,     false) \
+	F("caps",  caps.deep_sleep, "deep_sleep", schema::JsonNum<bool>,     false) \
+	F("caps",  caps.button,     "button",     schema::JsonNum<bool>,     false) \
+	F(nullptr, token,           "token",      schema::Text,              "")
+
 struct JoinRequestMessage : public EspNowMessage {
-	String mac;            // station MAC
-	String fw;             // firmware version
+	IdString mac;          // station MAC
+	FwString fw;           // firmware version
 	struct Capabilities {
 		bool rgbw;         // SK6812B RGBW support
 		uint8_t led_count; // pixels per node (default 4)
@@ -98,19 +192,36 @@ struct JoinRequestMessage : public EspNowMessage {
 		bool deep_sleep;   // deep sleep capable
 		bool button;       // button input available
 	} caps;
-	String token;          // rotating token for secure pairing
+	FixedString<16> token; // rotating token for secure pairing
 
 	JoinRequestMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(JOIN_REQUEST_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 };
 
 // Join accept (coordinator -> node)
+#define JOIN_ACCEPT_FIELDS(F) \
+	F(nullptr, node_id,          "node_id",      schema::Text,                          "") \
+	F(nullptr, light_id,         "light_id",     schema::Text,                          "") \
+	F(nullptr, lmk,              "lmk",          schema::Text,                          "") \
+	F(nullptr, wifi_channel,     "wifi_channel", schema::JsonNum<uint8_t>,              1) \
+	F(nullptr, wire_format,      "wire",         schema::Opt<schema::JsonNum<uint8_t>>, 0) \
+	F(nullptr, member_index,     "member",       schema::Opt<schema::JsonNum<uint8_t>>, GroupConstants::NO_MEMBER) \
+	F("cfg",   cfg.pwm_freq,     "pwm_freq",     schema::JsonNum<int>,                  0) \
+	F("cfg",   cfg.rx_window_ms, "rx_window_ms", schema::JsonNum<int>,                  20) \
+	F("cfg",   cfg.rx_period_ms, "rx_period_ms", schema::JsonNum<int>,                  100)
+
 struct JoinAcceptMessage : public EspNowMessage {
-	String node_id;
-	String light_id;
-	String lmk;           // link master key (ESP-NOW LMK)
+	IdString node_id;
+	IdString light_id;
+	FixedString<32> lmk;  // link master key (ESP-NOW LMK, hex)
 	uint8_t wifi_channel; // WiFi channel coordinator is using
+	uint8_t wire_format;  // compact binary format version accepted (0 = JSON only)
+	uint8_t member_index; // bit this node answers to in group commands (NO_MEMBER = none)
 	struct Cfg {
 		int pwm_freq;
 		int rx_window_ms;
@@ -119,59 +230,138 @@ struct JoinAcceptMessage : public EspNowMessage {
 
 	JoinAcceptMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(JOIN_ACCEPT_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 };
 
 // set_light (PRD v0.5)
+#define SET_LIGHT_FIELDS(F) \
+	F(nullptr, cmd_id,          "cmd_id",          schema::Str<WireConstants::ID_FIELD_LEN>, "") \
+	F(nullptr, light_id,        "light_id",        schema::Str<WireConstants::ID_FIELD_LEN>, "") \
+	F(nullptr, r,               "r",               schema::Num<uint8_t>,                     0) \
+	F(nullptr, g,               "g",               schema::Num<uint8_t>,                     0) \
+	F(nullptr, b,               "b",               schema::Num<uint8_t>,                     0) \
+	F(nullptr, w,               "w",               schema::Num<uint8_t>,                     0) \
+	F(nullptr, value,           "value",           schema::Num<uint8_t>,                     0) \
+	F(nullptr, fade_ms,         "fade_ms",         schema::Num<uint16_t>,                    0) \
+	F(nullptr, ttl_ms,          "ttl_ms",          schema::Num<uint16_t>,                    1500) \
+	F(nullptr, pixel,           "pixel",           schema::Num<int8_t>,                      -1) \
+	F(nullptr, override_status, "override_status", schema::Flag,                             false) \
+	F(nullptr, reason,          "reason",          schema::Opt<schema::Text>,                "")
+
 struct SetLightMessage : public EspNowMessage {
-	String light_id;
+	IdString light_id;
 	// RGBW values (0..255). If omitted, 'value' may be used as brightness fallback.
-	uint8_t r = 0, g = 0, b = 0, w = 0;
-	uint8_t value = 0; // optional fallback (PWM-like)
-	uint16_t fade_ms = 0;
-	bool override_status = false;
-	uint16_t ttl_ms = 1500;
+	uint8_t r, g, b, w;
+	uint8_t value; // optional fallback (PWM-like)
+	uint16_t fade_ms;
+	bool override_status;
+	uint16_t ttl_ms;
 	String reason;
-	int8_t pixel = -1; // -1 = all pixels, 0-3 = specific pixel index
+	int8_t pixel; // -1 = all pixels, 0-3 = specific pixel index
 
 	SetLightMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(SET_LIGHT_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	// Compact binary (0x40, 49 bytes). 'reason' is JSON-only.
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t BINARY_SIZE = SCHEMA_WIRE_SIZE(SET_LIGHT_FIELDS);
 };
 
 // node_status (PRD v0.5)
+#define NODE_STATUS_FIELDS(F) \
+	F(nullptr, node_id,        "node_id",        schema::Str<WireConstants::ID_FIELD_LEN>, "") \
+	F(nullptr, light_id,       "light_id",       schema::Str<WireConstants::ID_FIELD_LEN>, "") \
+	F(nullptr, avg_r,          "avg_r",          schema::Num<uint8_t>,                     0) \
+	F(nullptr, avg_g,          "avg_g",          schema::Num<uint8_t>,                     0) \
+	F(nullptr, avg_b,          "avg_b",          schema::Num<uint8_t>,                     0) \
+	F(nullptr, avg_w,          "avg_w",          schema::Num<uint8_t>,                     0) \
+	F(nullptr, status_mode,    "status_mode",    schema::Mode,                             StatusMode::UNSET) \
+	F(nullptr, vbat_mv,        "vbat_mv",        schema::Num<uint16_t>,                    0) \
+	F(nullptr, temperature,    "temperature",    schema::Centi,                            0.0f) \
+	F(nullptr, button_pressed, "button_pressed", schema::Flag,                             false) \
+	F(nullptr, fw,             "fw",             schema::Str<WireConstants::FW_FIELD_LEN>, "") \
+	F(nullptr, ts,             "ts",             schema::JsonNum<uint32_t>,                millis())
+
 struct NodeStatusMessage : public EspNowMessage {
-	String node_id;
-	String light_id;
+	IdString node_id;
+	IdString light_id;
 	// average output per channel (0..255)
-	uint8_t avg_r = 0, avg_g = 0, avg_b = 0, avg_w = 0;
-	String status_mode;   // "operational", "pairing", "ota", "error"
-	uint16_t vbat_mv = 0;
-	float temperature = 0.0f; // temperature in Celsius from TMP177
-	bool button_pressed = false; // current button state
-	String fw;
+	uint8_t avg_r, avg_g, avg_b, avg_w;
+	StatusMode status_mode; // operational, pairing, ota, error
+	uint16_t vbat_mv;
+	float temperature; // temperature in Celsius from TMP177
+	bool button_pressed; // current button state
+	FwString fw;
 
 	NodeStatusMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(NODE_STATUS_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	// Compact binary (0x41, 64 bytes). Temperature travels as 0.01 C steps.
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t BINARY_SIZE = SCHEMA_WIRE_SIZE(NODE_STATUS_FIELDS);
 };
 
 // Error message (minimal)
+#define ERROR_FIELDS(F) \
+	F(nullptr, node_id, "node_id", schema::Text, "") \
+	F(nullptr, code,    "code",    schema::Text, "") \
+	F(nullptr, info,    "info",    schema::Text, "")
+
 struct ErrorMessage : public EspNowMessage {
-	String node_id;
+	IdString node_id;
 	String code;
 	String info;
 
 	ErrorMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(ERROR_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 };
 
 // Ack for a command id
+// A cumulative ack covers every frame up to ack_seq (the FrameHeader sequence
+// number of the newest one); ack_count says how many that was. Both stay out
+// of the JSON while zero, as older coordinators sent it.
+#define ACK_FIELDS(F) \
+	F(nullptr, cmd_id,    "cmd_id",  schema::Text,                       "") \
+	F(nullptr, ack_seq,   "ack_seq", schema::Opt<schema::Num<uint16_t>>, 0) \
+	F(nullptr, ack_count, "acked",   schema::Opt<schema::Num<uint8_t>>,  0)
+
 struct AckMessage : public EspNowMessage {
+	uint16_t ack_seq;
+	uint8_t ack_count;
+
 	AckMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(ACK_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	// Compact binary (0x48, 5 bytes). cmd_id is JSON-only.
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t BINARY_SIZE = SCHEMA_WIRE_SIZE(ACK_FIELDS);
 };
 
 // ============================================================================
@@ -179,9 +369,20 @@ struct AckMessage : public EspNowMessage {
 // ============================================================================
 
 // Tower join request (tower node -> coordinator)
+#define TOWER_JOIN_REQUEST_FIELDS(F) \
+	F(nullptr, mac,               "mac",          schema::Text,                 "") \
+	F(nullptr, fw,                "fw",           schema::Text,                 "") \
+	F("caps",  caps.dht_sensor,   "dht_sensor",   schema::JsonNum<bool>,        false) \
+	F("caps",  caps.light_sensor, "light_sensor", schema::JsonNum<bool>,        false) \
+	F("caps",  caps.pump_relay,   "pump_relay",   schema::JsonNum<bool>,        false) \
+	F("caps",  caps.grow_light,   "grow_light",   schema::JsonNum<bool>,        false) \
+	F("caps",  caps.slot_count,   "slot_count",   schema::JsonNum<uint8_t>,     6) \
+	F(nullptr, token,             "token",        schema::Text,                 "") \
+	F(nullptr, ts,                "ts",           schema::JsonNum<uint32_t>,    millis())
+
 struct TowerJoinRequestMessage : public EspNowMessage {
-	String mac;            // station MAC address
-	String fw;             // firmware version
+	IdString mac;          // station MAC address
+	FwString fw;           // firmware version
 	struct TowerCapabilities {
 		bool dht_sensor;       // DHT22 temp/humidity sensor
 		bool light_sensor;     // ambient light sensor
@@ -189,20 +390,36 @@ struct TowerJoinRequestMessage : public EspNowMessage {
 		bool grow_light;       // grow light output (PWM or on/off)
 		uint8_t slot_count;    // number of plant slots (default 6)
 	} caps;
-	String token;          // rotating token for secure pairing
+	FixedString<16> token; // rotating token for secure pairing
 
 	TowerJoinRequestMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(TOWER_JOIN_REQUEST_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 };
 
 // Tower join accept (coordinator -> tower)
+#define TOWER_JOIN_ACCEPT_FIELDS(F) \
+	F(nullptr, tower_id,                  "tower_id",              schema::Text,                          "") \
+	F(nullptr, coord_id,                  "coord_id",              schema::Text,                          "") \
+	F(nullptr, farm_id,                   "farm_id",               schema::Text,                          "") \
+	F(nullptr, lmk,                       "lmk",                   schema::Text,                          "") \
+	F(nullptr, wifi_channel,              "wifi_channel",          schema::JsonNum<uint8_t>,              1) \
+	F(nullptr, wire_format,               "wire",                  schema::Opt<schema::JsonNum<uint8_t>>, 0) \
+	F("cfg",   cfg.telemetry_interval_ms, "telemetry_interval_ms", schema::JsonNum<uint16_t>,             30000) \
+	F("cfg",   cfg.pump_max_duration_s,   "pump_max_duration_s",   schema::JsonNum<uint16_t>,             300) \
+	F(nullptr, ts,                        "ts",                    schema::JsonNum<uint32_t>,             millis())
+
 struct TowerJoinAcceptMessage : public EspNowMessage {
-	String tower_id;       // assigned tower ID
-	String coord_id;       // coordinator ID
-	String farm_id;        // farm ID for MQTT topic hierarchy
-	String lmk;            // link master key (ESP-NOW LMK)
+	IdString tower_id;     // assigned tower ID
+	SiteIdString coord_id; // coordinator ID
+	SiteIdString farm_id;  // farm ID for MQTT topic hierarchy
+	FixedString<32> lmk;   // link master key (ESP-NOW LMK, hex)
 	uint8_t wifi_channel;  // WiFi channel coordinator is using
+	uint8_t wire_format;   // compact binary format version accepted (0 = JSON only)
 	struct TowerCfg {
 		uint16_t telemetry_interval_ms;  // how often to send telemetry (default 30000)
 		uint16_t pump_max_duration_s;    // max pump on time for safety (default 300)
@@ -210,12 +427,30 @@ struct TowerJoinAcceptMessage : public EspNowMessage {
 
 	TowerJoinAcceptMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(TOWER_JOIN_ACCEPT_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 };
 
 // Tower telemetry (tower node -> coordinator, periodic)
+#define TOWER_TELEMETRY_FIELDS(F) \
+	F(nullptr, tower_id,         "tower_id",         schema::Str<WireConstants::ID_FIELD_LEN>, "") \
+	F(nullptr, air_temp_c,       "air_temp_c",       schema::Centi,                            0.0f) \
+	F(nullptr, humidity_pct,     "humidity_pct",     schema::CentiUnsigned,                    0.0f) \
+	F(nullptr, light_lux,        "light_lux",        schema::Num<float>,                       0.0f) \
+	F(nullptr, pump_on,          "pump_on",          schema::BitOpen<0x01>,                    false) \
+	F(nullptr, light_on,         "light_on",         schema::BitClose<0x02>,                   false) \
+	F(nullptr, light_brightness, "light_brightness", schema::Num<uint8_t>,                     0) \
+	F(nullptr, status_mode,      "status_mode",      schema::Mode,                             StatusMode::OPERATIONAL) \
+	F(nullptr, vbat_mv,          "vbat_mv",          schema::Num<uint16_t>,                    0) \
+	F(nullptr, fw,               "fw",               schema::Str<WireConstants::FW_FIELD_LEN>, "") \
+	F(nullptr, uptime_s,         "uptime_s",         schema::Num<uint32_t>,                    0) \
+	F(nullptr, ts,               "ts",               schema::JsonNum<uint32_t>,                millis())
+
 struct TowerTelemetryMessage : public EspNowMessage {
-	String tower_id;       // tower identifier
+	IdString tower_id;     // tower identifier
 	
 	// Environmental sensors
 	float air_temp_c;      // air temperature in Celsius (DHT22)
@@ -228,22 +463,202 @@ struct TowerTelemetryMessage : public EspNowMessage {
 	uint8_t light_brightness; // grow light brightness (0-255, if PWM supported)
 	
 	// System status
-	String status_mode;    // "operational", "pairing", "ota", "error", "idle"
+	StatusMode status_mode; // operational, pairing, ota, error, idle
 	uint16_t vbat_mv;      // battery/supply voltage in millivolts
-	String fw;             // firmware version
+	FwString fw;           // firmware version
 	uint32_t uptime_s;     // uptime in seconds
 
 	TowerTelemetryMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(TOWER_TELEMETRY_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	// Compact binary (0x42, 53 bytes). Temperature/humidity travel as 0.01 steps.
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t BINARY_SIZE = SCHEMA_WIRE_SIZE(TOWER_TELEMETRY_FIELDS);
+};
+
+// Delta tower telemetry (tower node -> coordinator, compact binary 0x44 only).
+// A keyframe carries tower_id and every field and becomes the baseline once the
+// coordinator acknowledges it. Other frames carry a presence bitmap and only the
+// fields that differ from that baseline, in bit order. The coordinator rebuilds
+// the full TowerTelemetryMessage before publishing.
+//
+// Layout: marker, version, flags (bit0 keyframe), key_id, present (u16), then
+// [tower_id 18, keyframes only] and each present field in bit order.
+struct TowerTelemetryDeltaMessage : public EspNowMessage {
+	enum Field : uint16_t {
+		AIR_TEMP         = 0x0001,  // int16, 0.01 C
+		HUMIDITY         = 0x0002,  // uint16, 0.01 %
+		LIGHT_LUX        = 0x0004,  // float
+		ACTUATORS        = 0x0008,  // bit0 pump_on, bit1 light_on
+		LIGHT_BRIGHTNESS = 0x0010,  // uint8
+		STATUS_MODE      = 0x0020,  // StatusMode code
+		VBAT             = 0x0040,  // uint16 mV
+		FW               = 0x0080,  // FW_FIELD_LEN bytes
+		UPTIME           = 0x0100,  // uint32 s
+		ALL_FIELDS       = 0x01FF
+	};
+
+	uint8_t key_id;        // keyframe this frame starts (keyframe) or is relative to (delta)
+	bool keyframe;
+	uint16_t present;      // Field bits carried in this frame
+	TowerTelemetryMessage values; // carried fields; the rest are left at their defaults
+
+	TowerTelemetryDeltaMessage();
+	// Fill from 'current': a keyframe when base is null, otherwise the fields that
+	// differ from base at wire precision
+	void capture(const TowerTelemetryMessage& current, const TowerTelemetryMessage* base, uint8_t keyId);
+	// Copy the carried fields onto 'state' (every field plus tower_id for a keyframe)
+	void applyTo(TowerTelemetryMessage& state) const;
+	// Field bits whose wire encodings differ between a and b
+	static uint16_t changedFields(const TowerTelemetryMessage& a, const TowerTelemetryMessage& b);
+
+	String toJson() const override;   // diagnostics only
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
+	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	size_t binarySize() const;
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t HEADER_SIZE = 6;
+	static constexpr size_t MAX_BINARY_SIZE = HEADER_SIZE + WireConstants::ID_FIELD_LEN +
+		2 + 2 + 4 + 1 + 1 + 1 + 2 + WireConstants::FW_FIELD_LEN + 4;  // 57, a full keyframe
+};
+
+// Delta telemetry sync (coordinator -> tower node, compact binary 0x45, 4 bytes).
+// Acknowledges keyframe key_id so the tower may send deltas against it, or asks
+// for a fresh keyframe when the coordinator holds no matching baseline.
+struct TowerTelemetrySyncMessage : public EspNowMessage {
+	uint8_t key_id;          // keyframe being acknowledged
+	bool keyframe_request;   // true: discard the baseline, send a keyframe next
+
+	TowerTelemetrySyncMessage();
+	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
+	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t BINARY_SIZE = 4;
+};
+
+// Batched tower telemetry (tower node -> coordinator, compact binary 0x46 only).
+// The tower samples on its normal schedule and sends up to MAX_SAMPLES readings
+// in one frame. Each sample travels with its age relative to the frame's send
+// time, so the receiver restores the sample times on its own clock.
+//
+// Layout: marker, version, count, tower_id (18), fw (16), then count samples of
+// SAMPLE_SIZE bytes: age_ms u32, air_temp int16 0.01 C, humidity uint16 0.01 %,
+// light_lux float, flags (bit0 pump_on, bit1 light_on), light_brightness,
+// status_mode, vbat_mv u16, uptime_s u32.
+struct TowerTelemetryBatchMessage : public EspNowMessage {
+	struct Sample {
+		uint32_t ts;           // sample time, millis() on the holder's clock
+		float air_temp_c;
+		float humidity_pct;
+		float light_lux;
+		bool pump_on;
+		bool light_on;
+		uint8_t light_brightness;
+		StatusMode status_mode;
+		uint16_t vbat_mv;
+		uint32_t uptime_s;
+	};
+
+	static constexpr size_t HEADER_SIZE = 3 + WireConstants::ID_FIELD_LEN + WireConstants::FW_FIELD_LEN;
+	static constexpr size_t SAMPLE_SIZE = 21;
+	static constexpr uint8_t MAX_SAMPLES = (WireConstants::MAX_PAYLOAD_LEN - HEADER_SIZE) / SAMPLE_SIZE;  // 9
+
+	IdString tower_id;     // shared by every sample
+	FwString fw;
+	uint8_t count;
+	Sample samples[MAX_SAMPLES];
+
+	TowerTelemetryBatchMessage();
+	// Add one reading (tower_id/fw are taken from it). When full, the oldest
+	// sample is dropped and false is returned.
+	bool append(const TowerTelemetryMessage& m);
+	void clear() { count = 0; }
+	bool isFull() const { return count >= MAX_SAMPLES; }
+	// Expand sample i into a full telemetry message carrying the sample's time
+	void sample(uint8_t i, TowerTelemetryMessage& out) const;
+
+	String toJson() const override;   // diagnostics only
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout, ages relative to ts
+	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	size_t binarySize() const { return HEADER_SIZE + count * SAMPLE_SIZE; }
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+};
+
+// Group command (coordinator -> broadcast MAC, compact binary 0x47 only).
+// One frame replaces a set_light per tower. A node applies it when its member
+// index is set in the bitmap; with no bitmap every paired node is a member.
+// group_id names the target for logs (GROUP_ALL, or a zone's group); the
+// bitmap alone decides membership, so nodes keep no group table.
+// Member m applies the light delay_ms + rank(m) * stagger_ms after receipt,
+// rank being its position among the members, and goes dark again hold_ms
+// later when hold_ms is set. That is enough for a sweep across a zone.
+// Broadcasts are not acknowledged at the MAC layer, so the coordinator sends
+// each command more than once; cmd_seq lets nodes apply it only once.
+//
+// Layout: marker, version, cmd_seq, group_id, member_bytes, r, g, b, w, value,
+// fade_ms u16, ttl_ms u16, pixel, flags (bit0 override_status), delay_ms u16,
+// stagger_ms u16, hold_ms u16, then member_bytes of bitmap (bit i of byte
+// i / 8 = member index i).
+struct GroupCommandMessage : public EspNowMessage {
+	uint8_t cmd_seq;
+	uint8_t group_id;
+	uint8_t member_bytes;  // bitmap bytes in use; 0 = every member
+	uint8_t members[GroupConstants::BITMAP_BYTES];
+	uint8_t r, g, b, w;
+	uint8_t value;
+	uint16_t fade_ms;
+	uint16_t ttl_ms;
+	int8_t pixel;
+	bool override_status;
+	uint16_t delay_ms;
+	uint16_t stagger_ms;
+	uint16_t hold_ms;      // 0 = keep the light on
+
+	GroupCommandMessage();
+	// Add a member index to the bitmap; false for NO_MEMBER or out of range
+	bool addMember(uint8_t index);
+	bool isMember(uint8_t index) const;
+	// Position of 'index' among the members (its own index when addressed to all)
+	uint8_t rankOf(uint8_t index) const;
+	// Milliseconds after receipt at which member 'index' applies the light
+	uint32_t applyDelayFor(uint8_t index) const { return delay_ms + (uint32_t)rankOf(index) * stagger_ms; }
+	// The light part as a set_light, for the node's usual apply path
+	void toSetLight(SetLightMessage& out) const;
+
+	String toJson() const override;   // diagnostics only
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
+	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	size_t binarySize() const { return HEADER_SIZE + member_bytes; }
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t HEADER_SIZE = 22;
+	static constexpr size_t MAX_BINARY_SIZE = HEADER_SIZE + GroupConstants::BITMAP_BYTES;  // 54
 };
 
 // Tower command (coordinator -> tower node)
 struct TowerCommandMessage : public EspNowMessage {
-	String tower_id;       // target tower ID
+	IdString tower_id;     // target tower ID
 	
 	// Command type: "set_pump", "set_light", "reboot", "ota"
-	String command;
+	FixedString<16> command;
 	
 	// Pump control (for command = "set_pump")
 	bool pump_on;          // turn pump on/off
@@ -262,14 +677,40 @@ struct TowerCommandMessage : public EspNowMessage {
 
 	TowerCommandMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = JSON_OBJECT_SIZE(9);  // largest command variant
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
+
+	// Compact binary (0x43, 47 bytes). "ota" commands carry a URL and stay JSON.
+	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
+	static constexpr size_t BINARY_SIZE = 47;
 };
 
 // Reservoir telemetry (coordinator internal, for MQTT publishing)
 // This is NOT sent via ESP-NOW, but defined here for consistency
+#define RESERVOIR_TELEMETRY_FIELDS(F) \
+	F(nullptr, coord_id,                "coord_id",                schema::Text,                      "") \
+	F(nullptr, farm_id,                 "farm_id",                 schema::Text,                      "") \
+	F(nullptr, ph,                      "ph",                      schema::JsonNum<float>,            0.0f) \
+	F(nullptr, ec_ms_cm,                "ec_ms_cm",                schema::JsonNum<float>,            0.0f) \
+	F(nullptr, tds_ppm,                 "tds_ppm",                 schema::JsonNum<float>,            0.0f) \
+	F(nullptr, water_temp_c,            "water_temp_c",            schema::JsonNum<float>,            0.0f) \
+	F(nullptr, water_level_pct,         "water_level_pct",         schema::JsonNum<float>,            0.0f) \
+	F(nullptr, water_level_cm,          "water_level_cm",          schema::JsonNum<float>,            0.0f) \
+	F(nullptr, low_water_alert,         "low_water_alert",         schema::JsonNum<bool>,             false) \
+	F(nullptr, main_pump_on,            "main_pump_on",            schema::JsonNum<bool>,             false) \
+	F(nullptr, dosing_pump_ph_on,       "dosing_pump_ph_on",       schema::JsonNum<bool>,             false) \
+	F(nullptr, dosing_pump_nutrient_on, "dosing_pump_nutrient_on", schema::JsonNum<bool>,             false) \
+	F(nullptr, status_mode,             "status_mode",             schema::JsonOnly<schema::Mode>,    StatusMode::OPERATIONAL) \
+	F(nullptr, uptime_s,                "uptime_s",                schema::JsonNum<uint32_t>,         0) \
+	F(nullptr, ts,                      "ts",                      schema::JsonNum<uint32_t>,         millis())
+
 struct ReservoirTelemetryMessage : public EspNowMessage {
-	String coord_id;       // coordinator identifier
-	String farm_id;        // farm identifier
+	SiteIdString coord_id; // coordinator identifier
+	SiteIdString farm_id;  // farm identifier
 	
 	// Water quality sensors
 	float ph;              // pH level (0-14 scale)
@@ -288,12 +729,16 @@ struct ReservoirTelemetryMessage : public EspNowMessage {
 	bool dosing_pump_nutrient_on; // nutrient dosing pump state
 	
 	// System status
-	String status_mode;    // "operational", "maintenance", "error"
+	StatusMode status_mode; // operational, maintenance, error
 	uint32_t uptime_s;     // coordinator uptime in seconds
 
 	ReservoirTelemetryMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override;
+	void fillJson(JsonDocument& doc) const;
+	static constexpr size_t JSON_CAPACITY = SCHEMA_JSON_CAPACITY(RESERVOIR_TELEMETRY_FIELDS);
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 };
 
 // ============================================================================
@@ -329,11 +774,13 @@ struct PairingAdvertisementMessage : public EspNowMessage {
 	
 	PairingAdvertisementMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	// Binary serialization for ESP-NOW efficiency
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 22;
 	
 	// Helper to pack firmware version
@@ -355,10 +802,12 @@ struct PairingOfferMessage : public EspNowMessage {
 	
 	PairingOfferMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 23;
 };
 
@@ -371,10 +820,12 @@ struct PairingAcceptMessage : public EspNowMessage {
 	
 	PairingAcceptMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 13;
 };
 
@@ -388,10 +839,12 @@ struct PairingConfirmMessage : public EspNowMessage {
 	
 	PairingConfirmMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 26;
 	
 	// Config flag helpers
@@ -408,10 +861,12 @@ struct PairingRejectMessage : public EspNowMessage {
 	
 	PairingRejectMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 12;
 };
 
@@ -424,10 +879,12 @@ struct PairingAbortMessage : public EspNowMessage {
 	
 	PairingAbortMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 12;
 };
 
@@ -474,10 +931,12 @@ struct OtaBeginMessage : public EspNowMessage {
 	
 	OtaBeginMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 45;
 };
 
@@ -490,10 +949,12 @@ struct OtaChunkMessage : public EspNowMessage {
 	
 	OtaChunkMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_HEADER_SIZE = 4; // type marker + chunk_index + data_len
 };
 
@@ -506,10 +967,12 @@ struct OtaChunkAckMessage : public EspNowMessage {
 	
 	OtaChunkAckMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 5;
 };
 
@@ -521,10 +984,12 @@ struct OtaAbortMessage : public EspNowMessage {
 	
 	OtaAbortMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 4;
 };
 
@@ -536,10 +1001,12 @@ struct OtaCompleteMessage : public EspNowMessage {
 	
 	OtaCompleteMessage();
 	String toJson() const override;
+	size_t encode(uint8_t* out, size_t cap) const override; // binary layout
 	bool fromJson(const String& json) override;
+	bool fromJsonObject(JsonObjectConst doc) override;
 	
 	size_t toBinary(uint8_t* buffer, size_t maxLen) const;
-	bool fromBinary(const uint8_t* buffer, size_t len);
+	bool fromBinary(const uint8_t* buffer, size_t len) override;
 	static constexpr size_t BINARY_SIZE = 3;
 };
 
@@ -547,14 +1014,85 @@ struct OtaCompleteMessage : public EspNowMessage {
 // MESSAGE FACTORY
 // ============================================================================
 
+class MessageSlot;
+
 class MessageFactory {
 public:
+	// Large enough for any JSON frame that fits in one ESP-NOW packet (250 bytes)
+	static constexpr size_t JSON_DECODE_CAPACITY = 1024;
+
+	// Decode a received frame (JSON or binary) with a single parse. Caller owns the result.
+	static EspNowMessage* decode(const uint8_t* data, size_t len);
+	// Same, but built inside caller-owned storage. The result lives until the slot is
+	// reused or destroyed; never delete it.
+	static EspNowMessage* decode(const uint8_t* data, size_t len, MessageSlot& slot);
 	static EspNowMessage* createMessage(const String& json);
+	// Type-only sniff; prefer decode() when the fields are needed as well
 	static MessageType getMessageType(const String& json);
+	static MessageType typeFromName(const char* name);
+	// Maps a "msg" value to its type without copying it; false for names outside the protocol
+	static bool lookupType(const char* name, size_t len, MessageType& out);
+	// Classifies a raw frame without parsing it: the binary marker, or "msg" scanned from JSON
+	static bool peekMessageType(const uint8_t* data, size_t len, MessageType& out);
+	// JSON documents parsed since boot (diagnostics and benchmarks)
+	static uint32_t jsonParseCount();
 	
 	// V2 Pairing binary message factory
 	static EspNowMessage* createFromBinary(const uint8_t* buffer, size_t len);
 	static MessageType getMessageTypeFromBinary(const uint8_t* buffer, size_t len);
+	// True for compact hot-path frames (markers 0x40-0x48)
+	static bool isCompactBinary(const uint8_t* buffer, size_t len);
+};
+
+// Largest sizeof() in a type list, for sizing MessageSlot at compile time
+template <typename T>
+constexpr size_t maxSizeOf() { return sizeof(T); }
+template <typename T, typename U, typename... Rest>
+constexpr size_t maxSizeOf() {
+	return sizeof(T) > maxSizeOf<U, Rest...>() ? sizeof(T) : maxSizeOf<U, Rest...>();
+}
+
+// --- MessageSlot ---
+// Holds at most one decoded message plus the JSON document it was parsed from.
+// Receive paths keep one and reuse it for every frame, so decoding does not
+// allocate the message object or the document on the heap.
+class MessageSlot {
+public:
+	MessageSlot() : current(nullptr) {}
+	~MessageSlot() { reset(); }
+
+	EspNowMessage* get() const { return current; }
+	void reset() {
+		if (current) current->~EspNowMessage();
+		current = nullptr;
+	}
+	template <typename T>
+	T* emplace() {
+		static_assert(sizeof(T) <= sizeof(storage), "MessageSlot too small for message type");
+		reset();
+		T* m = new (&storage) T();
+		current = m;
+		return m;
+	}
+	JsonDocument& document() { return doc; }
+
+	static constexpr size_t CAPACITY = maxSizeOf<
+		JoinRequestMessage, JoinAcceptMessage, SetLightMessage, NodeStatusMessage,
+		ErrorMessage, AckMessage, TowerJoinRequestMessage, TowerJoinAcceptMessage,
+		TowerTelemetryMessage, TowerCommandMessage, ReservoirTelemetryMessage,
+		TowerTelemetryDeltaMessage, TowerTelemetrySyncMessage, TowerTelemetryBatchMessage,
+		PairingAdvertisementMessage, PairingOfferMessage, PairingAcceptMessage,
+		PairingConfirmMessage, PairingRejectMessage, PairingAbortMessage,
+		OtaBeginMessage, OtaChunkMessage, OtaChunkAckMessage, OtaAbortMessage,
+		OtaCompleteMessage, GroupCommandMessage>();
+
+private:
+	MessageSlot(const MessageSlot&) = delete;
+	MessageSlot& operator=(const MessageSlot&) = delete;
+
+	typename std::aligned_storage<CAPACITY, alignof(std::max_align_t)>::type storage;
+	EspNowMessage* current;
+	StaticJsonDocument<MessageFactory::JSON_DECODE_CAPACITY> doc;
 };
 
 // Helper to convert MAC array to String
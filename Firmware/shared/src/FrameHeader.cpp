@@ -0,0 +1,81 @@
+#include "FrameHeader.h"
+
+uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc) {
+	for (size_t i = 0; i < len; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (uint8_t b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+// --- FrameHeader ---
+size_t FrameHeader::wrap(uint8_t* frame, size_t len, MessageType type, uint16_t seq, uint8_t flags) {
+	if (len > WireConstants::MAX_PAYLOAD_LEN) return 0;
+	frame[0] = MAGIC;
+	frame[1] = VERSION;
+	frame[2] = static_cast<uint8_t>(type);
+	frame[3] = flags;
+	memcpy(&frame[4], &seq, 2);
+	uint16_t crc = crc16(frame, 6);
+	crc = crc16(&frame[SIZE], len, crc);
+	memcpy(&frame[6], &crc, 2);
+	return SIZE + len;
+}
+
+bool FrameHeader::parse(const uint8_t* frame, size_t len, FrameHeader& out) {
+	if (!isFramed(frame, len) || frame[1] != VERSION) return false;
+	uint16_t crc;
+	memcpy(&crc, &frame[6], 2);
+	uint16_t expect = crc16(frame, 6);
+	expect = crc16(&frame[SIZE], len - SIZE, expect);
+	if (crc != expect) return false;
+	out.version = frame[1];
+	out.type = static_cast<MessageType>(frame[2]);
+	out.flags = frame[3];
+	memcpy(&out.seq, &frame[4], 2);
+	out.payload = &frame[SIZE];
+	out.payloadLen = len - SIZE;
+	return true;
+}
+
+// --- SequenceWindow ---
+SequenceWindow::Verdict SequenceWindow::check(uint16_t seq, uint8_t flags) {
+	if (flags & FrameHeader::FLAG_BROADCAST) {
+		received++;
+		return ACCEPT;
+	}
+	uint16_t ahead = (uint16_t)(seq - lastSeq);
+	uint16_t behind = (uint16_t)(lastSeq - seq);
+	if (!valid || (flags & FrameHeader::FLAG_SEQ_RESET)) {
+		// Nothing before the first frame is owed to us
+		valid = true;
+		seen = 0xFFFFFFFFUL;
+	} else if (ahead == 0) {
+		duplicates++;
+		return DUPLICATE;
+	} else if (ahead < 0x8000) {
+		lost += ahead - 1;
+		seen = ahead < REORDER_WINDOW ? (seen << ahead) | 1 : 1;
+	} else if (behind < REORDER_WINDOW) {
+		uint32_t bit = 1UL << behind;
+		if (seen & bit) {
+			// Retransmission, or a late copy of something we already accepted
+			duplicates++;
+			return DUPLICATE;
+		}
+		// Late, not lost: it was counted as a gap when lastSeq moved past it
+		seen |= bit;
+		if (lost) lost--;
+		received++;
+		return ACCEPT;
+	} else {
+		// Further behind than the window means the sender restarted without
+		// the reset flag reaching us; resynchronise rather than drop its traffic
+		seen = 0xFFFFFFFFUL;
+	}
+	lastSeq = seq;
+	received++;
+	return ACCEPT;
+}
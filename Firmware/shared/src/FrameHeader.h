@@ -0,0 +1,89 @@
+#ifndef FRAME_HEADER_H
+#define FRAME_HEADER_H
+
+#include <Arduino.h>
+#include "EspNowMessage.h"
+
+// Fixed 8-byte header in front of every ESP-NOW payload (JSON or compact binary).
+//
+//   0  MAGIC (0xA5)   never '{' and outside every message marker range
+//   1  version        FrameHeader::VERSION
+//   2  type           MessageType of the payload
+//   3  flags          FLAG_*
+//   4  seq            uint16 LE, counted per sender and destination
+//   6  crc16          uint16 LE, CRC-16/CCITT-FALSE over bytes 0..5 and the payload
+//
+// Receivers reject corrupt frames and repeated sequence numbers from these
+// eight bytes, before any JSON or binary decode. Frames that start with '{' or
+// a message marker come from older firmware and are still accepted unchecked.
+struct FrameHeader {
+	static constexpr uint8_t MAGIC = 0xA5;
+	static constexpr uint8_t VERSION = 1;
+	static constexpr size_t SIZE = WireConstants::FRAME_HEADER_LEN;
+
+	static constexpr uint8_t FLAG_BROADCAST = 0x01;  // outside any link's sequence; never deduplicated
+	static constexpr uint8_t FLAG_SEQ_RESET = 0x02;  // sender restarted its sequence (first frame after boot)
+	// Type byte for payloads outside MessageType (health and pairing pings)
+	static constexpr MessageType UNTYPED = static_cast<MessageType>(0xFF);
+
+	uint8_t version;
+	MessageType type;
+	uint8_t flags;
+	uint16_t seq;
+	const uint8_t* payload;  // points into the parsed frame
+	size_t payloadLen;
+
+	// Prefix frame[SIZE..SIZE+len) with a header. The payload must already sit at
+	// frame + SIZE (encode straight there). Returns the total frame length, or 0
+	// if it does not fit in one ESP-NOW frame.
+	static size_t wrap(uint8_t* frame, size_t len, MessageType type, uint16_t seq, uint8_t flags);
+	// wrap() with the sender's next sequence number from 'seq'. Sequence 0 also
+	// carries FLAG_SEQ_RESET, so a rebooted sender is not taken for a duplicate.
+	static size_t wrapNext(uint8_t* frame, size_t len, MessageType type, uint16_t& seq, uint8_t flags = 0) {
+		if (seq == 0) flags |= FLAG_SEQ_RESET;
+		return wrap(frame, len, type, seq++, flags);
+	}
+	// Frame for one destination. Peers seen sending framed traffic get
+	// wrapNext(); to anyone else the payload at frame + SIZE goes out bare, as
+	// firmware from before the header expects, and 'seq' is left alone.
+	// Returns the first byte to send with len set to the bytes to send, or
+	// nullptr if the framed payload does not fit.
+	static const uint8_t* wrapFor(bool peerFramed, uint8_t* frame, size_t& len, MessageType type, uint16_t& seq,
+	                              uint8_t flags = 0) {
+		if (!peerFramed) return len <= WireConstants::MAX_PAYLOAD_LEN ? frame + SIZE : nullptr;
+		len = wrapNext(frame, len, type, seq, flags);
+		return len ? frame : nullptr;
+	}
+	// Check magic, version and CRC and fill 'out'. False means drop the frame.
+	static bool parse(const uint8_t* frame, size_t len, FrameHeader& out);
+	static bool isFramed(const uint8_t* data, size_t len) { return data != nullptr && len >= SIZE && data[0] == MAGIC; }
+};
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+// --- SequenceWindow ---
+// Receive-side sequence state for one sender, an anti-replay window: seen
+// holds one bit per sequence number in the REORDER_WINDOW ending at lastSeq.
+// Forward gaps count as loss; a late frame whose bit is still clear is
+// accepted and taken off the loss count, one whose bit is set is a duplicate.
+struct SequenceWindow {
+	enum Verdict : uint8_t { ACCEPT, DUPLICATE };
+	static constexpr uint16_t REORDER_WINDOW = 32;
+
+	bool valid = false;
+	uint16_t lastSeq = 0;
+	uint32_t seen = 0;        // bit i: lastSeq - i was received
+	uint32_t received = 0;    // frames accepted
+	uint32_t lost = 0;        // sequence numbers skipped
+	uint32_t duplicates = 0;  // frames rejected as repeats
+
+	Verdict check(uint16_t seq, uint8_t flags);
+	// Share of frames the sender sent that never arrived (0..1)
+	float lossRatio() const {
+		uint32_t expected = received + lost;
+		return expected ? (float)lost / expected : 0.0f;
+	}
+};
+
+#endif // FRAME_HEADER_H
@@ -0,0 +1,177 @@
+#ifndef MESSAGE_SCHEMA_H
+#define MESSAGE_SCHEMA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <string.h>
+#include "utils/FixedString.h"
+
+// Field schemas for the protocol messages.
+//
+// A message lists its fields once, as an X-macro in compact wire order
+// (see SET_LIGHT_FIELDS in EspNowMessage.h), one entry per field:
+//
+//   F(parent, member, key, Codec, default)
+//     parent   JSON object holding the key: nullptr for the top level, or the
+//              name of one nested object ("caps", "cfg")
+//     member   member expression on the message (cfg.rx_window_ms works)
+//     key      JSON key
+//     Codec    one of the codecs below; decides the JSON form and the wire form
+//     default  value set by the constructor and when a decoded frame omits it
+//
+// From that list the message gets its exact JSON_CAPACITY and BINARY_SIZE here,
+// and its constructor defaults, JSON and binary codecs from the SCHEMA_* macros
+// in EspNowMessage.cpp. Codecs with WIRE == 0 are JSON-only; their members are
+// reset to the default when a binary frame is decoded.
+//
+// Only messages with a field list are sized here. The rest (pairing, OTA,
+// telemetry delta/sync/batch, group and tower commands) carry arrays or
+// free-form objects and still size their own documents in EspNowMessage.cpp.
+
+namespace schema {
+
+// Copy a string field into a fixed, NUL-padded wire field. Refuses (returns
+// false) rather than truncating so callers can fall back to JSON.
+template <size_t N>
+bool putFixedString(uint8_t* dst, const FixedString<N>& src, size_t width) {
+	if (src.length() > width) return false;
+	memset(dst, 0, width);
+	memcpy(dst, src.c_str(), src.length());
+	return true;
+}
+
+template <size_t N>
+void getFixedString(FixedString<N>& dst, const uint8_t* src, size_t width) {
+	size_t n = 0;
+	while (n < width && src[n] != 0) n++;
+	dst.assign((const char*)src, n);
+}
+
+int16_t toCenti(float v);
+uint16_t toCentiUnsigned(float v);
+
+// The object a field's key lives in; objectFor() creates nested objects on first use
+inline JsonObject objectFor(JsonObject root, const char* parent) {
+	if (parent == nullptr) return root;
+	JsonObject sub = root[parent].as<JsonObject>();
+	return sub.isNull() ? root.createNestedObject(parent) : sub;
+}
+
+inline JsonObjectConst objectIn(JsonObjectConst root, const char* parent) {
+	return parent == nullptr ? root : root[parent].as<JsonObjectConst>();
+}
+
+// --- Codecs ---
+
+// Number stored as W on the wire (uint8_t, uint16_t, int8_t, uint32_t, float...)
+template <typename W>
+struct Num {
+	static constexpr size_t WIRE = sizeof(W);
+	template <typename T, typename D>
+	static void toJson(JsonObject o, const char* k, const T& x, const D&) { o[k] = x; }
+	template <typename T, typename D>
+	static void fromJson(JsonObjectConst o, const char* k, T& x, const D& def) { x = o[k] | static_cast<T>(def); }
+	template <typename T>
+	static bool put(uint8_t* p, const T& x) { W v = static_cast<W>(x); memcpy(p, &v, sizeof(W)); return true; }
+	template <typename T, typename D>
+	static void get(const uint8_t* p, T& x, const D&) { W v; memcpy(&v, p, sizeof(W)); x = static_cast<T>(v); }
+};
+
+// bool as one byte, bit 0
+struct Flag : Num<uint8_t> {
+	static bool put(uint8_t* p, bool x) { p[0] = x ? 0x01 : 0x00; return true; }
+	template <typename D>
+	static void get(const uint8_t* p, bool& x, const D&) { x = (p[0] & 0x01) != 0; }
+};
+
+// bools sharing one flags byte: BitOpen starts the byte, BitClose ends it
+template <uint8_t Mask>
+struct BitOpen : Num<uint8_t> {
+	static constexpr size_t WIRE = 0;
+	static bool put(uint8_t* p, bool x) { p[0] = x ? Mask : 0x00; return true; }
+	template <typename D>
+	static void get(const uint8_t* p, bool& x, const D&) { x = (p[0] & Mask) != 0; }
+};
+
+template <uint8_t Mask>
+struct BitClose : Num<uint8_t> {
+	static bool put(uint8_t* p, bool x) { if (x) p[0] |= Mask; return true; }
+	template <typename D>
+	static void get(const uint8_t* p, bool& x, const D&) { x = (p[0] & Mask) != 0; }
+};
+
+// float as int16 in 0.01 steps (temperatures)
+struct Centi : Num<float> {
+	static constexpr size_t WIRE = 2;
+	static bool put(uint8_t* p, float x) { int16_t v = toCenti(x); memcpy(p, &v, 2); return true; }
+	template <typename D>
+	static void get(const uint8_t* p, float& x, const D&) { int16_t v; memcpy(&v, p, 2); x = v / 100.0f; }
+};
+
+// float as uint16 in 0.01 steps (percentages)
+struct CentiUnsigned : Num<float> {
+	static constexpr size_t WIRE = 2;
+	static bool put(uint8_t* p, float x) { uint16_t v = toCentiUnsigned(x); memcpy(p, &v, 2); return true; }
+	template <typename D>
+	static void get(const uint8_t* p, float& x, const D&) { uint16_t v; memcpy(&v, p, 2); x = v / 100.0f; }
+};
+
+// FixedString as a NUL-padded field of Width bytes; too long refuses the frame
+template <size_t Width>
+struct Str {
+	static constexpr size_t WIRE = Width;
+	template <typename T, typename D>
+	static void toJson(JsonObject o, const char* k, const T& x, const D&) { o[k] = x.c_str(); }
+	template <typename T, typename D>
+	static void fromJson(JsonObjectConst o, const char* k, T& x, const D& def) { x = o[k] | static_cast<const char*>(def); }
+	template <size_t N>
+	static bool put(uint8_t* p, const FixedString<N>& x) { return putFixedString(p, x, Width); }
+	template <size_t N, typename D>
+	static void get(const uint8_t* p, FixedString<N>& x, const D&) { getFixedString(x, p, Width); }
+};
+
+// Any codec's JSON form, with no wire form
+template <typename C>
+struct JsonOnly : C {
+	static constexpr size_t WIRE = 0;
+	template <typename T>
+	static bool put(uint8_t*, const T&) { return true; }
+	template <typename T, typename D>
+	static void get(const uint8_t*, T& x, const D& def) { x = def; }
+};
+
+// JSON-only string (FixedString or String) and number/bool
+typedef JsonOnly<Str<0>> Text;
+template <typename T> using JsonNum = JsonOnly<Num<T>>;
+
+// Left out of the JSON while it holds its default
+template <typename C>
+struct Opt : C {
+	template <typename T, typename D>
+	static void toJson(JsonObject o, const char* k, const T& x, const D& def) {
+		if (!(x == def)) C::toJson(o, k, x, def);
+	}
+};
+
+// --- Sizes ---
+
+constexpr bool isRoot(const char* parent) { return parent == nullptr; }
+
+// Slots for "msg", the top-level fields, and at most one nested object
+constexpr size_t jsonCapacity(size_t rootFields, size_t nestedFields) {
+	return JSON_OBJECT_SIZE(1 + rootFields + (nestedFields ? 1 : 0)) +
+		(nestedFields ? JSON_OBJECT_SIZE(nestedFields) : 0);
+}
+
+} // namespace schema
+
+#define SCHEMA_COUNT_ROOT_F(parent, member, key, Codec, def) + (schema::isRoot(parent) ? 1 : 0)
+#define SCHEMA_COUNT_NESTED_F(parent, member, key, Codec, def) + (schema::isRoot(parent) ? 0 : 1)
+#define SCHEMA_WIRE_SIZE_F(parent, member, key, Codec, def) + Codec::WIRE
+
+// Object slots fillJson() needs; strings are stored by pointer
+#define SCHEMA_JSON_CAPACITY(LIST) schema::jsonCapacity(0 LIST(SCHEMA_COUNT_ROOT_F), 0 LIST(SCHEMA_COUNT_NESTED_F))
+// Compact frame size: marker, FORMAT_VERSION, then every field's wire form
+#define SCHEMA_WIRE_SIZE(LIST) (2 LIST(SCHEMA_WIRE_SIZE_F))
+
+#endif // MESSAGE_SCHEMA_H
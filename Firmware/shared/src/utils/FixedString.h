@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string.h>
+
+/**
+ * Inline, fixed-capacity string for protocol fields (IDs, firmware versions).
+ *
+ * Holds up to N characters plus a terminating NUL in the object itself, so
+ * message structs that use it never touch the heap. Longer input is truncated.
+ * Converts to String where the rest of the code expects one.
+ *
+ * Usage:
+ *   FixedString<18> id;
+ *   id = "AA:BB:CC:DD:EE:FF";
+ *   doc["id"] = id.c_str();
+ */
+template <size_t N>
+class FixedString {
+    static_assert(N > 0 && N < 256, "FixedString length must fit in a byte");
+public:
+    FixedString() : len_(0) { buf_[0] = '\0'; }
+    FixedString(const char* s) { assign(s); }
+    FixedString(const String& s) { assign(s.c_str(), s.length()); }
+
+    FixedString& operator=(const char* s) { assign(s); return *this; }
+    FixedString& operator=(const String& s) { assign(s.c_str(), s.length()); return *this; }
+
+    /** Copy at most N characters of s; returns false if s had to be truncated. */
+    bool assign(const char* s, size_t n) {
+        if (!s) n = 0;
+        bool fits = n <= N;
+        if (!fits) n = N;
+        if (n) memcpy(buf_, s, n);
+        buf_[n] = '\0';
+        len_ = (uint8_t)n;
+        return fits;
+    }
+    bool assign(const char* s) { return assign(s, s ? strlen(s) : 0); }
+
+    void clear() { len_ = 0; buf_[0] = '\0'; }
+
+    const char* c_str() const { return buf_; }
+    size_t length() const { return len_; }
+    bool isEmpty() const { return len_ == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    operator String() const { return String(buf_); }
+
+    bool operator==(const char* s) const { return s ? strcmp(buf_, s) == 0 : len_ == 0; }
+    bool operator==(const String& s) const { return s.length() == len_ && memcmp(buf_, s.c_str(), len_) == 0; }
+    template <size_t M>
+    bool operator==(const FixedString<M>& o) const { return o.length() == len_ && memcmp(buf_, o.c_str(), len_) == 0; }
+    bool operator!=(const char* s) const { return !(*this == s); }
+    bool operator!=(const String& s) const { return !(*this == s); }
+    template <size_t M>
+    bool operator!=(const FixedString<M>& o) const { return !(*this == o); }
+
+private:
+    char buf_[N + 1];
+    uint8_t len_;
+};
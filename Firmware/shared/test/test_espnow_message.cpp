@@ -3,6 +3,7 @@
 #include <unity.h>
 #include <Arduino.h>
 #include "../src/EspNowMessage.h"
+#include "../src/FrameHeader.h"
 
 // ============================================================================
 // JoinRequestMessage Tests
@@ -35,7 +36,7 @@ void test_join_request_deserialization() {
     bool result = msg.fromJson(json);
     
     TEST_ASSERT_TRUE(result);
-    TEST_ASSERT_EQUAL_STRING("join_request", msg.msg.c_str());
+    TEST_ASSERT_EQUAL_STRING("join_request", msg.msg);
     TEST_ASSERT_EQUAL_STRING("11:22:33:44:55:66", msg.mac.c_str());
     TEST_ASSERT_EQUAL_STRING("2.0.0", msg.fw.c_str());
     TEST_ASSERT_TRUE(msg.caps.rgbw);
@@ -99,7 +100,7 @@ void test_join_accept_deserialization() {
     bool result = msg.fromJson(json);
     
     TEST_ASSERT_TRUE(result);
-    TEST_ASSERT_EQUAL_STRING("join_accept", msg.msg.c_str());
+    TEST_ASSERT_EQUAL_STRING("join_accept", msg.msg);
     TEST_ASSERT_EQUAL_STRING("N123", msg.node_id.c_str());
     TEST_ASSERT_EQUAL_STRING("L456", msg.light_id.c_str());
     TEST_ASSERT_EQUAL_STRING("key123", msg.lmk.c_str());
@@ -155,7 +156,7 @@ void test_set_light_deserialization() {
     bool result = msg.fromJson(json);
     
     TEST_ASSERT_TRUE(result);
-    TEST_ASSERT_EQUAL_STRING("set_light", msg.msg.c_str());
+    TEST_ASSERT_EQUAL_STRING("set_light", msg.msg);
     TEST_ASSERT_EQUAL_STRING("c123", msg.cmd_id.c_str());
     TEST_ASSERT_EQUAL_STRING("LABC", msg.light_id.c_str());
     TEST_ASSERT_EQUAL(100, msg.r);
@@ -210,7 +211,7 @@ void test_node_status_serialization() {
     msg.avg_g = 64;
     msg.avg_b = 32;
     msg.avg_w = 255;
-    msg.status_mode = "operational";
+    msg.status_mode = StatusMode::OPERATIONAL;
     msg.vbat_mv = 3700;
     msg.temperature = 25.5f;
     msg.button_pressed = true;
@@ -231,13 +232,13 @@ void test_node_status_deserialization() {
     bool result = msg.fromJson(json);
     
     TEST_ASSERT_TRUE(result);
-    TEST_ASSERT_EQUAL_STRING("node_status", msg.msg.c_str());
+    TEST_ASSERT_EQUAL_STRING("node_status", msg.msg);
     TEST_ASSERT_EQUAL_STRING("N999", msg.node_id.c_str());
     TEST_ASSERT_EQUAL(200, msg.avg_r);
     TEST_ASSERT_EQUAL(100, msg.avg_g);
     TEST_ASSERT_EQUAL(50, msg.avg_b);
     TEST_ASSERT_EQUAL(150, msg.avg_w);
-    TEST_ASSERT_EQUAL_STRING("pairing", msg.status_mode.c_str());
+    TEST_ASSERT_EQUAL(StatusMode::PAIRING, msg.status_mode);
     TEST_ASSERT_EQUAL(4100, msg.vbat_mv);
     TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.25f, msg.temperature);
     TEST_ASSERT_FALSE(msg.button_pressed);
@@ -266,7 +267,7 @@ void test_error_message_deserialization() {
     
     ErrorMessage msg;
     TEST_ASSERT_TRUE(msg.fromJson(json));
-    TEST_ASSERT_EQUAL_STRING("error", msg.msg.c_str());
+    TEST_ASSERT_EQUAL_STRING("error", msg.msg);
     TEST_ASSERT_EQUAL_STRING("N_ERR", msg.node_id.c_str());
     TEST_ASSERT_EQUAL_STRING("OOM", msg.code.c_str());
     TEST_ASSERT_EQUAL_STRING("Out of memory", msg.info.c_str());
@@ -291,7 +292,7 @@ void test_ack_message_deserialization() {
     
     AckMessage msg;
     TEST_ASSERT_TRUE(msg.fromJson(json));
-    TEST_ASSERT_EQUAL_STRING("ack", msg.msg.c_str());
+    TEST_ASSERT_EQUAL_STRING("ack", msg.msg);
     TEST_ASSERT_EQUAL_STRING("xyz789", msg.cmd_id.c_str());
 }
 
@@ -350,12 +351,652 @@ void test_factory_missing_msg_field() {
     }
 }
 
+void test_factory_type_lookup_covers_all_messages() {
+    // Every message's own "msg" name must map back to its type
+    EspNowMessage* all[] = {
+        new JoinRequestMessage(), new JoinAcceptMessage(), new SetLightMessage(),
+        new NodeStatusMessage(), new ErrorMessage(), new AckMessage(),
+        new TowerJoinRequestMessage(), new TowerJoinAcceptMessage(),
+        new TowerTelemetryMessage(), new TowerCommandMessage(), new ReservoirTelemetryMessage(),
+        new TowerTelemetryDeltaMessage(), new TowerTelemetrySyncMessage(), new TowerTelemetryBatchMessage(),
+        new PairingAdvertisementMessage(), new PairingOfferMessage(), new PairingAcceptMessage(),
+        new PairingConfirmMessage(), new PairingRejectMessage(), new PairingAbortMessage(),
+        new OtaBeginMessage(), new OtaChunkMessage(), new OtaChunkAckMessage(),
+        new OtaAbortMessage(), new OtaCompleteMessage(), new GroupCommandMessage()
+    };
+    for (EspNowMessage* m : all) {
+        MessageType t = MessageType::ACK;
+        TEST_ASSERT_TRUE_MESSAGE(MessageFactory::lookupType(m->msg, strlen(m->msg), t), m->msg);
+        TEST_ASSERT_EQUAL(m->type, t);
+        delete m;
+    }
+    
+    MessageType t;
+    TEST_ASSERT_FALSE(MessageFactory::lookupType("ota_completed", 13, t));
+    TEST_ASSERT_FALSE(MessageFactory::lookupType("ack", 2, t));
+    TEST_ASSERT_FALSE(MessageFactory::lookupType("", 0, t));
+    TEST_ASSERT_EQUAL(MessageType::ERROR, MessageFactory::typeFromName("not_a_message"));
+    TEST_ASSERT_EQUAL(MessageType::OTA_COMPLETE, MessageFactory::typeFromName("ota_complete"));
+}
+
+void test_factory_peek_message_type() {
+    MessageType t;
+    const char* json = "{\"msg\":\"set_light\",\"cmd_id\":\"c1\"}";
+    TEST_ASSERT_TRUE(MessageFactory::peekMessageType((const uint8_t*)json, strlen(json), t));
+    TEST_ASSERT_EQUAL(MessageType::SET_LIGHT, t);
+    
+    const char* spaced = "{\"light_id\":\"L1\", \"msg\" : \"ack\"}";
+    TEST_ASSERT_TRUE(MessageFactory::peekMessageType((const uint8_t*)spaced, strlen(spaced), t));
+    TEST_ASSERT_EQUAL(MessageType::ACK, t);
+    
+    const char* unknown = "{\"msg\":\"ping\"}";
+    TEST_ASSERT_FALSE(MessageFactory::peekMessageType((const uint8_t*)unknown, strlen(unknown), t));
+    const char* truncated = "{\"msg\":\"node_sta";
+    TEST_ASSERT_FALSE(MessageFactory::peekMessageType((const uint8_t*)truncated, strlen(truncated), t));
+    
+    uint8_t compact[2] = { 0x42, WireConstants::FORMAT_VERSION };
+    TEST_ASSERT_TRUE(MessageFactory::peekMessageType(compact, sizeof(compact), t));
+    TEST_ASSERT_EQUAL(MessageType::TOWER_TELEMETRY, t);
+}
+
+void test_factory_decode_parses_once() {
+    NodeStatusMessage original;
+    original.node_id = "N123";
+    original.light_id = "L123";
+    original.avg_r = 10;
+    original.status_mode = StatusMode::OPERATIONAL;
+    original.temperature = 21.5f;
+    String json = original.toJson();
+    
+    uint32_t before = MessageFactory::jsonParseCount();
+    EspNowMessage* msg = MessageFactory::decode((const uint8_t*)json.c_str(), json.length() + 1);
+    TEST_ASSERT_EQUAL(1, MessageFactory::jsonParseCount() - before);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::NODE_STATUS, msg->type);
+    NodeStatusMessage* status = static_cast<NodeStatusMessage*>(msg);
+    TEST_ASSERT_EQUAL_STRING("N123", status->node_id.c_str());
+    TEST_ASSERT_EQUAL(10, status->avg_r);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 21.5f, status->temperature);
+    delete msg;
+    
+    // Compact frames never touch the JSON parser
+    uint8_t buf[NodeStatusMessage::BINARY_SIZE];
+    size_t n = original.toBinary(buf, sizeof(buf));
+    before = MessageFactory::jsonParseCount();
+    msg = MessageFactory::decode(buf, n);
+    TEST_ASSERT_EQUAL(0, MessageFactory::jsonParseCount() - before);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::NODE_STATUS, msg->type);
+    delete msg;
+    
+    TEST_ASSERT_NULL(MessageFactory::decode((const uint8_t*)"{broken", 7));
+    TEST_ASSERT_NULL(MessageFactory::decode(nullptr, 0));
+}
+
+void test_factory_decode_into_slot() {
+    MessageSlot slot;
+    SetLightMessage light;
+    light.light_id = "L7";
+    light.value = 42;
+    String json = light.toJson();
+    
+    EspNowMessage* msg = MessageFactory::decode((const uint8_t*)json.c_str(), json.length() + 1, slot);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL_PTR(msg, slot.get());
+    TEST_ASSERT_EQUAL(MessageType::SET_LIGHT, msg->type);
+    TEST_ASSERT_EQUAL_STRING("L7", static_cast<SetLightMessage*>(msg)->light_id.c_str());
+    TEST_ASSERT_EQUAL(42, static_cast<SetLightMessage*>(msg)->value);
+    
+    // Reusing the slot replaces the previous message in place
+    NodeStatusMessage status;
+    status.node_id = "N9";
+    uint8_t buf[NodeStatusMessage::BINARY_SIZE];
+    size_t n = status.toBinary(buf, sizeof(buf));
+    EspNowMessage* next = MessageFactory::decode(buf, n, slot);
+    TEST_ASSERT_NOT_NULL(next);
+    TEST_ASSERT_EQUAL_PTR(msg, next);
+    TEST_ASSERT_EQUAL(MessageType::NODE_STATUS, next->type);
+    
+    // A frame that fails to decode leaves the slot empty
+    TEST_ASSERT_NULL(MessageFactory::decode((const uint8_t*)"{\"msg\":\"set_light\"", 21, slot));
+    TEST_ASSERT_NULL(slot.get());
+    TEST_ASSERT_NULL(MessageFactory::decode(buf, 3, slot));
+    TEST_ASSERT_NULL(slot.get());
+}
+
 // ============================================================================
-// Message Size Tests (ESP-NOW limit is 250 bytes)
+// Compact Binary Codec Tests (markers 0x40-0x48)
+// ============================================================================
+
+void test_set_light_binary_roundtrip() {
+    SetLightMessage original;
+    original.cmd_id = "4294967295-AABBCC";
+    original.light_id = "LDEADBEEF";
+    original.r = 10; original.g = 20; original.b = 30; original.w = 40;
+    original.value = 50;
+    original.fade_ms = 750;
+    original.override_status = true;
+    original.ttl_ms = 9000;
+    original.pixel = 2;
+    
+    uint8_t buf[SetLightMessage::BINARY_SIZE];
+    size_t n = original.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(SetLightMessage::BINARY_SIZE, n);
+    TEST_ASSERT_EQUAL_HEX8(0x40, buf[0]);
+    TEST_ASSERT_EQUAL(WireConstants::FORMAT_VERSION, buf[1]);
+    TEST_ASSERT_TRUE(MessageFactory::isCompactBinary(buf, n));
+    
+    SetLightMessage parsed;
+    TEST_ASSERT_TRUE(parsed.fromBinary(buf, n));
+    TEST_ASSERT_EQUAL_STRING(original.cmd_id.c_str(), parsed.cmd_id.c_str());
+    TEST_ASSERT_EQUAL_STRING(original.light_id.c_str(), parsed.light_id.c_str());
+    TEST_ASSERT_EQUAL(40, parsed.w);
+    TEST_ASSERT_EQUAL(50, parsed.value);
+    TEST_ASSERT_EQUAL(750, parsed.fade_ms);
+    TEST_ASSERT_TRUE(parsed.override_status);
+    TEST_ASSERT_EQUAL(9000, parsed.ttl_ms);
+    TEST_ASSERT_EQUAL(2, parsed.pixel);
+}
+
+void test_node_status_binary_factory() {
+    NodeStatusMessage original;
+    original.node_id = "AA:BB:CC:DD:EE:FF";
+    original.light_id = "LDDEEFF";
+    original.avg_r = 1; original.avg_g = 2; original.avg_b = 3; original.avg_w = 4;
+    original.status_mode = StatusMode::OVERRIDE;
+    original.vbat_mv = 3700;
+    original.temperature = -12.34f;
+    original.button_pressed = true;
+    original.fw = "1.2.3";
+    
+    uint8_t buf[64];
+    size_t n = original.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(NodeStatusMessage::BINARY_SIZE, n);
+    TEST_ASSERT_EQUAL(MessageType::NODE_STATUS, MessageFactory::getMessageTypeFromBinary(buf, n));
+    
+    EspNowMessage* msg = MessageFactory::createFromBinary(buf, n);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::NODE_STATUS, msg->type);
+    NodeStatusMessage* status = static_cast<NodeStatusMessage*>(msg);
+    TEST_ASSERT_EQUAL_STRING("AA:BB:CC:DD:EE:FF", status->node_id.c_str());
+    TEST_ASSERT_EQUAL(StatusMode::OVERRIDE, status->status_mode);
+    TEST_ASSERT_EQUAL(3700, status->vbat_mv);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -12.34f, status->temperature);
+    TEST_ASSERT_TRUE(status->button_pressed);
+    TEST_ASSERT_EQUAL_STRING("1.2.3", status->fw.c_str());
+    delete msg;
+    
+    // status_mode names map to the enum only at the JSON edge; unknown names read as UNSET
+    TEST_ASSERT_EQUAL_STRING("override", statusModeName(StatusMode::OVERRIDE));
+    TEST_ASSERT_EQUAL_STRING("", statusModeName(StatusMode::UNSET));
+    TEST_ASSERT_EQUAL(StatusMode::MAINTENANCE, statusModeFromName("maintenance"));
+    TEST_ASSERT_EQUAL(StatusMode::UNSET, statusModeFromName("custom_mode"));
+    TEST_ASSERT_EQUAL(StatusMode::UNSET, statusModeFromName(nullptr));
+}
+
+void test_tower_telemetry_binary_roundtrip() {
+    TowerTelemetryMessage original;
+    original.tower_id = "T00112233";
+    original.air_temp_c = 24.56f;
+    original.humidity_pct = 61.2f;
+    original.light_lux = 12345.5f;
+    original.pump_on = true;
+    original.light_on = false;
+    original.light_brightness = 200;
+    original.status_mode = StatusMode::IDLE;
+    original.vbat_mv = 5000;
+    original.fw = "2.0.1";
+    original.uptime_s = 86400;
+    
+    uint8_t buf[TowerTelemetryMessage::BINARY_SIZE];
+    size_t n = original.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(TowerTelemetryMessage::BINARY_SIZE, n);
+    TEST_ASSERT_TRUE(n < original.toJson().length() / 3);
+    
+    TowerTelemetryMessage parsed;
+    TEST_ASSERT_TRUE(parsed.fromBinary(buf, n));
+    TEST_ASSERT_EQUAL_STRING("T00112233", parsed.tower_id.c_str());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 24.56f, parsed.air_temp_c);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 61.2f, parsed.humidity_pct);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 12345.5f, parsed.light_lux);
+    TEST_ASSERT_TRUE(parsed.pump_on);
+    TEST_ASSERT_FALSE(parsed.light_on);
+    TEST_ASSERT_EQUAL(200, parsed.light_brightness);
+    TEST_ASSERT_EQUAL(StatusMode::IDLE, parsed.status_mode);
+    TEST_ASSERT_EQUAL(86400, parsed.uptime_s);
+}
+
+void test_tower_command_binary_and_ota_fallback() {
+    TowerCommandMessage cmd;
+    cmd.cmd_id = "c42";
+    cmd.tower_id = "T00112233";
+    cmd.command = "set_pump";
+    cmd.pump_on = true;
+    cmd.pump_duration_s = 120;
+    cmd.ttl_ms = 3000;
+    
+    uint8_t buf[TowerCommandMessage::BINARY_SIZE];
+    size_t n = cmd.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(TowerCommandMessage::BINARY_SIZE, n);
+    
+    TowerCommandMessage parsed;
+    TEST_ASSERT_TRUE(parsed.fromBinary(buf, n));
+    TEST_ASSERT_EQUAL_STRING("set_pump", parsed.command.c_str());
+    TEST_ASSERT_TRUE(parsed.pump_on);
+    TEST_ASSERT_EQUAL(120, parsed.pump_duration_s);
+    TEST_ASSERT_EQUAL(3000, parsed.ttl_ms);
+    
+    // OTA commands carry a URL and must stay on the JSON path
+    cmd.command = "ota";
+    cmd.ota_url = "http://192.168.1.10/fw.bin";
+    TEST_ASSERT_EQUAL(0, cmd.toBinary(buf, sizeof(buf)));
+}
+
+static TowerTelemetryMessage sampleTowerTelemetry() {
+    TowerTelemetryMessage m;
+    m.tower_id = "T00112233";
+    m.air_temp_c = 24.56f;
+    m.humidity_pct = 61.2f;
+    m.light_lux = 830.0f;
+    m.pump_on = true;
+    m.light_on = true;
+    m.light_brightness = 200;
+    m.status_mode = StatusMode::OPERATIONAL;
+    m.vbat_mv = 5000;
+    m.fw = "2.0.1";
+    m.uptime_s = 600;
+    return m;
+}
+
+void test_tower_telemetry_delta_keyframe_and_delta() {
+    TowerTelemetryMessage key = sampleTowerTelemetry();
+    TowerTelemetryDeltaMessage frame;
+    frame.capture(key, nullptr, 7);
+    
+    uint8_t buf[TowerTelemetryDeltaMessage::MAX_BINARY_SIZE];
+    size_t n = frame.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(TowerTelemetryDeltaMessage::MAX_BINARY_SIZE, n);
+    TEST_ASSERT_EQUAL_HEX8(0x44, buf[0]);
+    TEST_ASSERT_TRUE(MessageFactory::isCompactBinary(buf, n));
+    
+    TowerTelemetryDeltaMessage parsed;
+    TEST_ASSERT_TRUE(parsed.fromBinary(buf, n));
+    TEST_ASSERT_TRUE(parsed.keyframe);
+    TEST_ASSERT_EQUAL(7, parsed.key_id);
+    TowerTelemetryMessage state;
+    parsed.applyTo(state);
+    TEST_ASSERT_EQUAL_STRING("T00112233", state.tower_id.c_str());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 24.56f, state.air_temp_c);
+    TEST_ASSERT_TRUE(state.pump_on);
+    TEST_ASSERT_EQUAL_STRING("2.0.1", state.fw.c_str());
+    
+    // Only sensor readings and uptime move between keyframes
+    TowerTelemetryMessage next = key;
+    next.air_temp_c = 24.9f;
+    next.humidity_pct = 61.204f;   // same at wire precision
+    next.uptime_s = 630;
+    frame.capture(next, &key, 7);
+    TEST_ASSERT_FALSE(frame.keyframe);
+    TEST_ASSERT_EQUAL_HEX16(TowerTelemetryDeltaMessage::AIR_TEMP | TowerTelemetryDeltaMessage::UPTIME, frame.present);
+    n = frame.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(TowerTelemetryDeltaMessage::HEADER_SIZE + 2 + 4, n);
+    TEST_ASSERT_TRUE(n * 2 <= TowerTelemetryMessage::BINARY_SIZE);
+    
+    EspNowMessage* msg = MessageFactory::createFromBinary(buf, n);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::TOWER_TELEMETRY_DELTA, msg->type);
+    static_cast<TowerTelemetryDeltaMessage*>(msg)->applyTo(state);
+    delete msg;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 24.9f, state.air_temp_c);
+    TEST_ASSERT_EQUAL(630, state.uptime_s);
+    TEST_ASSERT_EQUAL_STRING("T00112233", state.tower_id.c_str());
+    TEST_ASSERT_EQUAL(200, state.light_brightness);
+}
+
+void test_tower_telemetry_delta_rejects_bad_frames() {
+    TowerTelemetryMessage key = sampleTowerTelemetry();
+    TowerTelemetryDeltaMessage frame;
+    frame.capture(key, nullptr, 1);
+    uint8_t buf[TowerTelemetryDeltaMessage::MAX_BINARY_SIZE];
+    size_t n = frame.toBinary(buf, sizeof(buf));
+    
+    TowerTelemetryDeltaMessage parsed;
+    TEST_ASSERT_FALSE(parsed.fromBinary(buf, n - 1));   // truncated
+    buf[4] = 0x0F;                                      // partial keyframe
+    TEST_ASSERT_FALSE(parsed.fromBinary(buf, n));
+    buf[2] = 0x00; buf[5] = 0x80;                       // unknown field bit
+    TEST_ASSERT_FALSE(parsed.fromBinary(buf, n));
+    
+    // A partial keyframe cannot be a baseline, and field values never travel as JSON
+    frame.present = TowerTelemetryDeltaMessage::AIR_TEMP;
+    TEST_ASSERT_EQUAL(0, frame.toBinary(buf, sizeof(buf)));
+    TEST_ASSERT_FALSE(parsed.fromJson(frame.toJson()));
+}
+
+void test_tower_telemetry_sync_roundtrip() {
+    TowerTelemetrySyncMessage sync;
+    sync.key_id = 42;
+    sync.keyframe_request = true;
+    uint8_t buf[TowerTelemetrySyncMessage::BINARY_SIZE];
+    TEST_ASSERT_EQUAL(TowerTelemetrySyncMessage::BINARY_SIZE, sync.encode(buf, sizeof(buf)));
+    
+    MessageSlot slot;
+    EspNowMessage* msg = MessageFactory::decode(buf, sizeof(buf), slot);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::TOWER_TELEMETRY_SYNC, msg->type);
+    TowerTelemetrySyncMessage* parsed = static_cast<TowerTelemetrySyncMessage*>(msg);
+    TEST_ASSERT_EQUAL(42, parsed->key_id);
+    TEST_ASSERT_TRUE(parsed->keyframe_request);
+}
+
+void test_tower_telemetry_batch_keeps_sample_times() {
+    TowerTelemetryBatchMessage batch;
+    TowerTelemetryMessage m = sampleTowerTelemetry();
+    for (uint8_t i = 0; i < TowerTelemetryBatchMessage::MAX_SAMPLES; i++) {
+        m.ts = 1000 + i * 30000;
+        m.uptime_s = 600 + i * 30;
+        m.pump_on = (i % 2) == 0;
+        TEST_ASSERT_TRUE(batch.append(m));
+    }
+    TEST_ASSERT_TRUE(batch.isFull());
+    const uint8_t full = TowerTelemetryBatchMessage::MAX_SAMPLES;
+    batch.ts = 1000 + full * 30000;   // sent one interval after the last sample
+    
+    uint8_t buf[WireConstants::MAX_FRAME_LEN];
+    size_t n = batch.encode(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(batch.binarySize(), n);
+    TEST_ASSERT_TRUE(n <= WireConstants::MAX_PAYLOAD_LEN);
+    
+    EspNowMessage* msg = MessageFactory::createFromBinary(buf, n);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::TOWER_TELEMETRY_BATCH, msg->type);
+    const TowerTelemetryBatchMessage* parsed = static_cast<TowerTelemetryBatchMessage*>(msg);
+    TEST_ASSERT_EQUAL(TowerTelemetryBatchMessage::MAX_SAMPLES, parsed->count);
+    
+    // Receiver clock differs, but each sample keeps its age relative to the frame
+    TowerTelemetryMessage out;
+    for (uint8_t i = 0; i < parsed->count; i++) {
+        parsed->sample(i, out);
+        TEST_ASSERT_EQUAL_STRING("T00112233", out.tower_id.c_str());
+        TEST_ASSERT_EQUAL_STRING("2.0.1", out.fw.c_str());
+        TEST_ASSERT_EQUAL(parsed->ts - (full - i) * 30000, out.ts);
+        TEST_ASSERT_EQUAL(600 + i * 30, out.uptime_s);
+        TEST_ASSERT_EQUAL((i % 2) == 0, out.pump_on);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 24.56f, out.air_temp_c);
+    }
+    delete msg;
+    
+    // A full batch drops its oldest sample; a truncated frame is refused
+    m.uptime_s = 9999;
+    TEST_ASSERT_FALSE(batch.append(m));
+    TEST_ASSERT_EQUAL(TowerTelemetryBatchMessage::MAX_SAMPLES, batch.count);
+    TEST_ASSERT_EQUAL(630, batch.samples[0].uptime_s);
+    TEST_ASSERT_EQUAL(9999, batch.samples[batch.count - 1].uptime_s);
+    TowerTelemetryBatchMessage truncated;
+    TEST_ASSERT_FALSE(truncated.fromBinary(buf, n - 1));
+}
+
+void test_group_command_members_and_rank() {
+    GroupCommandMessage cmd;
+    cmd.cmd_seq = 7;
+    cmd.group_id = 3;
+    cmd.w = 200;
+    cmd.fade_ms = 60;
+    cmd.override_status = true;
+    cmd.delay_ms = 100;
+    cmd.stagger_ms = 50;
+    cmd.hold_ms = 400;
+    TEST_ASSERT_TRUE(cmd.addMember(2));
+    TEST_ASSERT_TRUE(cmd.addMember(9));
+    TEST_ASSERT_TRUE(cmd.addMember(200));
+    TEST_ASSERT_FALSE(cmd.addMember(GroupConstants::NO_MEMBER));
+    TEST_ASSERT_EQUAL(26, cmd.member_bytes);
+    
+    uint8_t buf[GroupCommandMessage::MAX_BINARY_SIZE];
+    size_t n = cmd.encode(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(GroupCommandMessage::HEADER_SIZE + 26, n);
+    
+    MessageSlot slot;
+    EspNowMessage* msg = MessageFactory::decode(buf, n, slot);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::GROUP_COMMAND, msg->type);
+    const GroupCommandMessage* parsed = static_cast<GroupCommandMessage*>(msg);
+    TEST_ASSERT_EQUAL(7, parsed->cmd_seq);
+    TEST_ASSERT_EQUAL(3, parsed->group_id);
+    TEST_ASSERT_EQUAL(200, parsed->w);
+    TEST_ASSERT_EQUAL(400, parsed->hold_ms);
+    TEST_ASSERT_TRUE(parsed->override_status);
+    
+    // Only members apply it, each one stagger step after the member before
+    TEST_ASSERT_TRUE(parsed->isMember(2));
+    TEST_ASSERT_TRUE(parsed->isMember(200));
+    TEST_ASSERT_FALSE(parsed->isMember(3));
+    TEST_ASSERT_FALSE(parsed->isMember(254));
+    TEST_ASSERT_FALSE(parsed->isMember(GroupConstants::NO_MEMBER));
+    TEST_ASSERT_EQUAL(100, parsed->applyDelayFor(2));
+    TEST_ASSERT_EQUAL(150, parsed->applyDelayFor(9));
+    TEST_ASSERT_EQUAL(200, parsed->applyDelayFor(200));
+    
+    SetLightMessage light;
+    parsed->toSetLight(light);
+    TEST_ASSERT_EQUAL(200, light.w);
+    TEST_ASSERT_EQUAL(60, light.fade_ms);
+    TEST_ASSERT_EQUAL(-1, light.pixel);
+    
+    // No bitmap: the whole fleet, staggered by member index
+    GroupCommandMessage all;
+    all.stagger_ms = 10;
+    TEST_ASSERT_EQUAL(GroupCommandMessage::HEADER_SIZE, all.encode(buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(all.isMember(0));
+    TEST_ASSERT_TRUE(all.isMember(254));
+    TEST_ASSERT_EQUAL(40, all.applyDelayFor(4));
+    
+    // Truncated bitmap, oversized bitmap, and JSON are all refused
+    GroupCommandMessage bad;
+    TEST_ASSERT_FALSE(bad.fromBinary(buf, GroupCommandMessage::HEADER_SIZE - 1));
+    n = cmd.encode(buf, sizeof(buf));
+    TEST_ASSERT_FALSE(bad.fromBinary(buf, n - 1));
+    buf[4] = GroupConstants::BITMAP_BYTES + 1;
+    TEST_ASSERT_FALSE(bad.fromBinary(buf, sizeof(buf)));
+    TEST_ASSERT_FALSE(bad.fromJson(cmd.toJson()));
+}
+
+void test_ack_compact_and_cumulative() {
+    AckMessage ack;
+    ack.cmd_id = "telemetry_ack";
+    ack.ack_seq = 0xBEEF;
+    ack.ack_count = 5;
+    uint8_t buf[AckMessage::BINARY_SIZE];
+    TEST_ASSERT_EQUAL(AckMessage::BINARY_SIZE, ack.toBinary(buf, sizeof(buf)));
+    
+    MessageSlot slot;
+    EspNowMessage* msg = MessageFactory::decode(buf, sizeof(buf), slot);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(MessageType::ACK, msg->type);
+    const AckMessage* parsed = static_cast<AckMessage*>(msg);
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, parsed->ack_seq);
+    TEST_ASSERT_EQUAL(5, parsed->ack_count);
+    
+    // JSON keeps its old shape unless the cumulative fields are set
+    AckMessage plain;
+    plain.cmd_id = "telemetry_ack";
+    String json = plain.toJson();
+    TEST_ASSERT_EQUAL_STRING("{\"msg\":\"ack\",\"cmd_id\":\"telemetry_ack\"}", json.c_str());
+    AckMessage fromJson;
+    TEST_ASSERT_TRUE(fromJson.fromJson(ack.toJson()));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, fromJson.ack_seq);
+    TEST_ASSERT_EQUAL(5, fromJson.ack_count);
+}
+
+void test_join_accept_member_index_is_optional() {
+    JoinAcceptMessage accept;
+    TEST_ASSERT_EQUAL(GroupConstants::NO_MEMBER, accept.member_index);
+    TEST_ASSERT_TRUE(accept.toJson().indexOf("\"member\"") < 0);
+    accept.member_index = 12;
+    JoinAcceptMessage parsed;
+    TEST_ASSERT_TRUE(parsed.fromJson(accept.toJson()));
+    TEST_ASSERT_EQUAL(12, parsed.member_index);
+}
+
+void test_binary_rejects_bad_frames() {
+    SetLightMessage msg;
+    uint8_t buf[SetLightMessage::BINARY_SIZE];
+    size_t n = msg.toBinary(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(SetLightMessage::BINARY_SIZE, n);
+    
+    SetLightMessage parsed;
+    TEST_ASSERT_FALSE(parsed.fromBinary(buf, n - 1));   // truncated
+    buf[1] = WireConstants::FORMAT_VERSION + 1;          // unknown layout version
+    TEST_ASSERT_FALSE(parsed.fromBinary(buf, n));
+    
+    // JSON frames are never mistaken for compact ones
+    const char* json = "{\"msg\":\"set_light\"}";
+    TEST_ASSERT_FALSE(MessageFactory::isCompactBinary((const uint8_t*)json, strlen(json)));
+    
+    // IDs are capped at the wire field width when assigned
+    TEST_ASSERT_FALSE(msg.light_id.assign("L0123456789ABCDEFGHIJ"));
+    TEST_ASSERT_EQUAL(WireConstants::ID_FIELD_LEN, msg.light_id.length());
+    // cmd_ids that fit the struct but not the compact field are refused rather than truncated
+    msg.cmd_id = "tower_telemetry_ack_1";
+    TEST_ASSERT_EQUAL(0, msg.toBinary(buf, sizeof(buf)));
+}
+
+// ============================================================================
+// FrameHeader / SequenceWindow Tests
+// ============================================================================
+
+void test_frame_header_wrap_and_parse() {
+    SetLightMessage m;
+    m.cmd_id = "c-7";
+    m.w = 200;
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    size_t n = m.encode(frame + FrameHeader::SIZE, WireConstants::MAX_PAYLOAD_LEN);
+    TEST_ASSERT_TRUE(n > 0);
+    uint16_t seq = 0;
+    size_t total = FrameHeader::wrapNext(frame, n, m.type, seq);
+    TEST_ASSERT_EQUAL(FrameHeader::SIZE + n, total);
+    TEST_ASSERT_EQUAL(1, seq);
+    
+    FrameHeader hdr;
+    TEST_ASSERT_TRUE(FrameHeader::parse(frame, total, hdr));
+    TEST_ASSERT_EQUAL(MessageType::SET_LIGHT, hdr.type);
+    TEST_ASSERT_EQUAL(0, hdr.seq);
+    TEST_ASSERT_TRUE(hdr.flags & FrameHeader::FLAG_SEQ_RESET);
+    TEST_ASSERT_EQUAL(n, hdr.payloadLen);
+    TEST_ASSERT_EQUAL_PTR(frame + FrameHeader::SIZE, hdr.payload);
+    
+    // Legacy frames are not framed; any flipped bit or truncation fails the CRC
+    TEST_ASSERT_FALSE(FrameHeader::isFramed(hdr.payload, hdr.payloadLen));
+    frame[FrameHeader::SIZE + 3] ^= 0x10;
+    TEST_ASSERT_FALSE(FrameHeader::parse(frame, total, hdr));
+    frame[FrameHeader::SIZE + 3] ^= 0x10;
+    TEST_ASSERT_FALSE(FrameHeader::parse(frame, total - 1, hdr));
+    frame[4] ^= 0x01;
+    TEST_ASSERT_FALSE(FrameHeader::parse(frame, total, hdr));
+    TEST_ASSERT_FALSE(FrameHeader::parse(frame, FrameHeader::SIZE - 1, hdr));
+    
+    // Payloads that leave no room for the header are refused
+    TEST_ASSERT_EQUAL(0, FrameHeader::wrap(frame, WireConstants::MAX_PAYLOAD_LEN + 1, m.type, 1, 0));
+    // CRC-16/CCITT-FALSE check value
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16((const uint8_t*)"123456789", 9));
+}
+
+void test_frame_header_only_for_framed_peers() {
+    AckMessage ack;
+    ack.cmd_id = "telemetry_ack";
+    ack.ack_seq = 9;
+    uint8_t frame[WireConstants::MAX_FRAME_LEN];
+    size_t n = ack.encode(frame + FrameHeader::SIZE, WireConstants::MAX_PAYLOAD_LEN);
+    TEST_ASSERT_TRUE(n > 0);
+    
+    // A peer that never sent a framed frame runs older firmware: bare JSON, no sequence used
+    uint16_t seq = 0;
+    size_t len = n;
+    const uint8_t* out = FrameHeader::wrapFor(false, frame, len, ack.type, seq);
+    TEST_ASSERT_EQUAL_PTR(frame + FrameHeader::SIZE, out);
+    TEST_ASSERT_EQUAL(n, len);
+    TEST_ASSERT_EQUAL(0, seq);
+    TEST_ASSERT_FALSE(FrameHeader::isFramed(out, len));
+    TEST_ASSERT_EQUAL('{', out[0]);
+    MessageSlot slot;
+    EspNowMessage* decoded = MessageFactory::decode(out, len, slot);
+    TEST_ASSERT_NOT_NULL(decoded);
+    TEST_ASSERT_EQUAL(MessageType::ACK, decoded->type);
+    
+    // Once it has framed its own traffic it gets the header
+    out = FrameHeader::wrapFor(true, frame, len, ack.type, seq);
+    TEST_ASSERT_EQUAL_PTR(frame, out);
+    TEST_ASSERT_EQUAL(FrameHeader::SIZE + n, len);
+    TEST_ASSERT_EQUAL(1, seq);
+    FrameHeader hdr;
+    TEST_ASSERT_TRUE(FrameHeader::parse(out, len, hdr));
+    TEST_ASSERT_EQUAL(n, hdr.payloadLen);
+    
+    size_t tooLong = WireConstants::MAX_PAYLOAD_LEN + 1;
+    TEST_ASSERT_NULL(FrameHeader::wrapFor(true, frame, tooLong, ack.type, seq));
+}
+
+void test_sequence_window_duplicates_and_loss() {
+    SequenceWindow w;
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, w.check(100, 0));   // first frame syncs
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, w.check(101, 0));
+    TEST_ASSERT_EQUAL(SequenceWindow::DUPLICATE, w.check(101, 0)); // retransmission
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, w.check(105, 0));   // 102..104 lost
+    TEST_ASSERT_EQUAL(3, w.lost);
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, w.check(103, 0));   // late, not lost after all
+    TEST_ASSERT_EQUAL(2, w.lost);
+    TEST_ASSERT_EQUAL(105, w.lastSeq);
+    TEST_ASSERT_EQUAL(SequenceWindow::DUPLICATE, w.check(103, 0)); // its copy is a repeat
+    TEST_ASSERT_EQUAL(SequenceWindow::DUPLICATE, w.check(100, 0));
+    TEST_ASSERT_EQUAL(3, w.duplicates);
+    TEST_ASSERT_EQUAL(4, w.received);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0f / 6.0f, w.lossRatio());
+    
+    // Broadcasts sit outside the link's sequence
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, w.check(105, FrameHeader::FLAG_BROADCAST));
+    TEST_ASSERT_EQUAL(105, w.lastSeq);
+    
+    // A rebooted sender starts again at 0 with the reset flag
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, w.check(0, FrameHeader::FLAG_SEQ_RESET));
+    TEST_ASSERT_EQUAL(2, w.lost);
+
+    // Reordered frames are all accepted once, and a gap filled late is no loss
+    SequenceWindow r;
+    r.check(200, 0);
+    // Nothing before the first frame was counted lost, so nothing there is taken
+    TEST_ASSERT_EQUAL(SequenceWindow::DUPLICATE, r.check(199, 0));
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, r.check(203, 0));
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, r.check(202, 0));
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, r.check(201, 0));
+    TEST_ASSERT_EQUAL(SequenceWindow::DUPLICATE, r.check(201, 0));
+    TEST_ASSERT_EQUAL(0, r.lost);
+    // A jump past the whole window still lets the skipped frames in late
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, r.check(253, 0));
+    TEST_ASSERT_EQUAL(49, r.lost);
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, r.check(230, 0));
+    TEST_ASSERT_EQUAL(48, r.lost);
+    TEST_ASSERT_EQUAL(SequenceWindow::DUPLICATE, r.check(253, 0));
+    TEST_ASSERT_EQUAL(4 + 2, r.received);
+    
+    // Sequence numbers wrap without counting loss or duplicates
+    SequenceWindow wrap;
+    wrap.check(65535, 0);
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, wrap.check(0, 0));
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, wrap.check(1, 0));
+    TEST_ASSERT_EQUAL(0, wrap.lost);
+    TEST_ASSERT_EQUAL(0, wrap.duplicates);
+    
+    // Far behind the window means a restart we missed the flag for
+    TEST_ASSERT_EQUAL(SequenceWindow::ACCEPT, wrap.check(40000, 0));
+    TEST_ASSERT_EQUAL(40000, wrap.lastSeq);
+}
+
+// ============================================================================
+// Message Size Tests (ESP-NOW limit is 250 bytes, less the frame header)
 // ============================================================================
 
 void test_message_sizes_within_limit() {
-    const size_t ESP_NOW_MAX_SIZE = 250;
+    const size_t ESP_NOW_MAX_SIZE = WireConstants::MAX_PAYLOAD_LEN;
     
     // Test worst-case message sizes
     JoinRequestMessage joinReq;
@@ -385,7 +1026,7 @@ void test_message_sizes_within_limit() {
     nodeStatus.node_id = "node_0123456789";
     nodeStatus.light_id = "L0123456789";
     nodeStatus.avg_r = 255; nodeStatus.avg_g = 255; nodeStatus.avg_b = 255; nodeStatus.avg_w = 255;
-    nodeStatus.status_mode = "operational";
+    nodeStatus.status_mode = StatusMode::OPERATIONAL;
     nodeStatus.vbat_mv = 65535;
     nodeStatus.temperature = 125.99f;
     nodeStatus.button_pressed = true;
@@ -394,6 +1035,101 @@ void test_message_sizes_within_limit() {
     TEST_ASSERT_LESS_OR_EQUAL(ESP_NOW_MAX_SIZE, nodeStatus.toJson().length());
 }
 
+// ============================================================================
+// encode() into caller buffers
+// ============================================================================
+
+static void assertEncodeMatchesJson(const EspNowMessage& m) {
+    // Reservoir telemetry is MQTT-only and can exceed one ESP-NOW frame
+    uint8_t frame[2 * WireConstants::MAX_FRAME_LEN];
+    String json = m.toJson();
+    size_t n = m.encode(frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_MESSAGE(json.length(), n, m.msg);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(json.c_str(), frame, n, m.msg);
+}
+
+void test_encode_matches_to_json() {
+    // Every optional field set, so an undersized JSON_CAPACITY shows up as encode() == 0
+    JoinRequestMessage joinReq;
+    joinReq.mac = "AA:BB:CC:DD:EE:FF";
+    joinReq.fw = "2.1.0";
+    joinReq.token = "8f3a91c2";
+    assertEncodeMatchesJson(joinReq);
+
+    JoinAcceptMessage joinAccept;
+    joinAccept.node_id = "N0A1B2C";
+    joinAccept.light_id = "L0A1B2C";
+    joinAccept.lmk = "00112233445566778899AABBCCDDEEFF";
+    joinAccept.wire_format = WireConstants::FORMAT_VERSION;
+    assertEncodeMatchesJson(joinAccept);
+
+    SetLightMessage setLight;
+    setLight.cmd_id = "123456-0A1B2C";
+    setLight.light_id = "L0A1B2C";
+    setLight.reason = "presence";
+    assertEncodeMatchesJson(setLight);
+
+    NodeStatusMessage status;
+    status.node_id = "N0A1B2C";
+    status.status_mode = StatusMode::OVERRIDE;
+    status.fw = "2.1.0";
+    assertEncodeMatchesJson(status);
+
+    ErrorMessage error;
+    error.node_id = "N0A1B2C";
+    error.code = "E_TEMP";
+    error.info = "sensor timeout";
+    assertEncodeMatchesJson(error);
+
+    AckMessage ack;
+    ack.cmd_id = "tower_telemetry_ack";
+    assertEncodeMatchesJson(ack);
+
+    TowerJoinRequestMessage towerJoin;
+    towerJoin.mac = "AA:BB:CC:DD:EE:FF";
+    towerJoin.fw = "1.0.3";
+    towerJoin.token = "8f3a91c2";
+    assertEncodeMatchesJson(towerJoin);
+
+    TowerJoinAcceptMessage towerAccept;
+    towerAccept.tower_id = "T0A1B2C";
+    towerAccept.coord_id = "coord-01";
+    towerAccept.farm_id = "farm001";
+    towerAccept.wire_format = WireConstants::FORMAT_VERSION;
+    assertEncodeMatchesJson(towerAccept);
+
+    TowerTelemetryMessage telemetry;
+    telemetry.tower_id = "T0A1B2C";
+    telemetry.fw = "1.0.3";
+    assertEncodeMatchesJson(telemetry);
+
+    TowerCommandMessage command;
+    command.cmd_id = "c-77";
+    command.tower_id = "T0A1B2C";
+    command.command = "set_light";
+    assertEncodeMatchesJson(command);
+    command.command = "ota";
+    command.ota_url = "http://192.168.4.1/fw.bin";
+    command.ota_checksum = "d41d8cd98f00b204e9800998ecf8427e";
+    assertEncodeMatchesJson(command);
+
+    ReservoirTelemetryMessage reservoir;
+    reservoir.coord_id = "coord-01";
+    reservoir.farm_id = "farm001";
+    assertEncodeMatchesJson(reservoir);
+
+    // Binary-only messages encode their binary layout
+    OtaChunkAckMessage chunkAck;
+    uint8_t a[WireConstants::MAX_FRAME_LEN], b[WireConstants::MAX_FRAME_LEN];
+    size_t n = chunkAck.toBinary(a, sizeof(a));
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_EQUAL(n, chunkAck.encode(b, sizeof(b)));
+    TEST_ASSERT_EQUAL_MEMORY(a, b, n);
+
+    // A frame that does not fit is refused, not truncated
+    TEST_ASSERT_EQUAL(0, telemetry.encode(a, 16));
+}
+
 // ============================================================================
 // Test Runner
 // ============================================================================
@@ -437,9 +1173,33 @@ void setup() {
     RUN_TEST(test_factory_create_set_light);
     RUN_TEST(test_factory_invalid_json);
     RUN_TEST(test_factory_missing_msg_field);
+    RUN_TEST(test_factory_type_lookup_covers_all_messages);
+    RUN_TEST(test_factory_peek_message_type);
+    RUN_TEST(test_factory_decode_parses_once);
+    RUN_TEST(test_factory_decode_into_slot);
+    
+    // Compact binary codec tests
+    RUN_TEST(test_set_light_binary_roundtrip);
+    RUN_TEST(test_node_status_binary_factory);
+    RUN_TEST(test_tower_telemetry_binary_roundtrip);
+    RUN_TEST(test_tower_command_binary_and_ota_fallback);
+    RUN_TEST(test_tower_telemetry_delta_keyframe_and_delta);
+    RUN_TEST(test_tower_telemetry_delta_rejects_bad_frames);
+    RUN_TEST(test_tower_telemetry_sync_roundtrip);
+    RUN_TEST(test_tower_telemetry_batch_keeps_sample_times);
+    RUN_TEST(test_group_command_members_and_rank);
+    RUN_TEST(test_join_accept_member_index_is_optional);
+    RUN_TEST(test_ack_compact_and_cumulative);
+    RUN_TEST(test_binary_rejects_bad_frames);
+    
+    // Frame header tests
+    RUN_TEST(test_frame_header_wrap_and_parse);
+    RUN_TEST(test_frame_header_only_for_framed_peers);
+    RUN_TEST(test_sequence_window_duplicates_and_loss);
     
     // Size constraint tests
     RUN_TEST(test_message_sizes_within_limit);
+    RUN_TEST(test_encode_matches_to_json);
     
     UNITY_END();
 }